@@ -4,7 +4,34 @@
 #include <Arduino.h>
 #include "AudioTools.h"
 
-extern AudioPlayer player;
+// Decoding runs in its own task on core 1, above loop(). It refills the
+// A2DP buffer to the high watermark whenever the fill drops below the low
+// one, so a slow loop() handler no longer starves playback.
+#define DECODE_TASK_PRIORITY 5
+#define DECODE_TASK_STACK 8192
+#define DECODE_LOW_WATERMARK (64 * 1024)    // Refill below this many bytes
+#define DECODE_HIGH_WATERMARK (104 * 1024)  // Stop here; leaves room for a copy
+#define DECODE_IDLE_MS 50                   // Re-check state while not woken
+
+// Open and pre-decode the next track while the current one is finishing,
+// then splice its PCM on without resetting the buffer (0: stop and reopen
+// between tracks)
+#define AUDIO_GAPLESS 1
+#define GAPLESS_PREPARE_BYTES (64 * 1024)   // MP3 bytes left when the next track is queued
+#define GAPLESS_PREPARE_FRAMES (4 * 44100)  // Or PCM frames left before the crossfade starts
+
+// Playback counters since boot. Written by the decode task and the A2DP
+// callback; compare two readings for rates.
+struct AudioStats {
+    uint32_t underruns;      // Callbacks that got less audio than requested
+    uint32_t overruns;       // Copies that filled the buffer and had to wait
+    uint32_t copies;         // Decode calls
+    uint32_t decodeMicros;   // Time spent decoding (wraps)
+    uint32_t maxDecodeMicros;
+    uint32_t minFill;        // Lowest buffer fill seen while refilling
+};
+
+AudioStats getAudioStats();
 
 void initAudio();
 void audioLoop();
@@ -14,6 +41,7 @@ void pausePlayback();
 void resumePlayback();
 void stopPlayback();
 void playCurrentSong(bool updateDisplay);
+void setPlaybackVolume(int percent);
 void reconnectBluetooth();
 void disconnectBluetooth();
 void changeBluetoothDevice(const String& new_device_name);
@@ -0,0 +1,35 @@
+#ifndef BUTTON_PRESS_H
+#define BUTTON_PRESS_H
+
+#include <stdint.h>
+
+// Press validation for one button, fed with the edges the ISR timestamped.
+// A press counts once the line has been held down for minHoldMs (measured
+// from the edges, so a press released before loop() gets to it still
+// counts) and not within debounceMs of the previous press. Accepted
+// presses are counted, not latched, so several presses between two polls
+// are all handled. Plain data with no Arduino dependency, so edge traces
+// can be replayed off-device.
+struct ButtonPress {
+  uint32_t minHoldMs;
+  uint32_t debounceMs;
+  uint32_t downMs;       // When the current press went down
+  uint32_t lastPressMs;  // When the last accepted press went down
+  bool down;
+  bool accepted;         // Current press already counted
+  uint8_t pending;       // Accepted presses not yet taken
+};
+
+void buttonPressReset(ButtonPress& button, uint32_t minHoldMs, uint32_t debounceMs);
+
+// Feed one edge. Returns true when a release ends a press too short to
+// count (a glitch on the line).
+bool buttonPressEdge(ButtonPress& button, bool down, uint32_t timeMs);
+
+// Accept a press that is still held and has been down long enough
+void buttonPressPoll(ButtonPress& button, uint32_t nowMs);
+
+// Take one accepted press; false when none are waiting
+bool buttonPressTake(ButtonPress& button);
+
+#endif
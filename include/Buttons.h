@@ -5,5 +5,6 @@
 
 void initButtons();
 void pollButtons();
+void queueButtonEdge(int index, bool down, uint32_t timeMs);  // From processInputEvents()
 
 #endif
\ No newline at end of file
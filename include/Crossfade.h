@@ -0,0 +1,76 @@
+#ifndef CROSSFADE_H
+#define CROSSFADE_H
+
+#include <Arduino.h>
+
+#define CROSSFADE_MAX_SECONDS 10
+#define CROSSFADE_SAMPLE_RATE 44100
+
+// PCM staged per side while the two tracks are decoded in turn (PSRAM)
+#define CROSSFADE_STAGE_BYTES (64 * 1024)
+
+// Quarter sine in Q15, interpolated between entries
+#define CROSSFADE_TABLE_SIZE 256
+
+enum CrossfadeSide { CROSSFADE_OUT = 0, CROSSFADE_IN = 1 };
+
+// Equal-power crossfade from the end of one track into the start of the
+// next. Each track writes 16-bit stereo PCM into its side; pump() mixes
+// the frames both sides have in Q15 and writes them on. A side that has
+// ended counts as silence.
+class Crossfader {
+public:
+    Crossfader();
+    ~Crossfader();
+
+    // Stage buffers and gain table; false if PSRAM is short
+    bool begin();
+
+    // Fade over `frames` stereo frames, mixing into `out`. Each side is
+    // scaled by its track's loudness gain (Q15, up to 2x) on top of the
+    // fade, so both play at their own level while `out` stays at unity.
+    void start(Print& out, uint32_t frames, int32_t outGain, int32_t inGain);
+    void finish();   // Flush both stages and stop
+    void reset();    // Stop, discarding anything staged
+    bool active() const { return output != NULL; }
+
+    Print& side(CrossfadeSide which) { return sides[which]; }
+
+    // Side to decode next: the live one with less staged
+    CrossfadeSide next() const;
+    void end(CrossfadeSide which) { sides[which].ended = true; }
+
+    // Mix what can be mixed; call after each decode
+    void pump();
+
+    // Outgoing track has ended and all of it has been mixed
+    bool outgoingDone() const {
+        return sides[CROSSFADE_OUT].ended && sides[CROSSFADE_OUT].count == 0;
+    }
+
+    // Frames dropped because a stage was full
+    uint32_t dropped() const { return droppedFrames; }
+
+private:
+    struct Side : public Print {
+        int16_t* frames;     // Interleaved L/R
+        uint32_t count;      // Staged frames
+        uint32_t dropped;
+        bool ended;
+
+        size_t write(uint8_t b) override;
+        size_t write(const uint8_t* data, size_t len) override;
+    };
+
+    Side sides[2];
+    Print* output;
+    uint32_t phase;          // 16.16 position in the gain table
+    uint32_t step;
+    int32_t trackGains[2];   // Per side, Q15
+    uint32_t droppedFrames;
+
+    int32_t gain(uint32_t at) const;
+    void mix(uint32_t frames);
+};
+
+#endif
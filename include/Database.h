@@ -7,25 +7,34 @@
 #include <string>
 #include "State.h"
 
-struct Artist {
-    int id;
-    std::string name;
+// Statements prepared once per open database and reused by every query
+// Paged queries come in PageDirection order (AT_OFFSET, AFTER, BEFORE)
+enum QueryId {
+    QUERY_ARTISTS_AT,
+    QUERY_ARTISTS_AFTER,
+    QUERY_ARTISTS_BEFORE,
+    QUERY_ALBUMS_AT,
+    QUERY_ALBUMS_AFTER,
+    QUERY_ALBUMS_BEFORE,
+    QUERY_SONGS_AT,
+    QUERY_SONGS_AFTER,
+    QUERY_SONGS_BEFORE,
+    QUERY_ALBUM_COUNT_BY_ARTIST,
+    QUERY_SONG_COUNT_BY_ALBUM,
+    QUERY_SONG_COUNT,
+    QUERY_ARTIST_COUNT,
+    QUERY_ALBUM_COUNT,
+    QUERY_SEARCH,
+    QUERY_LOCATE,
+    QUERY_ARTIST_JUMPS,
+    QUERY_COUNT
 };
 
-struct Album {
-    int id;
-    int artistId;
-    std::string name;
-    int year;
-};
-
-struct SongDB {
-    int id;
-    int albumId;
-    std::string title;
-    std::string path;
-    int trackNumber;
-    int duration;
+// Per-query timing counters (bind + step + row building)
+struct QueryStats {
+    uint32_t calls;
+    uint32_t totalMicros;
+    uint32_t maxMicros;
 };
 
 class MusicDatabase {
@@ -33,23 +42,57 @@ public:
     MusicDatabase();
     ~MusicDatabase();
     
-    bool open(const char* path);
-    bool openFromMemory(const char* sdPath);  // NEW
+    bool open(const char* path, LoadProgressCallback progress = NULL);
+    bool openFromMemory(const char* sdPath, LoadProgressCallback progress = NULL);
+    bool openFromSd(const char* sdPath);  // Pages in on demand (SdVfs.h)
     void close();
     
-    // Query methods
-    std::vector<std::string> getArtistNames();
-    std::vector<std::string> getAlbumNamesByArtist(const std::string& artistName);
-    std::vector<Song> getSongsByAlbum(const std::string& artistName, const std::string& albumName);
+    // Paged query methods: append up to `limit` rows to `out` in list
+    // order and return how many were added. PAGE_AFTER/PAGE_BEFORE use
+    // `anchor` as the keyset, PAGE_AT_OFFSET uses `offset`. Row strings
+    // are copied into `strings`.
+    int fetchArtists(PageDirection dir, const Artist* anchor, int offset, int limit,
+                     StringArena& strings, std::vector<Artist>& out);
+    int fetchAlbums(int artistId, PageDirection dir, const Album* anchor, int offset, int limit,
+                    StringArena& strings, std::vector<Album>& out);
+    int fetchSongs(int albumId, PageDirection dir, const Song* anchor, int offset, int limit,
+                   StringArena& strings, std::vector<Song>& out);
+    
+    // Items with a word starting with `prefix` (case-insensitive), best
+    // matches first: earlier word, then artists, albums, songs
+    int search(const char* prefix, int limit, StringArena& strings, std::vector<SearchResult>& out);
+    
+    // List positions of a search result in the artist/album/song lists
+    bool locate(const SearchResult& result, SearchLocation& where);
+    
+    // Letter jump table for the artist list, in list order
+    int fetchArtistJumps(std::vector<LetterJump>& out);
     
     // Stats
+    int getAlbumCountByArtist(int artistId);
+    int getSongCountByAlbum(int albumId);
     int getSongCount();
     int getArtistCount();
     int getAlbumCount();
     
+    // Query timing
+    const QueryStats& getQueryStats(QueryId id) const;
+    void resetQueryStats();
+    void printQueryStats();
+    
 private:
     sqlite3* db;
     bool isOpen;
+    bool pagedFromSd;
+    SemaphoreHandle_t queryMutex;  // Cached statements are shared between tasks
+    sqlite3_stmt* statements[QUERY_COUNT];
+    QueryStats stats[QUERY_COUNT];
+    
+    bool prepareStatements();
+    void finalizeStatements();
+    sqlite3_stmt* beginQuery(QueryId id, unsigned long& startMicros);
+    void endQuery(QueryId id, unsigned long startMicros);
+    int runCountQuery(QueryId id, int parentId = -1);
 };
 
 extern MusicDatabase musicDB;
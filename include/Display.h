@@ -5,6 +5,8 @@
 #include <Adafruit_ST7789.h>
 #include <SPI.h>
 #include "State.h"
+#include "FrameBuffer.h"
+#include "UiSnapshot.h"
 
 // Display dimensions
 #define SCREEN_WIDTH 240
@@ -31,15 +33,47 @@
 #define COLOR_ACCENT   0x051F  // Dark Blue
 #define COLOR_HEADER   0xFFFF  // White
 
-extern Adafruit_ST7789 display;
-extern volatile bool displayNeedsUpdate;
+// Draw into a PSRAM frame and flush dirty bands (0: draw straight to the panel)
+#define DISPLAY_USE_FRAMEBUFFER 1
+
+// Address window setup: CASET + 4, RASET + 4, RAMWR
+#define ST7789_WINDOW_BYTES 11
+
+// ST7789 that counts the bytes each frame pushes over SPI. Every GFX
+// primitive opens an address window sized to the pixels it writes.
+class CountingST7789 : public Adafruit_ST7789 {
+public:
+  CountingST7789(SPIClass* spi, int8_t cs, int8_t dc, int8_t rst)
+    : Adafruit_ST7789(spi, cs, dc, rst), bytes(0) {}
+  
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) override {
+    bytes += ST7789_WINDOW_BYTES + (uint32_t)w * h * 2;
+    Adafruit_ST7789::setAddrWindow(x, y, w, h);
+  }
+  
+  uint32_t bytesSent() const { return bytes; }
+  void resetBytes() { bytes = 0; }
+  
+private:
+  uint32_t bytes;
+};
+
+extern CountingST7789 panel;
+extern FrameBuffer display;  // All drawing goes through here
 extern SemaphoreHandle_t displayMutex;
 
 void initDisplay();
 void drawCenteredText(const char* text, int y, uint8_t textSize = 1);
 void drawMenuItem(const char* text, int y, bool selected = false, bool disabled = false);
 void drawUI();
-void updateDisplay();
+void wakeDisplayTask(uint32_t dirty);
+void updateDisplay(const UiSnapshot& s, uint32_t dirty);
 void setScreenBrightness(int brightness);
 
+#ifdef DEBUG
+// Display task wakeups per second by cause, notify/request-to-flush
+// latency and SPI bytes per frame since the last call
+void printDisplayStats();
+#endif
+
 #endif
\ No newline at end of file
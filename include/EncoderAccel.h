@@ -0,0 +1,39 @@
+#ifndef ENCODER_ACCEL_H
+#define ENCODER_ACCEL_H
+
+#include <stdint.h>
+
+// Rotation speed (detents per second) below which every detent moves one
+// row, and the speed at which a detent moves ENCODER_ACCEL_MAX_STEP rows
+#define ENCODER_ACCEL_SLOW_RATE 8.0f
+#define ENCODER_ACCEL_FAST_RATE 40.0f
+#define ENCODER_ACCEL_MAX_STEP 10
+
+// A gap this long starts a fresh spin at unit speed
+#define ENCODER_ACCEL_IDLE_MS 250
+
+// Smoothed speed that counts as a fast spin, for modes a spin switches on
+#define ENCODER_ACCEL_SPIN_RATE 20.0f
+
+// Smoothed rotation speed. Plain data with no Arduino dependency, so the
+// curve can be replayed against recorded tick timestamps off-device.
+struct EncoderAccel {
+  uint32_t lastMs;
+  float rate;        // Detents per second, smoothed
+  bool moving;
+  uint32_t spinStartMs;  // When the rate last rose to ENCODER_ACCEL_SPIN_RATE
+  bool spinning;
+};
+
+void encoderAccelReset(EncoderAccel& accel);
+
+// Feed `detents` (> 0) that arrived by `nowMs`; returns how many list
+// steps they are worth. Never less than `detents`. Calling again with the
+// same `nowMs` (a batch applied in parts) reuses the current speed.
+int encoderAccelSteps(EncoderAccel& accel, uint32_t nowMs, int detents);
+
+// How long the speed has stayed at or above ENCODER_ACCEL_SPIN_RATE, as of
+// the last detents fed in; 0 when it is below
+uint32_t encoderAccelSpinMs(const EncoderAccel& accel);
+
+#endif
@@ -1,8 +1,11 @@
 #ifndef ENCODER_MODULE_H
 #define ENCODER_MODULE_H
 
+#include <stdint.h>
+
 void initEncoder();
 void updateEncoder();
 bool isEncoderScrolling();
+void queueEncoderDetents(int detents, uint32_t timeMs);  // From processInputEvents()
 
 #endif
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef FRAME_BUFFER_H
+#define FRAME_BUFFER_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include <Adafruit_SPITFT.h>
+
+// Rows per flush band; each band is sent as one address window
+#define FB_BAND_HEIGHT 16
+
+// Built-in 5x7 font cell, including the spacing column and descender row
+#define FB_GLYPH_WIDTH 6
+#define FB_GLYPH_HEIGHT 8
+
+// Off-screen RGB565 frame in PSRAM. Drawing only touches memory and marks
+// the rows it changed; flush() then sends each dirty band to the panel as
+// one bulk transfer from an internal DMA-capable line buffer.
+//
+// Text in the built-in font is blitted from a glyph atlas built in
+// begin(), one span per lit run, instead of a rectangle per scaled pixel.
+//
+// Without begin() (or if the allocation fails) every primitive goes
+// straight to the panel, as before.
+class FrameBuffer : public Adafruit_GFX {
+public:
+  FrameBuffer(Adafruit_SPITFT& panel, int16_t w, int16_t h);
+  ~FrameBuffer();
+
+  bool begin();
+  bool active() const { return pixels != NULL; }
+
+  // Send dirty bands to the panel; returns how many were sent
+  int flush();
+
+  // Width of `text` in the built-in font at `size`, without drawing
+  static int16_t textWidth(const char* text, uint8_t size) {
+    return strlen(text) * FB_GLYPH_WIDTH * size;
+  }
+
+  // Copy a w-wide window of a 1-bit mask (Adafruit bitmap layout, `stride`
+  // bytes per row) to (x, y) in fg/bg. The window starts at column srcX
+  // and wraps around after maskWidth columns.
+  void drawMaskWindow(int16_t x, int16_t y, int16_t w, int16_t h,
+                      const uint8_t* mask, int16_t stride, int16_t maskWidth, int16_t srcX,
+                      uint16_t fg, uint16_t bg);
+
+  // Text output (Print); glyphs go through the atlas when possible
+  using Adafruit_GFX::write;
+  size_t write(uint8_t c) override;
+
+  // Adafruit_GFX primitives
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+
+  void startWrite() override;
+  void endWrite() override;
+  void writePixel(int16_t x, int16_t y, uint16_t color) override;
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+
+  uint16_t* buffer() const { return pixels; }
+
+private:
+  struct Band {
+    int16_t x0;   // Dirty columns [x0, x1], x0 > x1 when clean
+    int16_t x1;
+  };
+
+  Adafruit_SPITFT& panel;
+  uint16_t* pixels;
+  uint16_t* lineBuffer;
+  Band* bands;
+  int bandCount;
+
+  bool clip(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const;
+  void blitGlyph(int16_t x, int16_t y, uint8_t c, uint8_t sx, uint8_t sy, uint16_t fg, uint16_t bg);
+  void fill(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef GAIN_STAGE_H
+#define GAIN_STAGE_H
+
+#include <Arduino.h>
+
+// Q15 unity; gains run up to 2x (GAIN_MAX) so a boost still fits 32 bits
+#define GAIN_UNITY 32768
+#define GAIN_MAX 65536
+
+// Volume 1..100% maps linearly in dB onto -VOLUME_RANGE_DB..0 dB; 0% mutes
+#define VOLUME_RANGE_DB 50
+
+// Frames over which a gain change is spread (~23 ms at 44.1 kHz). The ramp
+// runs in Q15 << GAIN_RAMP_SHIFT, so the per-frame step is exact.
+#define GAIN_RAMP_SHIFT 10
+#define GAIN_RAMP_FRAMES (1 << GAIN_RAMP_SHIFT)
+
+// PCM frames processed per block on the stack
+#define GAIN_BLOCK_FRAMES 256
+
+// Fixed-point volume for 16-bit stereo PCM on its way to `out`. A new
+// volume is reached by a per-frame linear ramp, so steps from the encoder
+// don't click; setVolume() may be called from any task. The track's
+// loudness gain is folded into the same multiply and changes with no ramp
+// at the next frame written, so set it between writes (under playerMutex,
+// like the writes) right where one track's PCM ends and the next begins.
+class GainStage : public Print {
+public:
+    explicit GainStage(Print& out);
+
+    void setVolume(int percent);
+    void setTrackGain(int32_t gain);   // Q15, up to GAIN_MAX
+    int32_t gain() const { return ((uint32_t)(current >> GAIN_RAMP_SHIFT) * (uint32_t)trackGain) >> 15; }
+
+    size_t write(uint8_t b) override;
+    size_t write(const uint8_t* data, size_t len) override;
+
+private:
+    Print& output;
+    volatile int32_t target;   // Q15 volume, written by the control side
+    int32_t trackGain;         // Q15 loudness gain, audio side only
+    int32_t current;           // Q15 volume << GAIN_RAMP_SHIFT, audio side only
+    int32_t step;              // Per-frame ramp increment, same scale
+    int32_t rampTarget;        // Volume the current ramp heads for
+    uint32_t rampFrames;       // Frames left in the ramp
+};
+
+// Q15 gain for a volume percentage on the dB curve
+int32_t volumeToGain(int percent);
+
+// Q15 gain for hundredths of a dB (ReplayGain), at most GAIN_MAX
+int32_t decibelsToGain(int centiDb);
+
+// Scale `count` stereo frames in place by `gain` (Q15), saturating. Each
+// word holds one frame, left sample in the low half.
+void applyGain(uint32_t* frames, uint32_t count, int32_t gain);
+
+#ifdef DEBUG
+// Time the Q15 kernel against a float multiply and log samples/us
+void benchmarkGain();
+#endif
+
+#endif
@@ -6,10 +6,29 @@
 
 extern SdFat32 sd;
 
+// Background library load (started from setup, polled by the UI)
+enum LibraryState {
+  LIBRARY_IDLE,
+  LIBRARY_LOADING,
+  LIBRARY_READY,
+  LIBRARY_FAILED
+};
+
+extern volatile LibraryState libraryState;
+extern volatile int libraryLoadPercent;  // 0-100 while LIBRARY_LOADING
+
+bool startLibraryLoad();
+inline bool libraryReady() { return libraryState == LIBRARY_READY; }
+
 // New database-based functions
-bool loadDatabase();
+bool loadDatabase(LoadProgressCallback progress = NULL);
 bool buildArtistList();
-bool buildAlbumList(const std::string &artist);
-bool buildSongList(const std::string &artist, const std::string &album);
+bool buildAlbumList(const Artist &artist);
+bool buildSongList(const Album &album);
+
+// Search needs the SQLite index; the library image has none
+bool librarySearchAvailable();
+int searchLibrary(const char* prefix, int limit, StringArena& strings, std::vector<SearchResult>& out);
+bool locateSearchResult(const SearchResult& result, SearchLocation& where);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include <Arduino.h>
+#include "SpscRing.h"
+
+// Encoder detents and button edges, timestamped in the ISRs and
+// handled in order by loop(). Input is never dropped because the UI
+// is busy; it just waits in the queue.
+enum InputEventType : uint8_t {
+  INPUT_ENCODER,   // value: detents moved (signed)
+  INPUT_BUTTON,    // value: button index (see Buttons.cpp), pressed
+  INPUT_BUTTON_UP  // value: button index, released
+};
+
+struct InputEvent {
+  uint32_t timeMs;
+  InputEventType type;
+  int8_t value;
+};
+
+#define INPUT_QUEUE_SIZE 64
+
+// All GPIO ISRs are dispatched one at a time on the core that attached
+// them, so together they are a single producer
+extern SpscRing<InputEvent, INPUT_QUEUE_SIZE> inputQueue;
+
+void postInputEvent(InputEventType type, int value);  // ISR only
+
+// Drain the queue into the encoder and button handlers (loop() only)
+void processInputEvents();
+
+#endif
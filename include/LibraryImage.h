@@ -0,0 +1,111 @@
+#ifndef LIBRARY_IMAGE_H
+#define LIBRARY_IMAGE_H
+
+#include <Arduino.h>
+#include <vector>
+#include "State.h"
+
+#define LIBRARY_IMAGE_PATH "music.lib"
+#define LIBRARY_IMAGE_VERSION 4
+
+// On-card layout written by `music_indexer.py --image` (little endian,
+// every table 4-byte aligned, records stored in the player's list order).
+// Record ids handed out to the UI are table indexes, so an artist's albums
+// and an album's songs are contiguous ranges.
+struct LibraryImageHeader {
+    char magic[4];            // "RLIB"
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t artistCount;
+    uint32_t albumCount;
+    uint32_t songCount;
+    uint32_t artistTable;     // Byte offsets from the start of the image
+    uint32_t albumTable;
+    uint32_t songTable;
+    uint32_t stringPool;
+    uint32_t stringPoolSize;
+    uint32_t jumpTable;
+    uint32_t jumpCount;
+};
+
+struct ArtistRecord {
+    uint32_t name;            // String pool offsets
+    uint32_t displayName;
+    uint32_t firstAlbum;
+    uint32_t albumCount;
+};
+
+struct AlbumRecord {
+    uint32_t name;
+    uint32_t displayName;
+    uint32_t artist;
+    uint32_t firstSong;
+    uint16_t songCount;
+    uint16_t year;
+};
+
+struct SongRecord {
+    uint32_t title;
+    uint32_t displayName;
+    uint32_t path;
+    uint32_t album;
+    uint16_t track;
+    int16_t trackGain;        // ReplayGain, hundredths of a dB
+    uint32_t duration;
+    int16_t albumGain;
+    uint16_t reserved;
+};
+
+struct JumpRecord {
+    uint32_t row;             // First artist row filed under `letter`
+    uint8_t letter;
+    uint8_t reserved[3];
+};
+
+// Read-only library served straight from the loaded image buffer - no SQL
+// engine, listing is pointer arithmetic over the record tables. Same paged
+// query interface as MusicDatabase so PageSource can use either; rows
+// point straight into the string pool, so `strings` is never used.
+class LibraryImage {
+public:
+    LibraryImage();
+    ~LibraryImage();
+
+    bool load(const char* sdPath, LoadProgressCallback progress = NULL);
+    void close();
+    bool isLoaded() const { return data != nullptr; }
+
+    int fetchArtists(PageDirection dir, const Artist* anchor, int offset, int limit,
+                     StringArena& strings, std::vector<Artist>& out) const;
+    int fetchAlbums(int artistId, PageDirection dir, const Album* anchor, int offset, int limit,
+                    StringArena& strings, std::vector<Album>& out) const;
+    int fetchSongs(int albumId, PageDirection dir, const Song* anchor, int offset, int limit,
+                   StringArena& strings, std::vector<Song>& out) const;
+
+    int fetchArtistJumps(std::vector<LetterJump>& out) const;
+
+    // Stats
+    int getAlbumCountByArtist(int artistId) const;
+    int getSongCountByAlbum(int albumId) const;
+    int getSongCount() const;
+    int getArtistCount() const;
+    int getAlbumCount() const;
+
+private:
+    uint8_t* data;
+    size_t size;
+    const LibraryImageHeader* header;
+    const ArtistRecord* artistTable;
+    const AlbumRecord* albumTable;
+    const SongRecord* songTable;
+    const JumpRecord* jumpTable;
+    const char* strings;
+
+    bool validate();
+    bool validateRecords() const;
+    const char* str(uint32_t offset) const;
+};
+
+extern LibraryImage libraryImage;
+
+#endif
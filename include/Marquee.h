@@ -0,0 +1,49 @@
+#ifndef MARQUEE_H
+#define MARQUEE_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include "FrameBuffer.h"
+
+#define MARQUEE_FRAME_MS 40     // Display task wake period while scrolling
+#define MARQUEE_STEP 2          // Pixels per frame (50 px/s)
+#define MARQUEE_PAUSE_MS 1200   // Hold at the start of each pass
+#define MARQUEE_GAP_CHARS 4     // Blank cells between repeats
+#define MARQUEE_TEXT_MAX 128
+#define MARQUEE_TEXT_SIZE 2
+
+// Text too wide for its box, scrolled sideways. The text is rasterised
+// once into a 1-bit strip; each frame copies a shifted window of the
+// strip into the framebuffer.
+class Marquee {
+public:
+  Marquee();
+  ~Marquee();
+
+  // Show `text` in the w-wide box at (x, y) and draw the current window.
+  // Restarts from the left when the text or box changes. Returns false,
+  // drawing nothing, if the text fits or there is no framebuffer.
+  bool show(const char* text, int16_t x, int16_t y, int16_t w, uint16_t fg, uint16_t bg);
+  void stop() { running = false; }
+  bool active() const { return running; }
+
+  // Advance by one frame and draw; call every MARQUEE_FRAME_MS
+  void tick(uint32_t nowMs);
+
+private:
+  GFXcanvas1* strip;
+  int16_t stripWidth;
+  char text[MARQUEE_TEXT_MAX];
+  int16_t x;
+  int16_t y;
+  int16_t width;
+  uint16_t fg;
+  uint16_t bg;
+  int16_t offset;
+  uint32_t pauseUntil;
+  bool running;
+
+  void draw();
+};
+
+#endif
@@ -1,6 +1,23 @@
 #ifndef NAVIGATION_H
 #define NAVIGATION_H
 
+#include <string>
+#include "State.h"
+
+// A track picked ahead for the gapless handoff: where it sits in the
+// lists and its row ids, so the splice can move there later
+struct QueuedSong {
+  int artistIndex;
+  int albumIndex;
+  int songIndex;
+  int artistId;
+  int albumId;
+  int songId;
+  std::string path;
+  std::string title;
+  ReplayGain gain;
+};
+
 void handleButtonPress(int buttonIndex);
 void handleCenter();
 void handleTop();         // NEW - Menu/Back
@@ -8,6 +25,9 @@ void handleBottom();      // NEW - Play/Pause
 void handleLeft();        // NEW - Previous track
 void handleRight();       // NEW - Next track
 void autoNext();
+bool selectNextSong();    // Advance the list indices only
+bool peekNextSong(QueuedSong& next);
+bool selectQueuedSong(const QueuedSong& next);  // Move the list indices to it
 void autoPrevious();      // NEW - Go to previous track
 
 #endif
\ No newline at end of file
@@ -0,0 +1,203 @@
+#ifndef PAGED_LIST_H
+#define PAGED_LIST_H
+
+#include <Arduino.h>
+#include <vector>
+#include "StringArena.h"
+
+// Rows fetched per query, and the most rows a list keeps resident
+#define PAGE_SIZE 16
+#define PAGE_WINDOW_ROWS (PAGE_SIZE * 3)
+
+// PSRAM for each of a list's two string arenas
+#define PAGE_ARENA_BYTES (16 * 1024)
+
+enum PageDirection {
+  PAGE_AT_OFFSET,  // Rows starting at an absolute list position
+  PAGE_AFTER,      // Rows strictly after the anchor row (keyset)
+  PAGE_BEFORE      // Rows strictly before the anchor row (keyset)
+};
+
+// Row source for a paged list. Specialised per row type in State.h,
+// implemented on top of MusicDatabase in Indexer.cpp.
+//   count(parentId)  -> total rows in the list
+//   fetch(...)       -> appends up to `limit` rows to `out` in list order,
+//                       copying their strings into `strings` if needed
+template <typename T> struct PageSource;
+
+// A library list that only keeps a sliding window of rows in memory.
+// Rows around the requested index are fetched on demand: neighbouring
+// pages use keyset pagination from the window edges, jumps re-center
+// the window with an offset query.
+//
+// Row strings live in one of two PSRAM arenas. Rows dropped from the
+// window leave dead strings behind, so when the active arena fills the
+// live window is copied into the other one and they swap; nothing is
+// freed row by row, which keeps the internal heap unfragmented.
+template <typename T>
+class PagedList {
+public:
+  PagedList() : parentId(-1), total(0), windowStart(0), active(0), lock(NULL) {}
+
+  // Point the list at a new parent (-1 for top-level lists), drop the
+  // cached window and return the new row count
+  int reset(int parent) {
+    if (lock == NULL) {
+      lock = xSemaphoreCreateMutex();
+      arenas[0].begin(PAGE_ARENA_BYTES);
+      arenas[1].begin(PAGE_ARENA_BYTES);
+      rows.reserve(PAGE_WINDOW_ROWS + PAGE_SIZE);
+      page.reserve(PAGE_SIZE * 2);
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    parentId = parent;
+    rows.clear();
+    windowStart = 0;
+    arenas[0].reset();
+    arenas[1].reset();
+    active = 0;
+    total = PageSource<T>::count(parent);
+    xSemaphoreGive(lock);
+
+    return total;
+  }
+
+  void clear() {
+    if (lock == NULL) {
+      rows.clear();
+      total = 0;
+      return;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    rows.clear();
+    windowStart = 0;
+    total = 0;
+    arenas[0].reset();
+    arenas[1].reset();
+    xSemaphoreGive(lock);
+  }
+
+  int size() const { return total; }
+  bool empty() const { return total == 0; }
+  int parent() const { return parentId; }
+
+  // Copy of the row at `index` (default row if out of range)
+  T operator[](int index) {
+    T row;
+    get(index, row);
+    return row;
+  }
+
+  bool get(int index, T& out) {
+    if (lock == NULL || index < 0 || index >= total) {
+      return false;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    bool found = ensureLoaded(index);
+    if (found) {
+      out = rows[index - windowStart];
+    }
+    xSemaphoreGive(lock);
+
+    return found;
+  }
+
+private:
+  int parentId;
+  int total;
+  int windowStart;
+  std::vector<T> rows;
+  std::vector<T> page;       // Scratch for one fetch, reused
+  StringArena arenas[2];
+  int active;                // Arena new rows are copied into
+  SemaphoreHandle_t lock;
+
+  // Fetch into `page`. If the arena ran out, move the live window into the
+  // spare arena and fetch again so the page gets the freed space.
+  void fetchPage(PageDirection dir, const T* anchor, int offset, int limit) {
+    page.clear();
+    PageSource<T>::fetch(parentId, dir, anchor, offset, limit, arenas[active], page);
+
+    if (arenas[active].full()) {
+      T anchorRow;
+      if (anchor) anchorRow = *anchor;
+
+      compact();
+      if (anchor) anchorRow.relocate(arenas[1 - active], arenas[active]);
+
+      page.clear();
+      PageSource<T>::fetch(parentId, dir, anchor ? &anchorRow : NULL, offset, limit,
+                           arenas[active], page);
+
+      if (arenas[active].full()) {
+        Serial.println("⚠️ Page strings exceed list arena, names truncated");
+      }
+    }
+  }
+
+  void compact() {
+    StringArena& from = arenas[active];
+    StringArena& to = arenas[1 - active];
+
+    to.reset();
+    for (size_t i = 0; i < rows.size(); i++) {
+      rows[i].relocate(from, to);
+    }
+    active = 1 - active;
+  }
+
+  bool inWindow(int index) const {
+    return index >= windowStart && index < windowStart + (int)rows.size();
+  }
+
+  bool ensureLoaded(int index) {
+    if (inWindow(index)) {
+      return true;
+    }
+
+    int windowEnd = windowStart + (int)rows.size();
+
+    if (!rows.empty() && index >= windowEnd && index < windowEnd + PAGE_SIZE) {
+      // Scrolled just past the bottom: next page after the last row
+      fetchPage(PAGE_AFTER, &rows.back(), 0, PAGE_SIZE);
+      rows.insert(rows.end(), page.begin(), page.end());
+
+      if ((int)rows.size() > PAGE_WINDOW_ROWS) {
+        int drop = rows.size() - PAGE_WINDOW_ROWS;
+        rows.erase(rows.begin(), rows.begin() + drop);
+        windowStart += drop;
+      }
+    } else if (!rows.empty() && index < windowStart && index >= windowStart - PAGE_SIZE) {
+      // Scrolled just above the top: previous page before the first row
+      fetchPage(PAGE_BEFORE, &rows.front(), 0, PAGE_SIZE);
+      rows.insert(rows.begin(), page.begin(), page.end());
+      windowStart -= (int)page.size();
+
+      if ((int)rows.size() > PAGE_WINDOW_ROWS) {
+        rows.resize(PAGE_WINDOW_ROWS);
+      }
+    }
+
+    if (!inWindow(index)) {
+      // Jump (or keyset page came back short): re-center on the index
+      int start = index - PAGE_SIZE;
+      if (start < 0) start = 0;
+
+      // Old window is dropped; start the other arena so copies of its
+      // rows handed out earlier stay readable until the next switch
+      rows.clear();
+      active = 1 - active;
+      arenas[active].reset();
+      fetchPage(PAGE_AT_OFFSET, NULL, start, PAGE_SIZE * 2);
+      rows.insert(rows.end(), page.begin(), page.end());
+      windowStart = start;
+    }
+
+    return inWindow(index);
+  }
+};
+
+#endif
@@ -25,6 +25,14 @@ public:
     void saveBrightness(int brightness);
     int loadBrightness();
     
+    // Crossfade length in seconds (0 = off)
+    void saveCrossfade(int seconds);
+    int loadCrossfade();
+    
+    // ReplayGainMode (State.h)
+    void saveReplayGainMode(int mode);
+    int loadReplayGainMode();
+    
 private:
     nvs_handle_t nvsHandle;
     bool isOpen;
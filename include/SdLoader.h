@@ -0,0 +1,31 @@
+#ifndef SD_LOADER_H
+#define SD_LOADER_H
+
+#include <Arduino.h>
+#include "State.h"
+
+// Bytes requested per read while loading a file into PSRAM. Larger chunks
+// mean fewer SD commands; must be a multiple of the 512-byte sector size.
+#ifndef SD_LOAD_CHUNK_SIZE
+#define SD_LOAD_CHUNK_SIZE (64 * 1024)
+#endif
+
+// SPI clock for the card; raise on boards whose wiring allows it
+#ifndef SD_CLOCK_MHZ
+#define SD_CLOCK_MHZ 25
+#endif
+
+// PSRAM left free after a load
+#define SD_LOAD_PSRAM_RESERVE 100000
+
+// Serialises card access between tasks (audio playback, paged database
+// reads). Created in setup() before the card is mounted.
+extern SemaphoreHandle_t sdMutex;
+
+// Read a whole SD file into a new ps_malloc buffer (caller frees).
+// Contiguous files are read with raw multi-sector card reads straight into
+// the buffer; fragmented files fall back to large File32 reads.
+uint8_t* loadFileToPsram(const char* sdPath, size_t& fileSize,
+                         LoadProgressCallback progress = NULL);
+
+#endif
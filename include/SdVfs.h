@@ -0,0 +1,38 @@
+#ifndef SD_VFS_H
+#define SD_VFS_H
+
+#include <stdint.h>
+
+// Read-only SQLite VFS that pages the database in from the SD card on
+// demand instead of copying the whole file into PSRAM first. Pages are
+// kept in a bounded LRU cache in PSRAM.
+//
+// On the device files come from SdFat (`sd`); host builds (no ARDUINO
+// define) use stdio so the VFS can be exercised against a plain file.
+
+#define SD_VFS_NAME "sdfat"
+
+// Cache geometry: SD_VFS_CACHE_PAGES blocks of SD_VFS_PAGE_SIZE bytes
+#ifndef SD_VFS_PAGE_SIZE
+#define SD_VFS_PAGE_SIZE 4096
+#endif
+#ifndef SD_VFS_CACHE_PAGES
+#define SD_VFS_CACHE_PAGES 256  // 1 MB
+#endif
+
+struct SdVfsStats {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t readMicros;  // Time spent reading the card on misses
+};
+
+// Register the VFS with SQLite (idempotent). Open databases with
+// sqlite3_open_v2(path, &db, SQLITE_OPEN_READONLY, SD_VFS_NAME).
+bool sdVfsRegister();
+
+const SdVfsStats& sdVfsGetStats();
+void sdVfsResetStats();
+void sdVfsPrintStats();
+
+#endif
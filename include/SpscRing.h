@@ -0,0 +1,61 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+// Lock-free single-producer/single-consumer ring. push() may run in an
+// ISR while pop() runs in a task: each index has one writer, and the
+// release/acquire pair publishes a slot before the other side sees it.
+// N must be a power of two; one slot is kept free to tell full from empty.
+template <typename T, size_t N>
+class SpscRing {
+public:
+  SpscRing() : head(0), tail(0), overflows(0) {}
+
+  // Producer side. Returns false (and counts it) when full.
+  bool push(const T& item) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t next = (h + 1) & (N - 1);
+
+    if (next == tail.load(std::memory_order_acquire)) {
+      overflows++;
+      return false;
+    }
+
+    slots[h] = item;
+    head.store(next, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side
+  bool pop(T& item) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+
+    if (t == head.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    item = slots[t];
+    tail.store((t + 1) & (N - 1), std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const {
+    return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+  }
+
+  // Items rejected because the ring was full (written by the producer)
+  uint32_t dropped() const { return overflows; }
+
+private:
+  static_assert((N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+  T slots[N];
+  std::atomic<uint32_t> head;   // Next slot to write (producer)
+  std::atomic<uint32_t> tail;   // Next slot to read (consumer)
+  volatile uint32_t overflows;
+};
+
+#endif
@@ -3,6 +3,8 @@
 
 #include <vector>
 #include <string>
+#include <stddef.h>
+#include "PagedList.h"
 
 // Bluetooth status
 extern std::string btStatus;
@@ -16,7 +18,9 @@ enum MenuType {
   MENU_ARTIST_LIST,
   MENU_ALBUM_LIST,
   MENU_SONG_LIST,
-  MENU_NOW_PLAYING
+  MENU_NOW_PLAYING,
+  MENU_SEARCH,          // Character picker
+  MENU_SEARCH_RESULTS
 };
 
 struct MenuItem {
@@ -44,23 +48,155 @@ extern std::vector<MenuStackEntry> menuStack;
 extern std::string currentArtist;
 extern std::string currentAlbum;
 extern std::string currentTitle;
+extern int currentArtistId;  // Row id of currentArtist (-1 = none)
+extern int currentAlbumId;   // Row id of currentAlbum (-1 = none)
+extern int currentSongId;    // Row id of the loaded song (-1 = none)
+
+// Library loaders report bytes read so far out of the file size
+typedef void (*LoadProgressCallback)(size_t loaded, size_t total);
+
+// Library rows. Strings reference the owning list's StringArena (or the
+// library image), so a row copy stays valid until that list is reset or
+// has switched arenas twice; copy into std::string to keep a name.
+struct Artist
+{
+  int id;
+  StringRef name;
+  StringRef displayName;     // List label, pre-truncated by the indexer
+  
+  Artist() : id(-1) {}
+  
+  void relocate(const StringArena& from, StringArena& to) {
+    name = to.adopt(name, from);
+    displayName = to.adopt(displayName, from);
+  }
+};
+
+struct Album
+{
+  int id;
+  int artistId;
+  StringRef name;
+  StringRef displayName;     // List label, pre-truncated by the indexer
+  int year;
+  
+  Album() : id(-1), artistId(-1), year(0) {}
+  
+  void relocate(const StringArena& from, StringArena& to) {
+    name = to.adopt(name, from);
+    displayName = to.adopt(displayName, from);
+  }
+};
+
+// Loudness normalisation measured by the indexer (EBU R128), in
+// hundredths of a dB; 0 when the track wasn't analysed
+struct ReplayGain
+{
+  int16_t track;
+  int16_t album;
+  
+  ReplayGain() : track(0), album(0) {}
+};
 
 // Song structure
 struct Song
 {
-  std::string title;         // Full title (for Now Playing)
-  std::string displayTitle;  // Truncated title (for list display) - NEW
-  std::string path;
+  int id;
+  int albumId;
+  StringRef title;           // Full title
+  StringRef displayName;     // List label, pre-truncated by the indexer
+  StringRef path;
   int track;
   int duration;
+  ReplayGain gain;
+  
+  Song() : id(-1), albumId(-1), track(0), duration(0) {}
+  
+  void relocate(const StringArena& from, StringArena& to) {
+    title = to.adopt(title, from);
+    displayName = to.adopt(displayName, from);
+    path = to.adopt(path, from);
+  }
+};
+
+// Page sources for the library lists (Indexer.cpp)
+template <> struct PageSource<Artist> {
+  static int count(int parentId);
+  static int fetch(int parentId, PageDirection dir, const Artist* anchor,
+                   int offset, int limit, StringArena& strings, std::vector<Artist>& out);
+};
+
+template <> struct PageSource<Album> {
+  static int count(int artistId);
+  static int fetch(int artistId, PageDirection dir, const Album* anchor,
+                   int offset, int limit, StringArena& strings, std::vector<Album>& out);
+};
+
+template <> struct PageSource<Song> {
+  static int count(int albumId);
+  static int fetch(int albumId, PageDirection dir, const Song* anchor,
+                   int offset, int limit, StringArena& strings, std::vector<Song>& out);
+};
+
+// Letter jump table: the artist row where each run of names filed under
+// one letter starts ('#' for non-letters), in list order
+struct LetterJump
+{
+  int row;
+  char letter;
+};
+
+extern std::vector<LetterJump> artistJumps;
+int letterJumpRunAt(int row);              // Run containing `row`
+
+// Letter jump scrolling (fast spin in the artist list)
+extern bool letterJumpActive;
+extern int letterJumpRun;                  // Index into artistJumps
+extern unsigned long lastLetterJump;
+#define LETTER_JUMP_SPIN_MS 400            // Fast spin (EncoderAccel) held this long
+#define LETTER_JUMP_TIMEOUT 1000           // Back to row scrolling when idle
+
+// Library search (word-prefix index built by the indexer tool)
+enum SearchKind { SEARCH_ARTIST, SEARCH_ALBUM, SEARCH_SONG };
+
+struct SearchResult
+{
+  SearchKind kind;
+  int id;                    // Row id in the table for `kind`
+  int artistId;
+  int albumId;               // -1 for artists
+  StringRef name;
+  StringRef displayName;
+  
+  SearchResult() : kind(SEARCH_ARTIST), id(-1), artistId(-1), albumId(-1) {}
+};
+
+// Where a result sits in the artist, album and song lists
+struct SearchLocation
+{
+  int artistIndex;
+  int albumIndex;
+  int songIndex;
   
-  Song() : track(0), duration(0) {}
+  SearchLocation() : artistIndex(0), albumIndex(0), songIndex(0) {}
 };
 
-// Library data
-extern std::vector<std::string> artists;
-extern std::vector<std::string> albums;
-extern std::vector<Song> songs;
+#define SEARCH_QUERY_MAX 16
+#define SEARCH_MAX_RESULTS 32
+#define SEARCH_ARENA_BYTES (8 * 1024)
+
+// Library data (windowed, see PagedList.h)
+extern PagedList<Artist> artists;
+extern PagedList<Album> albums;
+extern PagedList<Song> songs;
+
+// Search state (MENU_SEARCH / MENU_SEARCH_RESULTS)
+extern std::string searchQuery;
+extern int searchCharIndex;               // Position in SEARCH_ALPHABET
+extern std::vector<SearchResult> searchResults;
+extern int searchResultIndex;
+extern const char SEARCH_ALPHABET[];      // '<' deletes, '>' shows results
+void updateSearchResults();
 
 // Navigation indices
 extern volatile int artistIndex;
@@ -93,8 +229,18 @@ extern unsigned long lastBrightnessChange;
 #define BRIGHTNESS_TIMEOUT 3000
 #define BRIGHTNESS_ACTIVATION_TICKS 2
 
-// Display control - NEW
-extern bool forceDisplayRedraw;
+// Crossfade between consecutive tracks (0 = gapless, no fade)
+extern int crossfadeSeconds;
+#define CROSSFADE_STEP_SECONDS 2  // Settings entry cycles 0, 2, ... 10
+
+// Which ReplayGain the player applies; takes effect from the next track
+enum ReplayGainMode {
+  REPLAY_GAIN_OFF,
+  REPLAY_GAIN_TRACK,
+  REPLAY_GAIN_ALBUM,
+  REPLAY_GAIN_MODE_COUNT
+};
+extern int replayGainMode;
 
 // Menu functions
 void buildMainMenu();
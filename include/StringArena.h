@@ -0,0 +1,105 @@
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <Arduino.h>
+#include <string.h>
+#include <string>
+
+// Non-owning view of a NUL-terminated string that lives in a StringArena
+// or another long-lived buffer (e.g. the library image string pool).
+struct StringRef {
+  const char* ptr;
+  uint32_t len;
+
+  StringRef() : ptr(""), len(0) {}
+  StringRef(const char* text, size_t length) : ptr(text), len(length) {}
+
+  // Explicit so a temporary buffer can't be captured by accident
+  explicit StringRef(const char* text) : ptr(text ? text : ""), len(strlen(ptr)) {}
+
+  const char* c_str() const { return ptr; }
+  size_t length() const { return len; }
+  bool empty() const { return len == 0; }
+
+  std::string str() const { return std::string(ptr, len); }
+  operator std::string() const { return str(); }
+};
+
+inline bool operator==(const StringRef& a, const std::string& b) {
+  return a.len == b.size() && memcmp(a.ptr, b.data(), a.len) == 0;
+}
+
+inline bool operator==(const std::string& a, const StringRef& b) {
+  return b == a;
+}
+
+inline bool operator!=(const StringRef& a, const std::string& b) {
+  return !(a == b);
+}
+
+inline bool operator!=(const std::string& a, const StringRef& b) {
+  return !(b == a);
+}
+
+// Bump allocator for row strings in PSRAM. Strings are only freed all at
+// once by reset(), so filling a list never touches the internal heap.
+class StringArena {
+public:
+  StringArena() : base(NULL), capacity(0), used(0), overflowed(false) {}
+  ~StringArena() { free(base); }
+
+  bool begin(size_t bytes) {
+    if (base == NULL) {
+      base = (char*)ps_malloc(bytes);
+      capacity = base ? bytes : 0;
+    }
+    return base != NULL;
+  }
+
+  void reset() {
+    used = 0;
+    overflowed = false;
+  }
+
+  // Copy `text` in; returns an empty ref and sets full() when out of room
+  StringRef copy(const char* text, size_t length) {
+    if (used + length + 1 > capacity) {
+      overflowed = true;
+      return StringRef();
+    }
+
+    char* dst = base + used;
+    memcpy(dst, text, length);
+    dst[length] = '\0';
+    used += length + 1;
+    return StringRef(dst, length);
+  }
+
+  StringRef copy(const char* text) {
+    return text ? copy(text, strlen(text)) : StringRef();
+  }
+
+  // Re-home a string that lives in `from`; anything else is left as is
+  StringRef adopt(const StringRef& s, const StringArena& from) {
+    return from.owns(s) ? copy(s.ptr, s.len) : s;
+  }
+
+  bool owns(const StringRef& s) const {
+    return base != NULL && s.ptr >= base && s.ptr < base + capacity;
+  }
+
+  bool full() const { return overflowed; }
+  size_t bytesUsed() const { return used; }
+  size_t bytesFree() const { return capacity - used; }
+
+private:
+  char* base;
+  size_t capacity;
+  size_t used;
+  bool overflowed;
+
+  StringArena(const StringArena&);
+  StringArena& operator=(const StringArena&);
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef TRACK_DECODER_H
+#define TRACK_DECODER_H
+
+#include <Arduino.h>
+#include <SdFat.h>
+#include "AudioTools.h"
+#include "AudioTools/AudioCodecs/CodecMP3Helix.h"
+
+// MP3 bytes fed to Helix per decode() call
+#define TRACK_READ_CHUNK 1024
+
+// Smaller feeds while pre-decoding, so one call can't overrun the preroll
+#define TRACK_PRIME_CHUNK 256
+
+// PCM decoded ahead for the next track, and how much of it to fill
+#define TRACK_PREROLL_BYTES (32 * 1024)
+#define TRACK_PREROLL_TARGET (8 * 1024)
+
+// Samples a standard MP3 decoder outputs before the encoder's first sample
+#define MP3_DECODER_DELAY 529
+
+// One MP3 file decoded to 16-bit PCM. When the file carries a LAME/Info
+// tag, the encoder delay, decoder delay and end padding are trimmed, so
+// back-to-back tracks join without the silence the encoder added.
+//
+// The next track can be opened and pre-decoded into a preroll while the
+// current one is still playing; setOutput() later sends the preroll on
+// ahead of everything else. Callers hold sdMutex around open/prime/decode.
+class TrackDecoder : public Print {
+public:
+    TrackDecoder();
+    ~TrackDecoder();
+
+    bool open(const char* path);
+    void close();
+    bool isOpen() const { return opened; }
+
+    // Decode into the preroll until it holds about TRACK_PREROLL_TARGET
+    void prime();
+
+    // Where PCM goes from now on; flushes the preroll first
+    void setOutput(Print& out);
+
+    // Read and decode one chunk. Returns the bytes read, 0 at end of file.
+    size_t decode();
+
+    // Q15 loudness gain to play this track at (GainStage), unity on open
+    void setReplayGain(int32_t gain) { replayGain = gain; }
+    int32_t getReplayGain() const { return replayGain; }
+
+    // MP3 bytes not yet read
+    uint32_t bytesLeft() const { return opened ? dataEnd - position : 0; }
+
+    // PCM frames still to come: exact with a LAME tag, else estimated from
+    // the first frame's bitrate; UINT32_MAX if unknown
+    uint32_t framesLeft() const;
+
+    // PCM from Helix
+    size_t write(uint8_t b) override;
+    size_t write(const uint8_t* data, size_t len) override;
+
+private:
+    File32 file;
+    MP3DecoderHelix decoder;
+    Print* output;
+    uint8_t* preroll;
+    size_t prerollUsed;
+    uint32_t position;      // File offset of the next read
+    uint32_t dataEnd;       // End of MP3 frames (before any ID3v1 tag)
+    uint32_t skipFrames;    // PCM frames still to drop at the start
+    uint32_t keepFrames;    // PCM frames left to pass on (UINT32_MAX: no tag)
+    uint32_t bitrate;       // First frame, kbps (0: no frame header found)
+    uint32_t sampleRate;
+    int32_t replayGain;
+    bool opened;
+    uint8_t chunk[TRACK_READ_CHUNK];
+
+    uint32_t skipId3v2();
+    void readGaplessInfo();
+};
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef UI_SNAPSHOT_H
+#define UI_SNAPSHOT_H
+
+#include <Arduino.h>
+#include "State.h"
+
+// What changed since the last frame, passed to requestDisplayUpdate()
+#define DISPLAY_DIRTY_HEADER      (1 << 0)  // Title bar: battery, playback icon
+#define DISPLAY_DIRTY_LIST        (1 << 1)  // Menu and list rows, selection
+#define DISPLAY_DIRTY_NOW_PLAYING (1 << 2)  // Track title, artist, album
+#define DISPLAY_DIRTY_OVERLAY     (1 << 3)  // Volume, brightness, letter jump
+#define DISPLAY_DIRTY_FULL        (1 << 4)  // Clear and redraw everything
+
+// Track changes show up in the header icon, list markers and Now Playing
+#define DISPLAY_DIRTY_PLAYBACK (DISPLAY_DIRTY_HEADER | DISPLAY_DIRTY_LIST | DISPLAY_DIRTY_NOW_PLAYING)
+
+#define UI_LIST_ROWS 5
+#define UI_TEXT_MAX 64
+#define UI_TRACK_TEXT_MAX 128
+
+struct UiRow {
+  char text[UI_TEXT_MAX];
+  bool enabled;
+  bool playing;
+};
+
+// Everything the renderer needs for one frame, copied out of the shared
+// state so drawing never touches the lists the loop task is changing.
+struct UiSnapshot {
+  MenuType menu;
+  PlayerState playerState;
+  int batteryPercent;
+  bool batteryCharging;
+
+  // Visible window of the current list (search screen: top matches)
+  int listSize;
+  int index;
+  int rowCount;
+  int selectedRow;  // Row slot holding `index`, -1 if none
+  UiRow rows[UI_LIST_ROWS];
+  char selectedText[UI_TRACK_TEXT_MAX];  // Full name if the selected label was shortened
+  char subheader[UI_TEXT_MAX];
+  SearchKind selectedKind;
+  char jumpLetter;  // '\0' unless jumping by letter
+
+  // Search screen
+  char searchQuery[SEARCH_QUERY_MAX + 1];
+  int searchCharIndex;
+
+  // Overlays
+  bool volumeControlActive;
+  int volume;
+  bool brightnessControlActive;
+  int brightness;
+
+  // Now playing
+  char title[UI_TRACK_TEXT_MAX];
+  char artist[UI_TRACK_TEXT_MAX];
+  char album[UI_TRACK_TEXT_MAX];
+
+  #ifdef DEBUG
+  uint32_t requestMicros;  // First request folded into this snapshot
+  #endif
+};
+
+// First visible row of a `rows`-high window onto a `listSize` list so that
+// `index` is on screen. The window keeps its place while the index is
+// inside it and moves just far enough otherwise, so steps of any size (fast
+// spins, letter jumps, search results) stay visible.
+inline int listWindowStart(int index, int lastStart, int listSize, int rows)
+{
+  if (listSize <= rows) {
+    return 0;  // List fits on screen
+  }
+
+  int start = constrain(lastStart, index - rows + 1, index);
+  return constrain(start, 0, listSize - rows);
+}
+
+// Ask for a redraw; safe from any task. Bits collect until the next publish.
+void requestDisplayUpdate(uint32_t dirty);
+
+// Loop task: if anything was requested, build a snapshot, publish it and
+// wake the display task
+void publishUiSnapshot();
+
+// Display task: newest published snapshot. Lock-free triple buffer, the
+// returned snapshot stays untouched until the next call.
+const UiSnapshot& acquireUiSnapshot();
+
+#endif
@@ -1,7 +1,8 @@
 #!/usr/bin/env python3
 """
 Rouge MP3 Player - Music Library Indexer
-Scans music folder and creates SQLite database for ESP32
+Scans music folder and creates SQLite database for ESP32.
+Loudness (ReplayGain) analysis needs ffmpeg on PATH.
 
 Usage:
     python music_indexer.py <music_folder> <output_db>
@@ -12,6 +13,7 @@ Example:
 
 import os
 import sqlite3
+import struct
 from pathlib import Path
 from mutagen.mp3 import MP3
 from mutagen.easyid3 import EasyID3
@@ -19,6 +21,11 @@ import sys
 import argparse
 import unicodedata
 import re
+import math
+import shutil
+import subprocess
+from collections import Counter
+from concurrent.futures import ThreadPoolExecutor
 
 def sanitize_text(text):
     """
@@ -64,6 +71,18 @@ def sanitize_text(text):
     
     return cleaned
 
+# List rows on the player fit 17 glyphs: the built-in GFX font is 6 px per
+# character at text size 2, leaving room for the arrow on the right. Text is
+# already printable ASCII (sanitize_text), so one character is one glyph.
+LIST_LABEL_CHARS = 17
+
+def display_name(text):
+    """List label for the player, truncated with '...' if it doesn't fit"""
+    text = text or ''
+    if len(text) <= LIST_LABEL_CHARS:
+        return text
+    return text[:LIST_LABEL_CHARS - 3].rstrip() + '...'
+
 def create_database(db_path):
     """Create database schema"""
     print(f"📂 Creating database: {db_path}")
@@ -80,7 +99,8 @@ def create_database(db_path):
     cursor.execute('''
         CREATE TABLE artists (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
-            name TEXT NOT NULL UNIQUE
+            name TEXT NOT NULL UNIQUE,
+            display_name TEXT NOT NULL
         )
     ''')
     
@@ -89,6 +109,7 @@ def create_database(db_path):
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             artist_id INTEGER NOT NULL,
             name TEXT NOT NULL,
+            display_name TEXT NOT NULL,
             year INTEGER,
             FOREIGN KEY (artist_id) REFERENCES artists(id),
             UNIQUE(artist_id, name)
@@ -100,19 +121,55 @@ def create_database(db_path):
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             album_id INTEGER NOT NULL,
             title TEXT NOT NULL,
+            display_name TEXT NOT NULL,
             path TEXT NOT NULL UNIQUE,
             track_number INTEGER,
             duration INTEGER,
             file_size INTEGER,
+            track_gain REAL,
+            album_gain REAL,
             FOREIGN KEY (album_id) REFERENCES albums(id)
         )
     ''')
     
+    # Word-prefix search (see build_search_index)
+    cursor.execute('''
+        CREATE TABLE search_items (
+            id INTEGER PRIMARY KEY,
+            kind INTEGER NOT NULL,
+            ref_id INTEGER NOT NULL,
+            artist_id INTEGER NOT NULL,
+            album_id INTEGER,
+            name TEXT NOT NULL,
+            display_name TEXT NOT NULL
+        )
+    ''')
+    
+    cursor.execute('''
+        CREATE TABLE search_terms (
+            term TEXT NOT NULL,
+            item_id INTEGER NOT NULL,
+            position INTEGER NOT NULL,
+            PRIMARY KEY (term, item_id)
+        ) WITHOUT ROWID
+    ''')
+    
+    # Letter jump table: first artist list row of each run of names that
+    # start with the same letter (see build_jump_index)
+    cursor.execute('''
+        CREATE TABLE artist_jumps (
+            row INTEGER PRIMARY KEY,
+            letter TEXT NOT NULL
+        )
+    ''')
+    
     # Create indexes for fast queries
     cursor.execute('CREATE INDEX idx_songs_album ON songs(album_id)')
     cursor.execute('CREATE INDEX idx_albums_artist ON albums(artist_id)')
     cursor.execute('CREATE INDEX idx_songs_title ON songs(title)')
     cursor.execute('CREATE INDEX idx_artists_name ON artists(name)')
+    # Matches the player's list order so paged artist queries are index range scans
+    cursor.execute('CREATE INDEX idx_artists_name_nocase ON artists(name COLLATE NOCASE)')
     
     conn.commit()
     print("✅ Database schema created")
@@ -126,7 +183,8 @@ def get_or_create_artist(cursor, name):
     if row:
         return row[0]
     
-    cursor.execute('INSERT INTO artists (name) VALUES (?)', (name,))
+    cursor.execute('INSERT INTO artists (name, display_name) VALUES (?, ?)',
+                   (name, display_name(name)))
     return cursor.lastrowid
 
 def get_or_create_album(cursor, artist_id, name, year=None):
@@ -138,10 +196,144 @@ def get_or_create_album(cursor, artist_id, name, year=None):
     if row:
         return row[0]
     
-    cursor.execute('INSERT INTO albums (artist_id, name, year) VALUES (?, ?, ?)', 
-                   (artist_id, name, year))
+    cursor.execute('INSERT INTO albums (artist_id, name, display_name, year) VALUES (?, ?, ?, ?)', 
+                   (artist_id, name, display_name(name), year))
     return cursor.lastrowid
 
+# Search result kinds, in ranking order (must match SearchKind in State.h)
+SEARCH_KIND_ARTIST = 0
+SEARCH_KIND_ALBUM = 1
+SEARCH_KIND_SONG = 2
+
+def search_words(text):
+    """Lowercase words of a name, in order, for prefix search"""
+    return re.findall(r'[a-z0-9]+', (text or '').lower())
+
+def build_search_index(conn):
+    """Fill search_items/search_terms: one term row per distinct word of
+    every artist, album and song name. The player finds items whose words
+    start with a prefix with one range scan of the search_terms key."""
+    cursor = conn.cursor()
+    cursor.execute('DELETE FROM search_terms')
+    cursor.execute('DELETE FROM search_items')
+    
+    sources = [
+        (SEARCH_KIND_ARTIST, 'SELECT id, id, NULL, name, display_name FROM artists'),
+        (SEARCH_KIND_ALBUM, 'SELECT id, artist_id, id, name, display_name FROM albums'),
+        (SEARCH_KIND_SONG, '''SELECT songs.id, albums.artist_id, songs.album_id,
+                                    songs.title, songs.display_name
+                             FROM songs JOIN albums ON albums.id = songs.album_id'''),
+    ]
+    
+    item_id = 0
+    term_count = 0
+    for kind, query in sources:
+        for ref_id, artist_id, album_id, name, label in cursor.execute(query).fetchall():
+            item_id += 1
+            conn.execute('''
+                INSERT INTO search_items (id, kind, ref_id, artist_id, album_id, name, display_name)
+                VALUES (?, ?, ?, ?, ?, ?, ?)
+            ''', (item_id, kind, ref_id, artist_id, album_id, name, label))
+            
+            # First occurrence of each word keeps its position for ranking
+            seen = set()
+            for position, word in enumerate(search_words(name)):
+                if word not in seen:
+                    seen.add(word)
+                    conn.execute('INSERT INTO search_terms (term, item_id, position) VALUES (?, ?, ?)',
+                                 (word, item_id, position))
+                    term_count += 1
+    
+    conn.commit()
+    print(f"🔎 Search index: {item_id} items, {term_count} terms")
+
+def jump_letter(name):
+    """Letter a name is filed under for fast scrolling: A-Z, or '#'"""
+    first = (name or '')[:1].upper()
+    return first if 'A' <= first <= 'Z' else '#'
+
+def artist_jump_runs(names):
+    """(row, letter) for each row of the ordered artist list where the
+    jump letter changes"""
+    runs = []
+    for row, name in enumerate(names):
+        letter = jump_letter(name)
+        if not runs or runs[-1][1] != letter:
+            runs.append((row, letter))
+    return runs
+
+def build_jump_index(conn):
+    """Fill artist_jumps so the player can scroll by letter without SQL"""
+    cursor = conn.cursor()
+    cursor.execute('DELETE FROM artist_jumps')
+    
+    # Same ordering as the player's artist list (src/Database.cpp)
+    cursor.execute('SELECT name FROM artists ORDER BY name COLLATE NOCASE, id')
+    runs = artist_jump_runs(row[0] for row in cursor.fetchall())
+    cursor.executemany('INSERT INTO artist_jumps (row, letter) VALUES (?, ?)', runs)
+    
+    conn.commit()
+    print(f"🔤 Letter jumps: {len(runs)}")
+
+# Loudness normalisation: EBU R128 integrated loudness per track and per
+# album, stored as the gain (dB) that brings it to the ReplayGain 2.0
+# reference. The player applies it as a single multiply.
+REPLAY_GAIN_REFERENCE_LUFS = -18.0
+R128_ABSOLUTE_GATE = -70.0   # LUFS
+R128_RELATIVE_GATE = -10.0   # LU below the ungated mean
+
+# ffmpeg does the decoding and K-weighting; 100 ms frames make the filter
+# report the momentary (400 ms) loudness once per 75%-overlapping block
+LOUDNESS_FILTER = ('aresample=48000,asetnsamples=n=4800:p=0,ebur128=metadata=1,'
+                   'ametadata=mode=print:key=lavfi.r128.M:file=-')
+
+def loudness_histogram(file_path):
+    """Block loudness of a file as a Counter of hundredths of a LUFS, so
+    an album's blocks can be pooled without keeping them all. None if
+    ffmpeg fails."""
+    try:
+        result = subprocess.run(
+            ['ffmpeg', '-nostdin', '-hide_banner', '-nostats', '-loglevel', 'error',
+             '-i', file_path, '-af', LOUDNESS_FILTER, '-f', 'null', '-'],
+            stdout=subprocess.PIPE, stderr=subprocess.PIPE, universal_newlines=True)
+    except OSError:
+        return None
+    if result.returncode != 0:
+        return None
+    
+    histogram = Counter()
+    blocks = 0
+    for line in result.stdout.splitlines():
+        if line.startswith('lavfi.r128.M='):
+            blocks += 1
+            # The first three windows still hold the filter's initial silence
+            if blocks > 3:
+                loudness = float(line.split('=', 1)[1])
+                if loudness > R128_ABSOLUTE_GATE:
+                    histogram[int(round(loudness * 100))] += 1
+    return histogram
+
+def integrated_loudness(histogram):
+    """BS.1770 gated loudness (LUFS) of absolute-gated block loudness
+    counts; None if nothing is above the gate"""
+    if not histogram:
+        return None
+    
+    def mean_loudness(bins):
+        total = sum(histogram[b] for b in bins)
+        energy = sum(histogram[b] * 10 ** ((b / 100 + 0.691) / 10) for b in bins)
+        return -0.691 + 10 * math.log10(energy / total)
+    
+    relative_gate = mean_loudness(histogram) + R128_RELATIVE_GATE
+    return mean_loudness([b for b in histogram if b / 100 > relative_gate])
+
+def replay_gain(histogram):
+    """Gain in dB to the reference loudness, or None without a measurement"""
+    loudness = integrated_loudness(histogram)
+    if loudness is None:
+        return None
+    return round(REPLAY_GAIN_REFERENCE_LUFS - loudness, 2)
+
 def should_skip_file(filename):
     """Check if file should be skipped (Mac system files, etc.)"""
     # Skip Mac resource fork files
@@ -214,7 +406,7 @@ def extract_metadata(file_path):
         print(f"⚠️  Error reading {file_path}: {e}")
         return None
 
-def scan_music_folder(music_folder, db_path, verbose=False):
+def scan_music_folder(music_folder, db_path, verbose=False, analyze_gain=True, jobs=None):
     """Scan music folder and populate database"""
     print(f"📁 Scanning: {music_folder}")
     print(f"💾 Database: {db_path}")
@@ -262,10 +454,20 @@ def scan_music_folder(music_folder, db_path, verbose=False):
         print(f"   Skipped {mac_files_skipped} Mac system files")
     if non_mp3_skipped > 0:
         print(f"   Skipped {non_mp3_skipped} non-MP3 files")
+    
+    if analyze_gain and shutil.which('ffmpeg') is None:
+        print("⚠️  ffmpeg not found: skipping loudness analysis (install it or pass --no-gain)")
+        analyze_gain = False
     print()
     
+    # Loudness analysis is the slow part; ffmpeg runs it in parallel ahead
+    # of the loop, results coming back in file order
+    pool = ThreadPoolExecutor(jobs or os.cpu_count() or 1) if analyze_gain else None
+    histograms = pool.map(loudness_histogram, mp3_files) if pool else (None for _ in mp3_files)
+    album_histograms = {}
+    
     # Process each file
-    for idx, file_path in enumerate(mp3_files, 1):
+    for idx, (file_path, histogram) in enumerate(zip(mp3_files, histograms), 1):
         # Calculate relative path (remove music_folder prefix)
         relative_path = os.path.relpath(file_path, music_folder)
         
@@ -292,12 +494,20 @@ def scan_music_folder(music_folder, db_path, verbose=False):
                                           metadata['year'])
             
             # Insert song
+            track_gain = replay_gain(histogram)
             cursor.execute('''
-                INSERT INTO songs (album_id, title, path, track_number, duration, file_size)
-                VALUES (?, ?, ?, ?, ?, ?)
-            ''', (album_id, metadata['title'], esp32_path, 
+                INSERT INTO songs (album_id, title, display_name, path, track_number, duration, file_size, track_gain)
+                VALUES (?, ?, ?, ?, ?, ?, ?, ?)
+            ''', (album_id, metadata['title'], display_name(metadata['title']), esp32_path, 
                   metadata['track_number'], metadata['duration'], 
-                  metadata['file_size']))
+                  metadata['file_size'], track_gain))
+            
+            if histogram is not None:
+                album_histograms.setdefault(album_id, Counter()).update(histogram)
+                if verbose:
+                    print(f"   🔊 Track gain: {track_gain if track_gain is not None else 'silent'} dB")
+            elif analyze_gain:
+                print(f"⚠️  Loudness analysis failed: {relative_path}")
             
             song_count += 1
             
@@ -317,6 +527,20 @@ def scan_music_folder(music_folder, db_path, verbose=False):
     # Final commit
     conn.commit()
     
+    if pool:
+        pool.shutdown()
+        
+        # Album gain gates the blocks of every track together, as if the
+        # album were one file
+        for album_id, histogram in album_histograms.items():
+            cursor.execute('UPDATE songs SET album_gain = ? WHERE album_id = ?',
+                           (replay_gain(histogram), album_id))
+        conn.commit()
+        print(f"🔊 Loudness: {len(album_histograms)} albums analysed")
+    
+    build_search_index(conn)
+    build_jump_index(conn)
+    
     # Print summary
     cursor.execute('SELECT COUNT(*) FROM artists')
     artist_count = cursor.fetchone()[0]
@@ -358,7 +582,7 @@ def verify_database(db_path):
     cursor.execute("SELECT name FROM sqlite_master WHERE type='table'")
     tables = [row[0] for row in cursor.fetchall()]
     
-    required_tables = ['artists', 'albums', 'songs']
+    required_tables = ['artists', 'albums', 'songs', 'search_items', 'search_terms', 'artist_jumps']
     for table in required_tables:
         if table in tables:
             print(f"   ✅ Table '{table}' exists")
@@ -401,6 +625,132 @@ def verify_database(db_path):
     print("✅ Database verification complete!")
     return True
 
+# ----------------------------------------------------------------------------
+# Binary library image (music.lib)
+#
+# Read-only alternative to music.db that the player can list from with plain
+# pointer arithmetic (see include/LibraryImage.h). All integers are little
+# endian, tables are 4-byte aligned and stored in the player's list order:
+#
+#   header    48 bytes
+#   artists   16 bytes each: name, display_name, first_album, album_count
+#   albums    20 bytes each: name, display_name, artist, first_song, song_count(u16), year(u16)
+#   songs     28 bytes each: title, display_name, path, album, track(u16), track_gain(i16),
+#                            duration, album_gain(i16), padding
+#             (gains in hundredths of a dB; 0 when not analysed)
+#   jumps      8 bytes each: first artist row, letter(u8), padding
+#   strings   NUL-terminated UTF-8, deduplicated; records store pool offsets
+#
+# Record ids on the player are table indexes, so an artist's albums and an
+# album's songs are contiguous index ranges.
+# ----------------------------------------------------------------------------
+
+LIBRARY_IMAGE_MAGIC = b'RLIB'
+LIBRARY_IMAGE_VERSION = 4
+LIBRARY_HEADER = struct.Struct('<4sHH3I5I2I')
+ARTIST_RECORD = struct.Struct('<4I')
+ALBUM_RECORD = struct.Struct('<4I2H')
+SONG_RECORD = struct.Struct('<4IHhIh2x')
+JUMP_RECORD = struct.Struct('<IB3x')
+
+def gain_field(gain):
+    """dB as hundredths for the image, 0 (unity) if unknown"""
+    if gain is None:
+        return 0
+    return min(max(int(round(gain * 100)), -0x8000), 0x7FFF)
+
+class StringPool:
+    """Deduplicated NUL-terminated string pool"""
+    def __init__(self):
+        self.data = bytearray()
+        self.offsets = {}
+    
+    def add(self, text):
+        text = text or ''
+        if text not in self.offsets:
+            self.offsets[text] = len(self.data)
+            self.data += text.encode('utf-8') + b'\0'
+        return self.offsets[text]
+
+def write_library_image(db_path, image_path):
+    """Export music.db into the binary library image"""
+    print()
+    print(f"📦 Writing library image: {image_path}")
+    
+    conn = sqlite3.connect(db_path)
+    cursor = conn.cursor()
+    pool = StringPool()
+    
+    # Same ordering as the player's list queries (src/Database.cpp)
+    cursor.execute('SELECT id, name, display_name FROM artists ORDER BY name COLLATE NOCASE, id')
+    artist_rows = cursor.fetchall()
+    
+    artist_records = []
+    album_records = []
+    song_records = []
+    
+    for artist_index, (artist_id, artist_name, artist_label) in enumerate(artist_rows):
+        cursor.execute('''
+            SELECT id, name, display_name, ifnull(year, 0) FROM albums
+            WHERE artist_id = ?
+            ORDER BY ifnull(year, 0), name COLLATE NOCASE, id
+        ''', (artist_id,))
+        album_rows = cursor.fetchall()
+        
+        artist_records.append(ARTIST_RECORD.pack(
+            pool.add(artist_name), pool.add(artist_label), len(album_records), len(album_rows)))
+        
+        for album_id, album_name, album_label, year in album_rows:
+            cursor.execute('''
+                SELECT title, display_name, path, ifnull(track_number, 0), ifnull(duration, 0),
+                       track_gain, album_gain
+                FROM songs
+                WHERE album_id = ?
+                ORDER BY ifnull(track_number, 0), id
+            ''', (album_id,))
+            song_rows = cursor.fetchall()
+            
+            album_records.append(ALBUM_RECORD.pack(
+                pool.add(album_name), pool.add(album_label), artist_index, len(song_records),
+                min(len(song_rows), 0xFFFF), min(max(year, 0), 0xFFFF)))
+            album_index = len(album_records) - 1
+            
+            for title, title_label, path, track, duration, track_gain, album_gain in song_rows:
+                song_records.append(SONG_RECORD.pack(
+                    pool.add(title), pool.add(title_label), pool.add(path), album_index,
+                    min(max(track, 0), 0xFFFF), gain_field(track_gain), max(duration, 0),
+                    gain_field(album_gain)))
+    
+    conn.close()
+    
+    jump_records = [JUMP_RECORD.pack(row, ord(letter))
+                    for row, letter in artist_jump_runs(name for _, name, _ in artist_rows)]
+    
+    # Lay out tables after the header (record sizes keep 4-byte alignment)
+    artist_table = LIBRARY_HEADER.size
+    album_table = artist_table + ARTIST_RECORD.size * len(artist_records)
+    song_table = album_table + ALBUM_RECORD.size * len(album_records)
+    jump_table = song_table + SONG_RECORD.size * len(song_records)
+    string_pool = jump_table + JUMP_RECORD.size * len(jump_records)
+    
+    header = LIBRARY_HEADER.pack(
+        LIBRARY_IMAGE_MAGIC, LIBRARY_IMAGE_VERSION, LIBRARY_HEADER.size,
+        len(artist_records), len(album_records), len(song_records),
+        artist_table, album_table, song_table, string_pool, len(pool.data),
+        jump_table, len(jump_records))
+    
+    with open(image_path, 'wb') as f:
+        f.write(header)
+        for records in (artist_records, album_records, song_records, jump_records):
+            for record in records:
+                f.write(record)
+        f.write(pool.data)
+    
+    print(f"   Artists: {len(artist_records)}, Albums: {len(album_records)}, "
+          f"Songs: {len(song_records)}")
+    print(f"   String pool: {len(pool.data) / 1024:.1f} KB")
+    print(f"📏 Image size: {os.path.getsize(image_path) / 1024:.1f} KB")
+
 def main():
     parser = argparse.ArgumentParser(
         description='Index MP3 files and create SQLite database for Rouge MP3 Player',
@@ -418,6 +768,12 @@ Examples:
   
   # Verbose output
   python music_indexer.py /Volumes/SD_CARD/Music /Volumes/SD_CARD/music.db -v
+  
+  # Skip the (slow) loudness analysis
+  python music_indexer.py /Volumes/SD_CARD/Music /Volumes/SD_CARD/music.db --no-gain
+  
+  # Also write the binary library image
+  python music_indexer.py /Volumes/SD_CARD/Music /Volumes/SD_CARD/music.db --image /Volumes/SD_CARD/music.lib
         '''
     )
     
@@ -427,6 +783,12 @@ Examples:
                        help='Show detailed progress')
     parser.add_argument('--verify', action='store_true',
                        help='Verify database after creation')
+    parser.add_argument('--no-gain', action='store_true',
+                       help='Skip EBU R128 loudness analysis (needs ffmpeg on PATH)')
+    parser.add_argument('-j', '--jobs', type=int, metavar='N',
+                       help='Parallel loudness analyses (default: CPU count)')
+    parser.add_argument('--image', metavar='LIB_PATH',
+                       help='Also write the binary library image (e.g. music.lib next to music.db)')
     
     args = parser.parse_args()
     
@@ -441,11 +803,15 @@ Examples:
     
     # Scan and create database
     try:
-        scan_music_folder(args.music_folder, args.output_db, args.verbose)
+        scan_music_folder(args.music_folder, args.output_db, args.verbose,
+                          not args.no_gain, args.jobs)
         
         if args.verify:
             verify_database(args.output_db)
         
+        if args.image:
+            write_library_image(args.output_db, args.image)
+        
         print()
         print("🎵 Ready to use with Rouge MP3 Player!")
         print("   1. Eject SD card safely")
@@ -4,29 +4,31 @@
 #include "Navigation.h"
 #include "Display.h"
 #include "Preferences.h"  // NEW
+#include "SdLoader.h"
+#include "TrackDecoder.h"
+#include "Crossfade.h"
+#include "GainStage.h"
 
 #include "AudioTools.h"
 #include "AudioTools/Communication/A2DPStream.h"
-#include "AudioTools/Disk/AudioSourceSDFAT.h"
-#include "AudioTools/AudioCodecs/CodecMP3Helix.h"
 
 #include <SdFat.h>
 #include "esp_a2dp_api.h"
 
-const char *startFilePath = "/";
-const char *ext = "mp3";
 const int buffer_size = 128 * 1024;
 
 const char *headphoneName = "JBL TUNE235NC TWS";
 
 BufferRTOS<uint8_t> buffer(0);
 QueueStream<uint8_t> out(buffer);
-MP3DecoderHelix decoder;
-
-AudioSourceSDFAT<SdFat32, File32> source(startFilePath, ext, 32);
-AudioPlayer player(source, out, decoder);
+GainStage volume(out);
 BluetoothA2DPSource a2dp;
 
+// Track being decoded into the buffer, and the next one opened behind it
+static TrackDecoder tracks[2];
+static TrackDecoder* playing = &tracks[0];
+static TrackDecoder* queued = &tracks[1];
+
 // State tracking
 String last_device_name = headphoneName;
 unsigned long last_watchdog_check = 0;
@@ -37,6 +39,69 @@ const unsigned long WATCHDOG_INTERVAL = 500; // ms
 unsigned long lastVolumeSaveTime = 0;
 int lastSavedVolume = -1;
 
+// Decode task. playerMutex guards the tracks and buffer against the
+// control functions on the loop task; take it before sdMutex.
+static TaskHandle_t decodeTaskHandle = NULL;
+static SemaphoreHandle_t playerMutex = NULL;
+static volatile bool trackFinished = false;  // Set by the decode task at EOF
+
+#if AUDIO_GAPLESS
+// Next-track handoff. The decode task asks once per track (nextWanted),
+// the loop task answers with a path, and the decode task reports each
+// splice by bumping tracksSpliced.
+static volatile bool nextWanted = false;
+static bool nextRequested = false;           // Decode task: asked for this track
+static std::string nextPath;                 // Guarded by playerMutex
+static int32_t nextGain = GAIN_UNITY;        // Likewise; its loudness gain
+static QueuedSong nextSong;                  // Loop task only
+static volatile uint32_t tracksSpliced = 0;
+static uint32_t splicesHandled = 0;          // Loop task only
+
+// Crossfade over the end of the playing track (crossfadeSeconds > 0)
+static Crossfader crossfader;
+static bool crossfadeReady = false;          // Stage buffers allocated
+static bool fading = false;                  // Decode task
+#endif
+static AudioStats audioStats = { 0, 0, 0, 0, 0, buffer_size };
+
+AudioStats getAudioStats() {
+    return audioStats;
+}
+
+static void wakeDecodeTask() {
+    if (decodeTaskHandle != NULL) {
+        xTaskNotifyGive(decodeTaskHandle);
+    }
+}
+
+// Q15 loudness gain for a song under the current setting. The analysis
+// happened in the indexer, so this is all the player does with it.
+static int32_t replayGainFor(const ReplayGain& gain) {
+    switch (replayGainMode) {
+        case REPLAY_GAIN_TRACK:
+            return decibelsToGain(gain.track);
+        case REPLAY_GAIN_ALBUM:
+            return decibelsToGain(gain.album);
+        default:
+            return GAIN_UNITY;
+    }
+}
+
+// Drop the playing and queued tracks; caller holds playerMutex
+static void closeTracks() {
+    playing->close();
+    queued->close();
+    trackFinished = false;
+    
+    #if AUDIO_GAPLESS
+    nextPath.clear();
+    nextRequested = false;
+    nextWanted = false;
+    crossfader.reset();
+    fading = false;
+    #endif
+}
+
 // ============================================================================
 // AUDIO DATA CALLBACK
 // ============================================================================
@@ -49,7 +114,15 @@ int32_t get_sound_data(uint8_t* data, int32_t bytes) {
     }
     
     // Just read directly - no mutex needed for buffer read
-    return buffer.readArray(data, bytes);
+    int32_t read = buffer.readArray(data, bytes);
+    if (read < bytes) {
+        audioStats.underruns++;
+    }
+    
+    if (buffer.available() < DECODE_LOW_WATERMARK) {
+        wakeDecodeTask();
+    }
+    return read;
 }
 
 // ============================================================================
@@ -68,14 +141,17 @@ void connection_state_changed(esp_a2d_connection_state_t state, void* ptr) {
             if (player_state != STATE_STOPPED) {
                 Serial.println("[PLAYER] Stopping due to disconnect");
                 player_state = STATE_STOPPED;
+                xSemaphoreTake(playerMutex, portMAX_DELAY);
+                closeTracks();
                 buffer.reset();
+                xSemaphoreGive(playerMutex);
                 delay(10);
                 a2dp.disconnect();
                 delay(500);
                 // Send back to Main Menu
                 currentMenu = MENU_MAIN;
                 buildMainMenu();
-                displayNeedsUpdate = true;
+                requestDisplayUpdate(DISPLAY_DIRTY_FULL);
                 delay(10);
             }
             break;
@@ -187,6 +263,7 @@ void resumePlayback() {
     }
     
     player_state = STATE_PLAYING;
+    wakeDecodeTask();
     Serial.println("[PLAYER] Resumed");
 }
 
@@ -198,14 +275,16 @@ void stopPlayback() {
     
     Serial.println("[PLAYER] Stopping...");
     
-    // Stop the player
-    if (player.isActive()) {
-        player.stop();
-    }
+    xSemaphoreTake(playerMutex, portMAX_DELAY);
+    
+    // Close the file(s)
+    closeTracks();
     
     // Clear the buffer
     buffer.reset();
     
+    xSemaphoreGive(playerMutex);
+    
     // Reset state
     player_state = STATE_STOPPED;
     
@@ -265,6 +344,199 @@ void changeBluetoothDevice(const String& new_device_name) {
     Serial.println("[BT] Connecting to new device...");
 }
 
+// ============================================================================
+// DECODE TASK
+// ============================================================================
+
+#if AUDIO_GAPLESS
+// The queued track becomes the playing one, its PCM following straight on
+// in the buffer at its own loudness gain
+static void spliceQueuedTrack() {
+    volume.setTrackGain(queued->getReplayGain());
+    queued->setOutput(volume);
+    playing->close();
+    TrackDecoder* finished = playing;
+    playing = queued;
+    queued = finished;
+    nextRequested = false;
+    tracksSpliced++;
+}
+
+// During a crossfade: decode whichever track is behind and mix. Once the
+// outgoing track is used up the incoming one carries on alone.
+static size_t crossfadeStep() {
+    CrossfadeSide side = crossfader.next();
+    TrackDecoder* track = (side == CROSSFADE_OUT) ? playing : queued;
+    if (track->decode() == 0) {
+        crossfader.end(side);
+    }
+    crossfader.pump();
+    
+    if (crossfader.outgoingDone()) {
+        crossfader.finish();
+        fading = false;
+        spliceQueuedTrack();
+        
+        #ifdef DEBUG
+        if (crossfader.dropped() > 0) {
+            Serial.printf("⚠️ Crossfade stage overflow: %u frames dropped so far\n", crossfader.dropped());
+        }
+        #endif
+    }
+    return 1;
+}
+#endif
+
+// One chunk of the playing track. At its end a queued track that is ready
+// takes over, either straight away or faded in over the last
+// crossfadeSeconds. Caller holds playerMutex and sdMutex.
+static size_t decodeStep() {
+    #if AUDIO_GAPLESS
+    if (fading) {
+        return crossfadeStep();
+    }
+    #endif
+    
+    size_t copied = playing->decode();
+    
+    #if AUDIO_GAPLESS
+    if (copied == 0 && queued->isOpen()) {
+        spliceQueuedTrack();
+        copied = playing->decode();
+    }
+    
+    uint32_t fadeFrames = crossfadeReady ? crossfadeSeconds * CROSSFADE_SAMPLE_RATE : 0;
+    uint32_t framesLeft = playing->framesLeft();
+    
+    // Nearly read: ask loop() for the track after this one
+    if (!nextRequested && playing->isOpen() &&
+        (playing->bytesLeft() < GAPLESS_PREPARE_BYTES || framesLeft <= fadeFrames + GAPLESS_PREPARE_FRAMES)) {
+        nextRequested = true;
+        nextWanted = true;
+    }
+    
+    // Fade over what is left once inside the crossfade window; tracks of
+    // unknown length just splice
+    if (fadeFrames > 0 && queued->isOpen() && framesLeft <= fadeFrames) {
+        // Both loudness gains move into the mix for the fade; the stage
+        // runs at unity until the splice hands it the incoming one
+        crossfader.start(volume, framesLeft, playing->getReplayGain(), queued->getReplayGain());
+        volume.setTrackGain(GAIN_UNITY);
+        playing->setOutput(crossfader.side(CROSSFADE_OUT));
+        queued->setOutput(crossfader.side(CROSSFADE_IN));
+        fading = true;
+        Serial.printf("🎚️ Crossfade over %u ms\n", framesLeft / (CROSSFADE_SAMPLE_RATE / 1000));
+    }
+    #endif
+    
+    return copied;
+}
+
+#if AUDIO_GAPLESS
+// Open and pre-decode the track loop() queued, well before it is needed
+static void prepareNextTrack() {
+    xSemaphoreTake(playerMutex, portMAX_DELAY);
+    if (!nextPath.empty() && !queued->isOpen()) {
+        xSemaphoreTake(sdMutex, portMAX_DELAY);
+        if (queued->open(nextPath.c_str())) {
+            queued->setReplayGain(nextGain);
+            queued->prime();
+        }
+        xSemaphoreGive(sdMutex);
+        nextPath.clear();
+    }
+    xSemaphoreGive(playerMutex);
+}
+#endif
+
+// Decode until the buffer reaches the high watermark or the track ends
+static void refillBuffer() {
+    #ifdef DEBUG
+    static uint32_t lastCopies = 0;
+    static uint32_t lastMicros = 0;
+    static uint32_t lastUnderruns = 0;
+    static uint32_t lastOverruns = 0;
+    static unsigned long lastReport = millis();
+    #endif
+    
+    size_t fill = buffer.available();
+    if (fill < audioStats.minFill) {
+        audioStats.minFill = fill;
+    }
+    
+    while (player_state == STATE_PLAYING && bluetoothConnected && !trackFinished &&
+           buffer.available() < DECODE_HIGH_WATERMARK) {
+        size_t copied = 0;
+        uint32_t start = micros();
+        
+        xSemaphoreTake(playerMutex, portMAX_DELAY);
+        xSemaphoreTake(sdMutex, portMAX_DELAY);
+        try {
+            copied = decodeStep();
+        } catch (...) {
+            xSemaphoreGive(sdMutex);
+            xSemaphoreGive(playerMutex);
+            Serial.println("❌ Audio copy exception!");
+            return;
+        }
+        xSemaphoreGive(sdMutex);
+        xSemaphoreGive(playerMutex);
+        
+        uint32_t elapsed = micros() - start;
+        audioStats.copies++;
+        audioStats.decodeMicros += elapsed;
+        if (elapsed > audioStats.maxDecodeMicros) {
+            audioStats.maxDecodeMicros = elapsed;
+        }
+        if (buffer.availableForWrite() == 0) {
+            audioStats.overruns++;
+        }
+        
+        if (copied == 0) {
+            // loop() picks the next track; nothing more to decode until then
+            trackFinished = true;
+        }
+    }
+    
+    #ifdef DEBUG
+    if (millis() - lastReport > 5000) {
+        uint32_t copies = audioStats.copies - lastCopies;
+        uint32_t busy = audioStats.decodeMicros - lastMicros;
+        Serial.printf("🎵 Decode: %u copies, avg %u us, max %u us, load %u%%, min fill %u KB, underruns %u, overruns %u\n",
+                      copies, copies ? busy / copies : 0, audioStats.maxDecodeMicros,
+                      busy / ((millis() - lastReport) * 10), audioStats.minFill / 1024,
+                      audioStats.underruns - lastUnderruns, audioStats.overruns - lastOverruns);
+        lastCopies = audioStats.copies;
+        lastMicros = audioStats.decodeMicros;
+        lastUnderruns = audioStats.underruns;
+        lastOverruns = audioStats.overruns;
+        lastReport = millis();
+    }
+    #endif
+}
+
+// Sleeps between refills; the A2DP callback wakes it below the low watermark
+static void decodeTask(void* param) {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(DECODE_IDLE_MS));
+        
+        #if AUDIO_GAPLESS
+        prepareNextTrack();
+        #endif
+        
+        if (buffer.available() < DECODE_LOW_WATERMARK) {
+            refillBuffer();
+        }
+        
+        #ifdef DEBUG
+        UBaseType_t highWater = uxTaskGetStackHighWaterMark(NULL);
+        if (highWater < 512) {
+            Serial.printf("⚠️ Decode task stack low: %u bytes\n", highWater);
+        }
+        #endif
+    }
+}
+
 void initAudio()
 {
     buffer.resize(buffer_size);
@@ -273,17 +545,22 @@ void initAudio()
 
     AudioLogger::instance().begin(Serial, AudioLogger::Warning);
 
-    source.begin();
     out.begin(60);
-    player.setDelayIfOutputFull(0);
+    
+    #ifdef DEBUG
+    benchmarkGain();
+    #endif
     
     // Load saved volume - NEW
     currentVolume = rougePrefs.loadVolume();
-    player.setVolume(currentVolume / 100.0f);
+    setPlaybackVolume(currentVolume);
     Serial.printf("🔊 Volume set to %d%%\n", currentVolume);
+    replayGainMode = rougePrefs.loadReplayGainMode();
     
-    player.setAutoNext(false);
-    player.setAutoFade(true);
+    #if AUDIO_GAPLESS
+    crossfadeSeconds = rougePrefs.loadCrossfade();
+    crossfadeReady = crossfader.begin();
+    #endif
 
     Serial.println("\n[BT] Configuring Bluetooth A2DP Source...");
     a2dp.set_data_callback(get_sound_data);
@@ -298,24 +575,82 @@ void initAudio()
     bluetoothConnected = false;
     btStatus = "BT Disconnected";
     
+    // Core 1 with loop(), but preempting it whenever the buffer runs low
+    playerMutex = xSemaphoreCreateMutex();
+    BaseType_t result = xTaskCreatePinnedToCore(
+        decodeTask,
+        "Decode",
+        DECODE_TASK_STACK,
+        NULL,
+        DECODE_TASK_PRIORITY,
+        &decodeTaskHandle,
+        1
+    );
+    
+    if (result != pdPASS) {
+        Serial.println("❌ Failed to create decode task!");
+    }
+    
     logRamSpace("A2DP start");
 }
 
+// Ramped in by the gain stage; safe to call on every encoder step
+void setPlaybackVolume(int percent)
+{
+    volume.setVolume(percent);
+}
+
+#if AUDIO_GAPLESS
+// Hand the decode task the track autoNext() would play next
+static void queueNextTrack()
+{
+    QueuedSong song;
+    if (!peekNextSong(song)) {
+        return;  // End of library: the track just ends
+    }
+    
+    xSemaphoreTake(playerMutex, portMAX_DELAY);
+    nextPath = song.path;
+    nextGain = replayGainFor(song.gain);
+    xSemaphoreGive(playerMutex);
+    nextSong = song;
+    
+    Serial.printf("⏭️ Next up: %s\n", song.title.c_str());
+    wakeDecodeTask();
+}
+#endif
+
 void audioLoop()
 {
-    // Feed buffer when playing
-    if (player_state == STATE_PLAYING && bluetoothConnected) {
-        size_t copied = 0;
-        
-        try {
-            copied = player.copy();
-        } catch (...) {
-            Serial.println("❌ Audio copy exception!");
-            return;
+    #if AUDIO_GAPLESS
+    if (nextWanted) {
+        nextWanted = false;
+        queueNextTrack();
+    }
+    
+    // The decode task moved on to the queued track; move the lists to
+    // it, not to whatever follows the cursors browsed since queueing
+    if (tracksSpliced != splicesHandled) {
+        splicesHandled = tracksSpliced;
+        if (!selectQueuedSong(nextSong)) {
+            Serial.println("⚠️ Queued song no longer in the lists");
         }
+        currentTitle = nextSong.title;
+        currentSongId = nextSong.songId;
+        Serial.printf("▶️ Playing: %s (gapless)\n", currentTitle.c_str());
         
-        if (copied == 0)
-        {
+        if (currentMenu == MENU_MAIN) {
+            buildMainMenu();
+        }
+        requestDisplayUpdate(DISPLAY_DIRTY_PLAYBACK);
+    }
+    #endif
+    
+    // The decode task hit the end of the track; moving on touches the
+    // library lists, so it happens here on the loop task
+    if (trackFinished) {
+        trackFinished = false;
+        if (player_state == STATE_PLAYING && bluetoothConnected) {
             Serial.println("📀 End of file reached (song finished)");    
             autoNext();
         }
@@ -339,6 +674,7 @@ void playCurrentSong(bool updateDisplay)
     if (!bluetoothConnected) {
         Serial.println("❌ Cannot play - Bluetooth disconnected");
         currentTitle = "BT Disconnected";
+        currentSongId = -1;
         return;
     }
     
@@ -352,12 +688,14 @@ void playCurrentSong(bool updateDisplay)
     if (song.path.empty()) {
         Serial.println("❌ Empty song path!");
         currentTitle = "Error: No path";
-        displayNeedsUpdate = true;
+        currentSongId = -1;
+        requestDisplayUpdate(DISPLAY_DIRTY_NOW_PLAYING);
         autoNext();
         return;
     }
 
     currentTitle = song.title;
+    currentSongId = song.id;
     
     Serial.printf("▶️ Playing: %s\n", song.title.c_str());
     Serial.printf("   Path: %s\n", song.path.c_str());
@@ -365,27 +703,40 @@ void playCurrentSong(bool updateDisplay)
     // CRITICAL: Ensure we're in a clean state before starting
     // The caller should have called stopPlayback() first for different songs
     // But double-check here as a safety measure
-    if (player.isActive()) {
-        Serial.println("   ⚠️ Player still active, stopping first");
-        player.stop();
-        delay(100);
+    xSemaphoreTake(playerMutex, portMAX_DELAY);
+    if (playing->isOpen()) {
+        Serial.println("   ⚠️ Track still open, closing first");
     }
+    closeTracks();
     
     // Reset buffer to ensure clean start
     buffer.reset();
     
+    #if AUDIO_GAPLESS
+    splicesHandled = tracksSpliced;
+    #endif
+    
     Serial.println("   Opening file...");
-    if (!player.setPath(song.path.c_str())) {
+    xSemaphoreTake(sdMutex, portMAX_DELAY);
+    bool opened = playing->open(song.path.c_str());
+    xSemaphoreGive(sdMutex);
+    if (!opened) {
+        xSemaphoreGive(playerMutex);
         Serial.printf("❌ Could not open file: %s\n", song.path.c_str());
         currentTitle = "Error: Cannot open";
-        displayNeedsUpdate = true;
+        currentSongId = -1;
+        requestDisplayUpdate(DISPLAY_DIRTY_NOW_PLAYING);
         autoNext();
         return;
     }
     
     Serial.println("   Starting playback...");
-    player.play();
+    playing->setReplayGain(replayGainFor(song.gain));
+    volume.setTrackGain(playing->getReplayGain());
+    playing->setOutput(volume);
+    xSemaphoreGive(playerMutex);
     player_state = STATE_PLAYING;
+    wakeDecodeTask();
     
     Serial.println("✅ Playback started");
     
@@ -394,6 +745,6 @@ void playCurrentSong(bool updateDisplay)
     }
     
     if (updateDisplay) {
-        displayNeedsUpdate = true;
+        requestDisplayUpdate(DISPLAY_DIRTY_PLAYBACK);
     }
 }
@@ -151,7 +151,7 @@ void updateBattery() {
     batteryCharging = isBatteryCharging();
     
     // Trigger display update for battery status - NEW
-    displayNeedsUpdate = true;
+    requestDisplayUpdate(DISPLAY_DIRTY_HEADER);
     
     #ifdef DEBUG
     Serial.printf("🔋 Battery: %.2fV (%d%%) Rate: %.4fV/s", 
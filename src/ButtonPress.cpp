@@ -0,0 +1,69 @@
+#include "ButtonPress.h"
+
+void buttonPressReset(ButtonPress& button, uint32_t minHoldMs, uint32_t debounceMs)
+{
+  button.minHoldMs = minHoldMs;
+  button.debounceMs = debounceMs;
+  button.downMs = 0;
+  button.lastPressMs = 0;
+  button.down = false;
+  button.accepted = false;
+  button.pending = 0;
+}
+
+static void accept(ButtonPress& button)
+{
+  button.accepted = true;
+
+  if (button.downMs - button.lastPressMs > button.debounceMs) {
+    button.lastPressMs = button.downMs;
+    if (button.pending < 255) {
+      button.pending++;
+    }
+  }
+}
+
+bool buttonPressEdge(ButtonPress& button, bool down, uint32_t timeMs)
+{
+  if (down) {
+    // Down while already down means the release edge was missed; this
+    // is a new press either way
+    button.down = true;
+    button.downMs = timeMs;
+    button.accepted = false;
+    if (button.minHoldMs == 0) {
+      accept(button);
+    }
+    return false;
+  }
+
+  if (!button.down) {
+    return false;
+  }
+  button.down = false;
+
+  if (button.accepted) {
+    return false;
+  }
+  if (timeMs - button.downMs >= button.minHoldMs) {
+    accept(button);
+    return false;
+  }
+  return true;
+}
+
+void buttonPressPoll(ButtonPress& button, uint32_t nowMs)
+{
+  if (button.down && !button.accepted && nowMs - button.downMs >= button.minHoldMs) {
+    accept(button);
+  }
+}
+
+bool buttonPressTake(ButtonPress& button)
+{
+  if (button.pending == 0) {
+    return false;
+  }
+  button.pending--;
+  return true;
+}
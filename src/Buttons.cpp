@@ -2,6 +2,8 @@
 #include "Navigation.h"
 #include "Haptics.h"
 #include "EncoderModule.h"
+#include "InputQueue.h"
+#include "ButtonPress.h"
 
 // Button pin definitions
 #define BTN_CENTER 4
@@ -10,37 +12,52 @@
 #define BTN_BOTTOM 34   // NEW - Play/Pause
 #define BTN_RIGHT 36    // NEW - Next
 
-// Track button states
-volatile bool btnPressed[5] = { false, false, false, false, false };
-unsigned long lastPressTime[5] = { 0, 0, 0, 0, 0 };
-unsigned long pressStartTime[5] = { 0, 0, 0, 0, 0 };
-const unsigned long debounceDelay = 300;
-const unsigned long minPressDurationADC = 10;  // For ADC pins (GPIO34/36/37/39)
-
 // Button indices
 #define BTN_IDX_CENTER 0
 #define BTN_IDX_LEFT 1
 #define BTN_IDX_TOP 2
 #define BTN_IDX_BOTTOM 3
 #define BTN_IDX_RIGHT 4
+#define BTN_COUNT 5
 
-void IRAM_ATTR handleInterrupt(int index) {
-  unsigned long now = millis();
-  
-  if (now - lastPressTime[index] > debounceDelay) {
-    pressStartTime[index] = now;
-    btnPressed[index] = true;
-    lastPressTime[index] = now;
+const unsigned long debounceDelay = 300;
+const unsigned long minPressDurationADC = 10;  // For ADC pins (GPIO34/36/37/39)
+
+// Presses are validated from the ISR edge timestamps and counted, so a
+// short press that is released before loop() drains it still counts
+static ButtonPress buttons[BTN_COUNT];
+
+static const char* const buttonNames[BTN_COUNT] = { "Center", "Left", "Top", "Bottom", "Right" };
+static const char* const buttonActions[BTN_COUNT] = { "", " (Previous)", " (Menu/Back)", " (Play/Pause)", " (Next)" };
+
+// Both edges, with the level read right away so bounces resolve in order
+void IRAM_ATTR handleInterrupt(int index, uint8_t pin) {
+  postInputEvent(digitalRead(pin) == LOW ? INPUT_BUTTON : INPUT_BUTTON_UP, index);
+}
+
+// Feed a queued edge, with its ISR timestamp, to the press filter
+void queueButtonEdge(int index, bool down, uint32_t timeMs) {
+  if (index < 0 || index >= BTN_COUNT) return;
+
+  if (buttonPressEdge(buttons[index], down, timeMs)) {
+    Serial.printf("⚠️ %s button glitch filtered\n", buttonNames[index]);
   }
 }
 
-void IRAM_ATTR onCenterButton() { handleInterrupt(BTN_IDX_CENTER); }
-void IRAM_ATTR onLeftButton() { handleInterrupt(BTN_IDX_LEFT); }
-void IRAM_ATTR onTopButton() { handleInterrupt(BTN_IDX_TOP); }
-void IRAM_ATTR onBottomButton() { handleInterrupt(BTN_IDX_BOTTOM); }
-void IRAM_ATTR onRightButton() { handleInterrupt(BTN_IDX_RIGHT); }
+void IRAM_ATTR onCenterButton() { handleInterrupt(BTN_IDX_CENTER, BTN_CENTER); }
+void IRAM_ATTR onLeftButton() { handleInterrupt(BTN_IDX_LEFT, BTN_LEFT); }
+void IRAM_ATTR onTopButton() { handleInterrupt(BTN_IDX_TOP, BTN_TOP); }
+void IRAM_ATTR onBottomButton() { handleInterrupt(BTN_IDX_BOTTOM, BTN_BOTTOM); }
+void IRAM_ATTR onRightButton() { handleInterrupt(BTN_IDX_RIGHT, BTN_RIGHT); }
 
 void initButtons() {
+  // CENTER has an internal pull-up and no glitch filter, it counts on
+  // the down edge. The ADC pins must stay low for minPressDurationADC.
+  buttonPressReset(buttons[BTN_IDX_CENTER], 0, debounceDelay);
+  for (int i = BTN_IDX_LEFT; i < BTN_COUNT; i++) {
+    buttonPressReset(buttons[i], minPressDurationADC, debounceDelay);
+  }
+
   // Center button - has internal pull-up
   pinMode(BTN_CENTER, INPUT_PULLUP);
   
@@ -51,11 +68,11 @@ void initButtons() {
   pinMode(BTN_RIGHT, INPUT);
 
   // Attach interrupts
-  attachInterrupt(digitalPinToInterrupt(BTN_CENTER), onCenterButton, FALLING);
-  attachInterrupt(digitalPinToInterrupt(BTN_LEFT), onLeftButton, FALLING);
-  attachInterrupt(digitalPinToInterrupt(BTN_TOP), onTopButton, FALLING);
-  attachInterrupt(digitalPinToInterrupt(BTN_BOTTOM), onBottomButton, FALLING);
-  attachInterrupt(digitalPinToInterrupt(BTN_RIGHT), onRightButton, FALLING);
+  attachInterrupt(digitalPinToInterrupt(BTN_CENTER), onCenterButton, CHANGE);
+  attachInterrupt(digitalPinToInterrupt(BTN_LEFT), onLeftButton, CHANGE);
+  attachInterrupt(digitalPinToInterrupt(BTN_TOP), onTopButton, CHANGE);
+  attachInterrupt(digitalPinToInterrupt(BTN_BOTTOM), onBottomButton, CHANGE);
+  attachInterrupt(digitalPinToInterrupt(BTN_RIGHT), onRightButton, CHANGE);
   
   Serial.println("✅ Buttons initialized");
   Serial.println("   Center: GPIO4 (internal pull-up)");
@@ -67,105 +84,24 @@ void initButtons() {
 
 void pollButtons() {
   bool scrolling = isEncoderScrolling();
-  
-  // CENTER button - NO FILTERING, immediate response (has internal pull-up)
-  if (btnPressed[BTN_IDX_CENTER]) {
-    btnPressed[BTN_IDX_CENTER] = false;
-    
-    if (scrolling) {
-      Serial.println("🔇 Center button suppressed (scrolling)");
-    } else {
-      Serial.println("🔘 Center button pressed");
-      hapticButtonPress();
-      handleButtonPress(0);  // Keep existing index for handleCenter()
-    }
-  }
-  
-  // LEFT button - Previous track (WITH FILTERING - ADC pin)
-  if (btnPressed[BTN_IDX_LEFT]) {
-    if (digitalRead(BTN_LEFT) == LOW) {
-      unsigned long pressDuration = millis() - pressStartTime[BTN_IDX_LEFT];
-      
-      if (pressDuration >= minPressDurationADC) {
-        btnPressed[BTN_IDX_LEFT] = false;
-        
-        if (scrolling) {
-          Serial.println("🔇 Left button suppressed (scrolling)");
-        } else {
-          Serial.println("🔘 Left button pressed (Previous)");
-          hapticButtonPress();
-          handleButtonPress(1);  // Previous track
-        }
-      }
-    } else {
-      btnPressed[BTN_IDX_LEFT] = false;
-      Serial.println("⚠️ Left button glitch filtered");
-    }
-  }
-  
-  // TOP button - Menu/Back (WITH FILTERING - ADC pin)
-  if (btnPressed[BTN_IDX_TOP]) {
-    if (digitalRead(BTN_TOP) == LOW) {
-      unsigned long pressDuration = millis() - pressStartTime[BTN_IDX_TOP];
-      
-      if (pressDuration >= minPressDurationADC) {
-        btnPressed[BTN_IDX_TOP] = false;
-        
-        if (scrolling) {
-          Serial.println("🔇 Top button suppressed (scrolling)");
-        } else {
-          Serial.println("🔘 Top button pressed (Menu/Back)");
-          hapticBack();
-          handleButtonPress(2);  // Menu/Back
-        }
-      }
-    } else {
-      btnPressed[BTN_IDX_TOP] = false;
-      Serial.println("⚠️ Top button glitch filtered");
-    }
-  }
-  
-  // BOTTOM button - Play/Pause (WITH FILTERING - ADC pin)
-  if (btnPressed[BTN_IDX_BOTTOM]) {
-    if (digitalRead(BTN_BOTTOM) == LOW) {
-      unsigned long pressDuration = millis() - pressStartTime[BTN_IDX_BOTTOM];
-      
-      if (pressDuration >= minPressDurationADC) {
-        btnPressed[BTN_IDX_BOTTOM] = false;
-        
-        if (scrolling) {
-          Serial.println("🔇 Bottom button suppressed (scrolling)");
-        } else {
-          Serial.println("🔘 Bottom button pressed (Play/Pause)");
-          hapticButtonPress();
-          handleButtonPress(3);  // Play/Pause
-        }
+  uint32_t now = millis();
+
+  for (int i = 0; i < BTN_COUNT; i++) {
+    buttonPressPoll(buttons[i], now);
+
+    while (buttonPressTake(buttons[i])) {
+      if (scrolling) {
+        Serial.printf("🔇 %s button suppressed (scrolling)\n", buttonNames[i]);
+        continue;
       }
-    } else {
-      btnPressed[BTN_IDX_BOTTOM] = false;
-      Serial.println("⚠️ Bottom button glitch filtered");
-    }
-  }
-  
-  // RIGHT button - Next track (WITH FILTERING - ADC pin)
-  if (btnPressed[BTN_IDX_RIGHT]) {
-    if (digitalRead(BTN_RIGHT) == LOW) {
-      unsigned long pressDuration = millis() - pressStartTime[BTN_IDX_RIGHT];
-      
-      if (pressDuration >= minPressDurationADC) {
-        btnPressed[BTN_IDX_RIGHT] = false;
-        
-        if (scrolling) {
-          Serial.println("🔇 Right button suppressed (scrolling)");
-        } else {
-          Serial.println("🔘 Right button pressed (Next)");
-          hapticButtonPress();
-          handleButtonPress(4);  // Next track
-        }
+
+      Serial.printf("🔘 %s button pressed%s\n", buttonNames[i], buttonActions[i]);
+      if (i == BTN_IDX_TOP) {
+        hapticBack();
+      } else {
+        hapticButtonPress();
       }
-    } else {
-      btnPressed[BTN_IDX_RIGHT] = false;
-      Serial.println("⚠️ Right button glitch filtered");
+      handleButtonPress(i);
     }
   }
-}
\ No newline at end of file
+}
@@ -0,0 +1,191 @@
+#include "Crossfade.h"
+#include "GainStage.h"
+#include <math.h>
+
+#define STAGE_FRAMES (CROSSFADE_STAGE_BYTES / 4)
+#define MIX_BLOCK_FRAMES 256
+
+static int16_t fadeTable[CROSSFADE_TABLE_SIZE + 1];
+
+static inline int16_t saturate16(int32_t v) {
+    return v > 32767 ? 32767 : (v < -32768 ? -32768 : v);
+}
+
+Crossfader::Crossfader() : output(NULL), phase(0), step(0), droppedFrames(0) {
+    for (int i = 0; i < 2; i++) {
+        trackGains[i] = GAIN_UNITY;
+        sides[i].frames = NULL;
+        sides[i].count = 0;
+        sides[i].dropped = 0;
+        sides[i].ended = false;
+    }
+}
+
+Crossfader::~Crossfader() {
+    free(sides[0].frames);
+    free(sides[1].frames);
+}
+
+bool Crossfader::begin() {
+    for (int i = 0; i < 2; i++) {
+        if (sides[i].frames == NULL) {
+            sides[i].frames = (int16_t*)ps_malloc(CROSSFADE_STAGE_BYTES);
+        }
+        if (sides[i].frames == NULL) {
+            Serial.println("❌ Crossfade buffers unavailable");
+            return false;
+        }
+    }
+
+    // sin(0..pi/2); the outgoing gain reads the table backwards
+    for (int i = 0; i <= CROSSFADE_TABLE_SIZE; i++) {
+        fadeTable[i] = (int16_t)lroundf(32767.0f * sinf(i * (float)M_PI / (2 * CROSSFADE_TABLE_SIZE)));
+    }
+    return true;
+}
+
+void Crossfader::start(Print& out, uint32_t frames, int32_t outGain, int32_t inGain) {
+    for (int i = 0; i < 2; i++) {
+        sides[i].count = 0;
+        sides[i].dropped = 0;
+        sides[i].ended = false;
+    }
+    output = &out;
+    trackGains[CROSSFADE_OUT] = constrain(outGain, 0, GAIN_MAX);
+    trackGains[CROSSFADE_IN] = constrain(inGain, 0, GAIN_MAX);
+    phase = 0;
+    step = frames > 0 ? ((uint32_t)CROSSFADE_TABLE_SIZE << 16) / frames : (uint32_t)CROSSFADE_TABLE_SIZE << 16;
+    if (step == 0) {
+        step = 1;
+    }
+}
+
+// Whatever is still staged goes out, the ramp carrying on where it was
+void Crossfader::finish() {
+    if (output != NULL) {
+        sides[CROSSFADE_OUT].ended = true;
+        sides[CROSSFADE_IN].ended = true;
+        pump();
+    }
+    reset();
+}
+
+void Crossfader::reset() {
+    if (output != NULL) {
+        droppedFrames += sides[0].dropped + sides[1].dropped;
+    }
+    for (int i = 0; i < 2; i++) {
+        sides[i].count = 0;
+        sides[i].dropped = 0;
+    }
+    output = NULL;
+}
+
+CrossfadeSide Crossfader::next() const {
+    const Side& out = sides[CROSSFADE_OUT];
+    const Side& in = sides[CROSSFADE_IN];
+    if (out.ended) return CROSSFADE_IN;
+    if (in.ended) return CROSSFADE_OUT;
+    return out.count <= in.count ? CROSSFADE_OUT : CROSSFADE_IN;
+}
+
+// Q15 gain at table position `at` (16.16), clamped at the end
+int32_t Crossfader::gain(uint32_t at) const {
+    uint32_t index = at >> 16;
+    if (index >= CROSSFADE_TABLE_SIZE) {
+        return fadeTable[CROSSFADE_TABLE_SIZE];
+    }
+    int32_t a = fadeTable[index];
+    int32_t b = fadeTable[index + 1];
+    return a + (((b - a) * (int32_t)(at & 0xFFFF)) >> 16);
+}
+
+void Crossfader::pump() {
+    if (output == NULL) {
+        return;
+    }
+
+    const Side& out = sides[CROSSFADE_OUT];
+    const Side& in = sides[CROSSFADE_IN];
+
+    // Live sides limit the mix; an ended side has nothing more coming
+    uint32_t frames;
+    if (!out.ended && !in.ended) {
+        frames = min(out.count, in.count);
+    } else if (!out.ended) {
+        frames = out.count;
+    } else if (!in.ended) {
+        frames = in.count;
+    } else {
+        frames = max(out.count, in.count);
+    }
+
+    if (frames > 0) {
+        mix(frames);
+    }
+}
+
+void Crossfader::mix(uint32_t frames) {
+    int16_t block[MIX_BLOCK_FRAMES * 2];
+    Side& out = sides[CROSSFADE_OUT];
+    Side& in = sides[CROSSFADE_IN];
+    const uint32_t end = (uint32_t)CROSSFADE_TABLE_SIZE << 16;
+
+    for (uint32_t done = 0; done < frames; ) {
+        uint32_t n = min((uint32_t)MIX_BLOCK_FRAMES, frames - done);
+
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t f = done + i;
+            int32_t gainIn = (gain(phase) * trackGains[CROSSFADE_IN]) >> 15;
+            int32_t gainOut = (gain(end - min(phase, end)) * trackGains[CROSSFADE_OUT]) >> 15;
+            int32_t l = 0;
+            int32_t r = 0;
+
+            // Each side shifted on its own: a boosted side alone can use
+            // the whole 32-bit range
+            if (f < out.count) {
+                l += (out.frames[2 * f] * gainOut) >> 15;
+                r += (out.frames[2 * f + 1] * gainOut) >> 15;
+            }
+            if (f < in.count) {
+                l += (in.frames[2 * f] * gainIn) >> 15;
+                r += (in.frames[2 * f + 1] * gainIn) >> 15;
+            }
+
+            block[2 * i] = saturate16(l);
+            block[2 * i + 1] = saturate16(r);
+            if (phase < end) {
+                phase += step;
+            }
+        }
+
+        output->write((const uint8_t*)block, n * 4);
+        done += n;
+    }
+
+    // Keep the unmixed tail at the front of each stage
+    for (int s = 0; s < 2; s++) {
+        Side& side = sides[s];
+        uint32_t used = min(frames, side.count);
+        side.count -= used;
+        if (side.count > 0) {
+            memmove(side.frames, side.frames + 2 * used, side.count * 4);
+        }
+    }
+}
+
+size_t Crossfader::Side::write(uint8_t b) {
+    return 1;  // Helix only writes whole frames
+}
+
+size_t Crossfader::Side::write(const uint8_t* data, size_t len) {
+    uint32_t n = len / 4;
+    uint32_t room = STAGE_FRAMES - count;
+    if (n > room) {
+        dropped += n - room;
+        n = room;
+    }
+    memcpy(frames + 2 * count, data, n * 4);
+    count += n;
+    return len;
+}
@@ -1,32 +1,155 @@
 #include "Database.h"
 #include "State.h"
+#include "SdLoader.h"
+#include "SdVfs.h"
 #include <SdFat.h>
+#include <algorithm>
 
 extern SdFat32 sd;
 
 MusicDatabase musicDB;
 
-MusicDatabase::MusicDatabase() : db(nullptr), isOpen(false) {}
+// Term rows a search ranks at most. Short prefixes can match most of the
+// library; the scan is in term order, so whole-word matches come first.
+#define SEARCH_CANDIDATES 256
 
-MusicDatabase::~MusicDatabase() {
-    close();
+// SQL for each cached statement, indexed by QueryId.
+// Paged lists use keyset pagination: AFTER/BEFORE bind the sort key of the
+// window's edge row so a page is an index range scan, not an OFFSET walk.
+static const char* const QUERY_SQL[QUERY_COUNT] = {
+    // QUERY_ARTISTS_AT (?1 limit, ?2 offset)
+    "SELECT id, name, display_name FROM artists "
+    "ORDER BY name COLLATE NOCASE, id LIMIT ?1 OFFSET ?2",
+    
+    // QUERY_ARTISTS_AFTER (?1 name, ?2 id, ?3 limit)
+    "SELECT id, name, display_name FROM artists "
+    "WHERE name COLLATE NOCASE >= ?1 AND (name COLLATE NOCASE > ?1 OR id > ?2) "
+    "ORDER BY name COLLATE NOCASE, id LIMIT ?3",
+    
+    // QUERY_ARTISTS_BEFORE (?1 name, ?2 id, ?3 limit) - returned in reverse
+    "SELECT id, name, display_name FROM artists "
+    "WHERE name COLLATE NOCASE <= ?1 AND (name COLLATE NOCASE < ?1 OR id < ?2) "
+    "ORDER BY name COLLATE NOCASE DESC, id DESC LIMIT ?3",
+    
+    // QUERY_ALBUMS_AT (?1 artist id, ?2 limit, ?3 offset)
+    "SELECT id, artist_id, name, year, display_name FROM albums "
+    "WHERE artist_id = ?1 "
+    "ORDER BY ifnull(year, 0), name COLLATE NOCASE, id LIMIT ?2 OFFSET ?3",
+    
+    // QUERY_ALBUMS_AFTER (?1 artist id, ?2 year, ?3 name, ?4 id, ?5 limit)
+    "SELECT id, artist_id, name, year, display_name FROM albums "
+    "WHERE artist_id = ?1 AND (ifnull(year, 0), name COLLATE NOCASE, id) > (?2, ?3, ?4) "
+    "ORDER BY ifnull(year, 0), name COLLATE NOCASE, id LIMIT ?5",
+    
+    // QUERY_ALBUMS_BEFORE (?1 artist id, ?2 year, ?3 name, ?4 id, ?5 limit) - returned in reverse
+    "SELECT id, artist_id, name, year, display_name FROM albums "
+    "WHERE artist_id = ?1 AND (ifnull(year, 0), name COLLATE NOCASE, id) < (?2, ?3, ?4) "
+    "ORDER BY ifnull(year, 0) DESC, name COLLATE NOCASE DESC, id DESC LIMIT ?5",
+    
+    // QUERY_SONGS_AT (?1 album id, ?2 limit, ?3 offset)
+    "SELECT id, album_id, title, path, track_number, duration, display_name, "
+    "track_gain, album_gain FROM songs "
+    "WHERE album_id = ?1 "
+    "ORDER BY ifnull(track_number, 0), id LIMIT ?2 OFFSET ?3",
+    
+    // QUERY_SONGS_AFTER (?1 album id, ?2 track, ?3 id, ?4 limit)
+    "SELECT id, album_id, title, path, track_number, duration, display_name, "
+    "track_gain, album_gain FROM songs "
+    "WHERE album_id = ?1 AND (ifnull(track_number, 0), id) > (?2, ?3) "
+    "ORDER BY ifnull(track_number, 0), id LIMIT ?4",
+    
+    // QUERY_SONGS_BEFORE (?1 album id, ?2 track, ?3 id, ?4 limit) - returned in reverse
+    "SELECT id, album_id, title, path, track_number, duration, display_name, "
+    "track_gain, album_gain FROM songs "
+    "WHERE album_id = ?1 AND (ifnull(track_number, 0), id) < (?2, ?3) "
+    "ORDER BY ifnull(track_number, 0) DESC, id DESC LIMIT ?4",
+    
+    // QUERY_ALBUM_COUNT_BY_ARTIST (?1 artist id)
+    "SELECT COUNT(*) FROM albums WHERE artist_id = ?1",
+    
+    // QUERY_SONG_COUNT_BY_ALBUM (?1 album id)
+    "SELECT COUNT(*) FROM songs WHERE album_id = ?1",
+    
+    // QUERY_SONG_COUNT
+    "SELECT COUNT(*) FROM songs",
+    
+    // QUERY_ARTIST_COUNT
+    "SELECT COUNT(*) FROM artists",
+    
+    // QUERY_ALBUM_COUNT
+    "SELECT COUNT(*) FROM albums",
+    
+    // QUERY_SEARCH (?1 lowercase prefix, ?2 first string past it, ?3 limit, ?4 candidates)
+    // A bounded range scan of the search_terms key (built by the indexer
+    // tool), then only those candidates are ranked
+    "SELECT i.kind, i.ref_id, i.artist_id, ifnull(i.album_id, -1), i.name, i.display_name "
+    "FROM (SELECT item_id, position FROM search_terms "
+    "WHERE term >= ?1 AND term < ?2 LIMIT ?4) t "
+    "JOIN search_items i ON i.id = t.item_id "
+    "GROUP BY i.id "
+    "ORDER BY MIN(t.position), i.kind, length(i.name), i.name COLLATE NOCASE LIMIT ?3",
+    
+    // QUERY_LOCATE (?1 artist id, ?2 album id or -1, ?3 song id or -1)
+    // Rows ahead of each item in the same order the list queries use
+    "SELECT "
+    "(SELECT COUNT(*) FROM artists a WHERE (a.name COLLATE NOCASE, a.id) < (ar.name, ar.id)), "
+    "(SELECT COUNT(*) FROM albums b WHERE b.artist_id = ar.id "
+    "AND (ifnull(b.year, 0), b.name COLLATE NOCASE, b.id) < (ifnull(al.year, 0), al.name, al.id)), "
+    "(SELECT COUNT(*) FROM songs t WHERE t.album_id = s.album_id "
+    "AND (ifnull(t.track_number, 0), t.id) < (ifnull(s.track_number, 0), s.id)) "
+    "FROM artists ar "
+    "LEFT JOIN albums al ON al.id = ?2 AND al.artist_id = ar.id "
+    "LEFT JOIN songs s ON s.id = ?3 AND s.album_id = al.id "
+    "WHERE ar.id = ?1",
+    
+    // QUERY_ARTIST_JUMPS
+    "SELECT row, letter FROM artist_jumps ORDER BY row"
+};
+
+static const char* const QUERY_NAMES[QUERY_COUNT] = {
+    "artists at",
+    "artists after",
+    "artists before",
+    "albums at",
+    "albums after",
+    "albums before",
+    "songs at",
+    "songs after",
+    "songs before",
+    "albums of artist",
+    "songs of album",
+    "song count",
+    "artist count",
+    "album count",
+    "search",
+    "locate",
+    "artist jumps"
+};
+
+// Text column or "" for NULL
+static const char* columnText(sqlite3_stmt* stmt, int col) {
+    const char* text = (const char*)sqlite3_column_text(stmt, col);
+    return text ? text : "";
 }
 
-// Helper function to truncate long strings - UPDATED
-std::string truncateString(const std::string& str, size_t maxLen) {
-    if (str.length() <= maxLen) {
-        return str;
-    }
-    
-    // Leave room for "..."
-    if (maxLen <= 3) {
-        return "...";
+// BEFORE pages are selected in descending order; flip the rows just added
+template <typename T>
+static void restoreListOrder(PageDirection dir, std::vector<T>& out, size_t firstRow) {
+    if (dir == PAGE_BEFORE) {
+        std::reverse(out.begin() + firstRow, out.end());
     }
-    
-    return str.substr(0, maxLen - 3) + "...";
 }
 
-bool MusicDatabase::openFromMemory(const char* sdPath) {
+MusicDatabase::MusicDatabase() : db(nullptr), isOpen(false), pagedFromSd(false), queryMutex(NULL) {
+    memset(statements, 0, sizeof(statements));
+    memset(stats, 0, sizeof(stats));
+}
+
+MusicDatabase::~MusicDatabase() {
+    close();
+}
+
+bool MusicDatabase::openFromMemory(const char* sdPath, LoadProgressCallback progress) {
     Serial.printf("📂 Loading database from SD to PSRAM: %s\n", sdPath);
     
     if (!sd.exists(sdPath)) {
@@ -34,61 +157,12 @@ bool MusicDatabase::openFromMemory(const char* sdPath) {
         return false;
     }
     
-    // Open source file
-    File32 srcFile = sd.open(sdPath, O_RDONLY);
-    if (!srcFile) {
-        Serial.println("❌ Cannot open database file");
-        return false;
-    }
-    
-    size_t fileSize = srcFile.size();
-    Serial.printf("   File size: %lu bytes (%.1f KB)\n", fileSize, fileSize / 1024.0);
-    
-    // Check PSRAM availability
-    size_t freePSRAM = ESP.getFreePsram();
-    Serial.printf("   Free PSRAM: %lu bytes (%.1f KB)\n", freePSRAM, freePSRAM / 1024.0);
-    
-    if (fileSize > freePSRAM - 100000) {  // Keep 100KB buffer
-        Serial.println("❌ Not enough PSRAM");
-        srcFile.close();
-        return false;
-    }
-    
-    // Allocate buffer in PSRAM
-    uint8_t* dbBuffer = (uint8_t*)ps_malloc(fileSize);
+    size_t fileSize = 0;
+    uint8_t* dbBuffer = loadFileToPsram(sdPath, fileSize, progress);
     if (!dbBuffer) {
-        Serial.println("❌ Failed to allocate PSRAM");
-        srcFile.close();
         return false;
     }
-    
-    Serial.println("   📥 Reading database into PSRAM...");
-    
-    // Read in chunks to show progress
-    size_t bytesRead = 0;
-    size_t chunkSize = 8192;
-    
-    while (bytesRead < fileSize) {
-        size_t toRead = min(chunkSize, fileSize - bytesRead);
-        size_t read = srcFile.read(dbBuffer + bytesRead, toRead);
-        
-        if (read == 0) {
-            Serial.println("❌ Read error");
-            free(dbBuffer);
-            srcFile.close();
-            return false;
-        }
-        
-        bytesRead += read;
-        
-        if (bytesRead % 102400 == 0) {  // Progress every ~100KB
-            Serial.printf("      %lu / %lu bytes (%.0f%%)\n", 
-                         bytesRead, fileSize, (bytesRead * 100.0) / fileSize);
-        }
-    }
-    
-    srcFile.close();
-    Serial.printf("   ✅ Database loaded (%lu bytes)\n", bytesRead);
+    Serial.printf("   ✅ Database loaded (%lu bytes)\n", fileSize);
     
     // Open in-memory database
     int rc = sqlite3_open(":memory:", &db);
@@ -118,217 +192,472 @@ bool MusicDatabase::openFromMemory(const char* sdPath) {
         return false;
     }
     
+    // Sorter spills and temp indexes stay in RAM; there is no temp
+    // directory on the card to put them in
+    sqlite3_exec(db, "PRAGMA temp_store = MEMORY", NULL, NULL, NULL);
+    
+    // Prepare every query once; they are reset and rebound on each call
+    if (!prepareStatements()) {
+        sqlite3_close(db);
+        db = nullptr;
+        return false;
+    }
+    
     isOpen = true;
+    pagedFromSd = false;
     Serial.println("✅ Database opened from PSRAM");
     
     // Test query
-    sqlite3_stmt* stmt;
-    rc = sqlite3_prepare_v2(db, "SELECT COUNT(*) FROM artists", -1, &stmt, nullptr);
-    if (rc == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            int count = sqlite3_column_int(stmt, 0);
-            Serial.printf("   🎵 %d artists found\n", count);
+    Serial.printf("   🎵 %d artists found\n", getArtistCount());
+    
+    return true;
+}
+
+bool MusicDatabase::openFromSd(const char* sdPath) {
+    Serial.printf("📂 Opening database on SD (paged): %s\n", sdPath);
+    
+    if (!sdVfsRegister()) {
+        Serial.println("❌ Cannot register SD VFS");
+        return false;
+    }
+    
+    int rc = sqlite3_open_v2(sdPath, &db, SQLITE_OPEN_READONLY, SD_VFS_NAME);
+    if (rc != SQLITE_OK) {
+        Serial.printf("❌ Cannot open database: %s\n", sqlite3_errmsg(db));
+        sqlite3_close(db);
+        db = nullptr;
+        return false;
+    }
+    
+    // The VFS page cache is the bounded cache; keep SQLite's own one small
+    sqlite3_exec(db, "PRAGMA cache_size = -64", NULL, NULL, NULL);
+    
+    // The VFS opens no temp files, so anything SQLite would spill to one
+    // (large sorts, temp indexes) has to stay in memory
+    sqlite3_exec(db, "PRAGMA temp_store = MEMORY", NULL, NULL, NULL);
+    
+    if (!prepareStatements()) {
+        sqlite3_close(db);
+        db = nullptr;
+        return false;
+    }
+    
+    sdVfsResetStats();
+    isOpen = true;
+    pagedFromSd = true;
+    Serial.printf("✅ Database opened from SD (%d KB page cache)\n",
+                  SD_VFS_CACHE_PAGES * SD_VFS_PAGE_SIZE / 1024);
+    
+    // Test query
+    Serial.printf("   🎵 %d artists found\n", getArtistCount());
+    
+    return true;
+}
+
+bool MusicDatabase::prepareStatements() {
+    if (queryMutex == NULL) {
+        queryMutex = xSemaphoreCreateMutex();
+    }
+    
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        int rc = sqlite3_prepare_v3(db, QUERY_SQL[i], -1, SQLITE_PREPARE_PERSISTENT,
+                                    &statements[i], nullptr);
+        
+        if (rc != SQLITE_OK) {
+            Serial.printf("❌ Cannot prepare %s query: %s\n", QUERY_NAMES[i], sqlite3_errmsg(db));
+            Serial.println("   Database may predate this firmware; re-run the indexer tool");
+            finalizeStatements();
+            return false;
         }
-        sqlite3_finalize(stmt);
-    } else {
-        Serial.printf("⚠️  Test query failed: %s\n", sqlite3_errmsg(db));
     }
     
+    resetQueryStats();
+    Serial.printf("   ⚡ Prepared %d cached statements\n", QUERY_COUNT);
     return true;
 }
 
-bool MusicDatabase::open(const char* path) {
-    return openFromMemory(path);
+void MusicDatabase::finalizeStatements() {
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        if (statements[i]) {
+            sqlite3_finalize(statements[i]);
+            statements[i] = nullptr;
+        }
+    }
+}
+
+// Hand out a cached statement ready for binding and start its timer
+// Holds queryMutex until the matching endQuery()
+sqlite3_stmt* MusicDatabase::beginQuery(QueryId id, unsigned long& startMicros) {
+    xSemaphoreTake(queryMutex, portMAX_DELAY);
+    startMicros = micros();
+    
+    sqlite3_stmt* stmt = statements[id];
+    if (stmt) {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    }
+    return stmt;
+}
+
+// Release a cached statement (keeps it prepared) and record its timing
+void MusicDatabase::endQuery(QueryId id, unsigned long startMicros) {
+    if (statements[id]) {
+        sqlite3_reset(statements[id]);
+    }
+    
+    uint32_t elapsed = micros() - startMicros;
+    QueryStats& s = stats[id];
+    s.calls++;
+    s.totalMicros += elapsed;
+    if (elapsed > s.maxMicros) {
+        s.maxMicros = elapsed;
+    }
+    
+    xSemaphoreGive(queryMutex);
+}
+
+const QueryStats& MusicDatabase::getQueryStats(QueryId id) const {
+    return stats[id];
+}
+
+void MusicDatabase::resetQueryStats() {
+    memset(stats, 0, sizeof(stats));
+}
+
+void MusicDatabase::printQueryStats() {
+    Serial.println("📊 Query timings (calls / avg us / max us):");
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        const QueryStats& s = stats[i];
+        Serial.printf("   %-18s %6lu / %8lu / %8lu\n",
+                      QUERY_NAMES[i],
+                      (unsigned long)s.calls,
+                      (unsigned long)(s.calls ? s.totalMicros / s.calls : 0),
+                      (unsigned long)s.maxMicros);
+    }
+    
+    if (pagedFromSd) {
+        sdVfsPrintStats();
+    }
+}
+
+// Copy into PSRAM when the file fits (fastest queries), otherwise page it
+// in from the card. DATABASE_LAZY_OPEN always pages, for instant startup.
+bool MusicDatabase::open(const char* path, LoadProgressCallback progress) {
+#ifdef DATABASE_LAZY_OPEN
+    return openFromSd(path);
+#else
+    File32 file = sd.open(path, O_RDONLY);
+    if (!file) {
+        Serial.println("❌ Database file not found");
+        return false;
+    }
+    size_t fileSize = file.size();
+    file.close();
+    
+    if (fileSize + SD_LOAD_PSRAM_RESERVE > ESP.getFreePsram()) {
+        Serial.println("   Database larger than free PSRAM, paging from SD");
+        return openFromSd(path);
+    }
+    return openFromMemory(path, progress);
+#endif
 }
 
 void MusicDatabase::close() {
+    finalizeStatements();
+    
     if (db) {
         sqlite3_close(db);
         db = nullptr;
         isOpen = false;
+        pagedFromSd = false;
         Serial.println("📂 Database closed");
     }
 }
 
-std::vector<std::string> MusicDatabase::getArtistNames() {
-    std::vector<std::string> result;
+int MusicDatabase::fetchArtists(PageDirection dir, const Artist* anchor, int offset, int limit,
+                                StringArena& strings, std::vector<Artist>& out) {
+    if (!isOpen || (dir != PAGE_AT_OFFSET && !anchor)) return 0;
     
-    if (!isOpen) return result;
+    QueryId id = (QueryId)(QUERY_ARTISTS_AT + dir);
+    size_t firstRow = out.size();
     
-    const char* sql = "SELECT name FROM artists ORDER BY name COLLATE NOCASE";
-    sqlite3_stmt* stmt;
+    unsigned long start;
+    sqlite3_stmt* stmt = beginQuery(id, start);
     
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+    if (stmt) {
+        if (dir == PAGE_AT_OFFSET) {
+            sqlite3_bind_int(stmt, 1, limit);
+            sqlite3_bind_int(stmt, 2, offset);
+        } else {
+            sqlite3_bind_text(stmt, 1, anchor->name.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_int(stmt, 2, anchor->id);
+            sqlite3_bind_int(stmt, 3, limit);
+        }
+        
         while (sqlite3_step(stmt) == SQLITE_ROW) {
-            const char* name = (const char*)sqlite3_column_text(stmt, 0);
+            const char* name = (const char*)sqlite3_column_text(stmt, 1);
             if (name) {
-                // Truncate to 20 characters (leaves room for arrow on right)
-                result.push_back(truncateString(name, 17));
+                Artist artist;
+                artist.id = sqlite3_column_int(stmt, 0);
+                artist.name = strings.copy(name);
+                artist.displayName = strings.copy(columnText(stmt, 2));
+                out.push_back(artist);
             }
         }
     } else {
-        Serial.printf("❌ SQL error: %s\n", sqlite3_errmsg(db));
+        Serial.println("❌ Artist query not prepared");
     }
     
-    sqlite3_finalize(stmt);
+    endQuery(id, start);
     
-    Serial.printf("📊 Loaded %d artists\n", result.size());
-    return result;
+    restoreListOrder(dir, out, firstRow);
+    return out.size() - firstRow;
 }
 
-std::vector<std::string> MusicDatabase::getAlbumNamesByArtist(const std::string& artistName) {
-    std::vector<std::string> result;
-    
-    if (!isOpen || artistName.empty()) return result;
+int MusicDatabase::fetchAlbums(int artistId, PageDirection dir, const Album* anchor, int offset, int limit,
+                               StringArena& strings, std::vector<Album>& out) {
+    if (!isOpen || artistId < 0 || (dir != PAGE_AT_OFFSET && !anchor)) return 0;
     
-    const char* sql = 
-        "SELECT albums.name FROM albums "
-        "JOIN artists ON albums.artist_id = artists.id "
-        "WHERE artists.name LIKE ? "
-        "ORDER BY albums.year, albums.name COLLATE NOCASE";
+    QueryId id = (QueryId)(QUERY_ALBUMS_AT + dir);
+    size_t firstRow = out.size();
     
-    sqlite3_stmt* stmt;
+    unsigned long start;
+    sqlite3_stmt* stmt = beginQuery(id, start);
     
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        // Use wildcard match to handle truncated artist names
-        std::string searchPattern = artistName;
-        // Remove "..." if present for search
-        if (searchPattern.length() >= 3 && 
-            searchPattern.substr(searchPattern.length() - 3) == "...") {
-            searchPattern = searchPattern.substr(0, searchPattern.length() - 3) + "%";
+    if (stmt) {
+        sqlite3_bind_int(stmt, 1, artistId);
+        
+        if (dir == PAGE_AT_OFFSET) {
+            sqlite3_bind_int(stmt, 2, limit);
+            sqlite3_bind_int(stmt, 3, offset);
         } else {
-            searchPattern = artistName;
+            sqlite3_bind_int(stmt, 2, anchor->year);
+            sqlite3_bind_text(stmt, 3, anchor->name.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_int(stmt, 4, anchor->id);
+            sqlite3_bind_int(stmt, 5, limit);
         }
         
-        sqlite3_bind_text(stmt, 1, searchPattern.c_str(), -1, SQLITE_TRANSIENT);
-        
         while (sqlite3_step(stmt) == SQLITE_ROW) {
-            const char* name = (const char*)sqlite3_column_text(stmt, 0);
+            const char* name = (const char*)sqlite3_column_text(stmt, 2);
             if (name) {
-                // Truncate to 20 characters
-                result.push_back(truncateString(name, 17));
+                Album album;
+                album.id = sqlite3_column_int(stmt, 0);
+                album.artistId = sqlite3_column_int(stmt, 1);
+                album.name = strings.copy(name);
+                album.year = sqlite3_column_int(stmt, 3);
+                album.displayName = strings.copy(columnText(stmt, 4));
+                out.push_back(album);
             }
         }
     } else {
-        Serial.printf("❌ SQL error: %s\n", sqlite3_errmsg(db));
+        Serial.println("❌ Album query not prepared");
     }
     
-    sqlite3_finalize(stmt);
+    endQuery(id, start);
     
-    Serial.printf("📊 Loaded %d albums for %s\n", result.size(), artistName.c_str());
-    return result;
+    restoreListOrder(dir, out, firstRow);
+    return out.size() - firstRow;
 }
 
-std::vector<Song> MusicDatabase::getSongsByAlbum(const std::string& artistName, const std::string& albumName) {
-    std::vector<Song> result;
+int MusicDatabase::fetchSongs(int albumId, PageDirection dir, const Song* anchor, int offset, int limit,
+                              StringArena& strings, std::vector<Song>& out) {
+    if (!isOpen || albumId < 0 || (dir != PAGE_AT_OFFSET && !anchor)) return 0;
     
-    if (!isOpen || artistName.empty() || albumName.empty()) return result;
+    QueryId id = (QueryId)(QUERY_SONGS_AT + dir);
+    size_t firstRow = out.size();
     
-    const char* sql = 
-        "SELECT songs.title, songs.path, songs.track_number, songs.duration "
-        "FROM songs "
-        "JOIN albums ON songs.album_id = albums.id "
-        "JOIN artists ON albums.artist_id = artists.id "
-        "WHERE artists.name LIKE ? AND albums.name LIKE ? "
-        "ORDER BY songs.track_number";
+    unsigned long start;
+    sqlite3_stmt* stmt = beginQuery(id, start);
     
-    sqlite3_stmt* stmt;
-    
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        // Handle truncated artist name
-        std::string artistPattern = artistName;
-        if (artistPattern.length() >= 3 && 
-            artistPattern.substr(artistPattern.length() - 3) == "...") {
-            artistPattern = artistPattern.substr(0, artistPattern.length() - 3) + "%";
-        }
+    if (stmt) {
+        sqlite3_bind_int(stmt, 1, albumId);
         
-        // Handle truncated album name
-        std::string albumPattern = albumName;
-        if (albumPattern.length() >= 3 && 
-            albumPattern.substr(albumPattern.length() - 3) == "...") {
-            albumPattern = albumPattern.substr(0, albumPattern.length() - 3) + "%";
+        if (dir == PAGE_AT_OFFSET) {
+            sqlite3_bind_int(stmt, 2, limit);
+            sqlite3_bind_int(stmt, 3, offset);
+        } else {
+            sqlite3_bind_int(stmt, 2, anchor->track);
+            sqlite3_bind_int(stmt, 3, anchor->id);
+            sqlite3_bind_int(stmt, 4, limit);
         }
         
-        sqlite3_bind_text(stmt, 1, artistPattern.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 2, albumPattern.c_str(), -1, SQLITE_TRANSIENT);
-        
         while (sqlite3_step(stmt) == SQLITE_ROW) {
             Song song;
-            const char* title = (const char*)sqlite3_column_text(stmt, 0);
-            const char* path = (const char*)sqlite3_column_text(stmt, 1);
+            const char* title = (const char*)sqlite3_column_text(stmt, 2);
+            const char* path = (const char*)sqlite3_column_text(stmt, 3);
             
-            if (title) {
-                song.title = title;  // Store FULL title
-                song.displayTitle = truncateString(title, 17);  // Truncated for list
-            }
+            song.id = sqlite3_column_int(stmt, 0);
+            song.albumId = sqlite3_column_int(stmt, 1);
             
-            if (path) {
-                song.path = path;
-            }
+            song.title = strings.copy(title);
+            song.path = strings.copy(path);
             
-            song.track = sqlite3_column_int(stmt, 2);
-            song.duration = sqlite3_column_int(stmt, 3);
+            song.track = sqlite3_column_int(stmt, 4);
+            song.duration = sqlite3_column_int(stmt, 5);
+            song.displayName = strings.copy(columnText(stmt, 6));
+            song.gain.track = lround(sqlite3_column_double(stmt, 7) * 100);
+            song.gain.album = lround(sqlite3_column_double(stmt, 8) * 100);
             
-            result.push_back(song);
+            out.push_back(song);
         }
     } else {
-        Serial.printf("❌ SQL error: %s\n", sqlite3_errmsg(db));
+        Serial.println("❌ Song query not prepared");
     }
     
-    sqlite3_finalize(stmt);
+    endQuery(id, start);
     
-    Serial.printf("📊 Loaded %d songs from %s - %s\n", 
-                  result.size(), artistName.c_str(), albumName.c_str());
-    return result;
+    restoreListOrder(dir, out, firstRow);
+    return out.size() - firstRow;
 }
 
-int MusicDatabase::getSongCount() {
-    if (!isOpen) return 0;
+// First string past every string that starts with `prefix`, in the byte
+// order SQLite's BINARY collation uses. 0xFF bytes can't be bumped, so
+// they are dropped and the carry goes into the byte before. Returns the
+// bound's length, 0 if there is none (the prefix is empty or all 0xFF).
+static size_t prefixUpperBound(const char* prefix, size_t len, char* upper) {
+    while (len > 0 && (unsigned char)prefix[len - 1] == 0xFF) {
+        len--;
+    }
+    if (len == 0) return 0;
     
-    const char* sql = "SELECT COUNT(*) FROM songs";
-    sqlite3_stmt* stmt;
-    int count = 0;
+    memcpy(upper, prefix, len);
+    upper[len - 1] = (char)((unsigned char)upper[len - 1] + 1);
+    upper[len] = '\0';
+    return len;
+}
+
+int MusicDatabase::search(const char* prefix, int limit, StringArena& strings,
+                          std::vector<SearchResult>& out) {
+    if (!isOpen || !prefix || !*prefix) return 0;
+    
+    // Terms are stored lowercase; [lower, upper) covers every term that
+    // starts with the prefix
+    char lower[SEARCH_QUERY_MAX + 1];
+    char upper[SEARCH_QUERY_MAX + 1];
+    size_t len = 0;
+    for (; prefix[len] && len < SEARCH_QUERY_MAX; len++) {
+        lower[len] = tolower((unsigned char)prefix[len]);
+    }
+    lower[len] = '\0';
+    size_t upperLen = prefixUpperBound(lower, len, upper);
+    
+    size_t firstRow = out.size();
+    
+    unsigned long start;
+    sqlite3_stmt* stmt = beginQuery(QUERY_SEARCH, start);
     
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+    if (stmt) {
+        sqlite3_bind_text(stmt, 1, lower, len, SQLITE_STATIC);
+        if (upperLen > 0) {
+            sqlite3_bind_text(stmt, 2, upper, upperLen, SQLITE_STATIC);
+        } else {
+            sqlite3_bind_zeroblob(stmt, 2, 0);  // BLOBs sort after all text: no upper bound
+        }
+        sqlite3_bind_int(stmt, 3, limit);
+        sqlite3_bind_int(stmt, 4, SEARCH_CANDIDATES);
+        
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            SearchResult result;
+            result.kind = (SearchKind)sqlite3_column_int(stmt, 0);
+            result.id = sqlite3_column_int(stmt, 1);
+            result.artistId = sqlite3_column_int(stmt, 2);
+            result.albumId = sqlite3_column_int(stmt, 3);
+            result.name = strings.copy(columnText(stmt, 4));
+            result.displayName = strings.copy(columnText(stmt, 5));
+            out.push_back(result);
+        }
+    } else {
+        Serial.println("❌ Search query not prepared");
+    }
+    
+    endQuery(QUERY_SEARCH, start);
+    
+    return out.size() - firstRow;
+}
+
+bool MusicDatabase::locate(const SearchResult& result, SearchLocation& where) {
+    if (!isOpen) return false;
+    
+    unsigned long start;
+    sqlite3_stmt* stmt = beginQuery(QUERY_LOCATE, start);
+    bool found = false;
+    
+    if (stmt) {
+        sqlite3_bind_int(stmt, 1, result.artistId);
+        sqlite3_bind_int(stmt, 2, result.kind == SEARCH_ARTIST ? -1 : result.albumId);
+        sqlite3_bind_int(stmt, 3, result.kind == SEARCH_SONG ? result.id : -1);
+        
         if (sqlite3_step(stmt) == SQLITE_ROW) {
-            count = sqlite3_column_int(stmt, 0);
+            where.artistIndex = sqlite3_column_int(stmt, 0);
+            where.albumIndex = sqlite3_column_int(stmt, 1);
+            where.songIndex = sqlite3_column_int(stmt, 2);
+            found = true;
         }
     }
     
-    sqlite3_finalize(stmt);
-    return count;
+    endQuery(QUERY_LOCATE, start);
+    return found;
 }
 
-int MusicDatabase::getArtistCount() {
+int MusicDatabase::fetchArtistJumps(std::vector<LetterJump>& out) {
     if (!isOpen) return 0;
     
-    const char* sql = "SELECT COUNT(*) FROM artists";
-    sqlite3_stmt* stmt;
-    int count = 0;
+    size_t firstRow = out.size();
     
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            count = sqlite3_column_int(stmt, 0);
+    unsigned long start;
+    sqlite3_stmt* stmt = beginQuery(QUERY_ARTIST_JUMPS, start);
+    
+    if (stmt) {
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            LetterJump jump;
+            jump.row = sqlite3_column_int(stmt, 0);
+            jump.letter = columnText(stmt, 1)[0];
+            out.push_back(jump);
         }
     }
     
-    sqlite3_finalize(stmt);
-    return count;
+    endQuery(QUERY_ARTIST_JUMPS, start);
+    
+    return out.size() - firstRow;
 }
 
-int MusicDatabase::getAlbumCount() {
+int MusicDatabase::runCountQuery(QueryId id, int parentId) {
     if (!isOpen) return 0;
     
-    const char* sql = "SELECT COUNT(*) FROM albums";
-    sqlite3_stmt* stmt;
+    unsigned long start;
+    sqlite3_stmt* stmt = beginQuery(id, start);
     int count = 0;
     
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            count = sqlite3_column_int(stmt, 0);
-        }
+    if (stmt && parentId >= 0) {
+        sqlite3_bind_int(stmt, 1, parentId);
     }
     
-    sqlite3_finalize(stmt);
+    if (stmt && sqlite3_step(stmt) == SQLITE_ROW) {
+        count = sqlite3_column_int(stmt, 0);
+    }
+    
+    endQuery(id, start);
     return count;
+}
+
+int MusicDatabase::getAlbumCountByArtist(int artistId) {
+    if (artistId < 0) return 0;
+    return runCountQuery(QUERY_ALBUM_COUNT_BY_ARTIST, artistId);
+}
+
+int MusicDatabase::getSongCountByAlbum(int albumId) {
+    if (albumId < 0) return 0;
+    return runCountQuery(QUERY_SONG_COUNT_BY_ALBUM, albumId);
+}
+
+int MusicDatabase::getSongCount() {
+    return runCountQuery(QUERY_SONG_COUNT);
+}
+
+int MusicDatabase::getArtistCount() {
+    return runCountQuery(QUERY_ARTIST_COUNT);
+}
+
+int MusicDatabase::getAlbumCount() {
+    return runCountQuery(QUERY_ALBUM_COUNT);
 }
\ No newline at end of file
@@ -1,29 +1,104 @@
 #include "Display.h"
 #include "Preferences.h"
+#include "Marquee.h"
 #include <cstring>
+#ifdef DEBUG
+#include <atomic>
+#endif
 
 // Create TFT instance using HSPI
 SPIClass hspi(HSPI);
-Adafruit_ST7789 display = Adafruit_ST7789(&hspi, TFT_CS, TFT_DC, TFT_RST);
+CountingST7789 panel(&hspi, TFT_CS, TFT_DC, TFT_RST);
+FrameBuffer display(panel, SCREEN_WIDTH, SCREEN_HEIGHT);
 
-volatile bool displayNeedsUpdate = false;
 SemaphoreHandle_t displayMutex = NULL;
+static TaskHandle_t displayTaskHandle = NULL;
 
-// Track window position for smooth scrolling
-static int lastWindowStart[4] = {0, 0, 0, 0};  // For menus and lists
-static int lastIndex[4] = {0, 0, 0, 0};
+// Selected list row and Now Playing title, when too long to fit
+static Marquee rowMarquee;
+static Marquee titleMarquee;
 
-// Import scroll direction from EncoderModule
-extern int lastScrollDirection;
+#ifdef DEBUG
+// Display task activity since the last printDisplayStats(). Updated with
+// displayMutex held, so the loop task can copy and clear it under it.
+struct DisplayStats {
+  uint32_t frames;               // Woken by a published snapshot
+  uint32_t marqueeFrames;        // Woken by the marquee frame timeout
+  uint32_t totalBytes;           // SPI bytes of snapshot frames
+  uint32_t maxBytes;
+  uint32_t totalNotifyMicros;    // wakeDisplayTask() to flush done
+  uint32_t maxNotifyMicros;
+  uint32_t totalRequestMicros;   // requestDisplayUpdate() to flush done
+  uint32_t maxRequestMicros;
+  unsigned long sinceMs;
+};
+static DisplayStats stats;
 
+// First notify not yet picked up by the display task (0: none)
+static std::atomic<uint32_t> notifyMicros(0);
+#endif
+
+// Called after a snapshot is published; bits accumulate until the next frame
+void wakeDisplayTask(uint32_t dirty) {
+  if (displayTaskHandle != NULL) {
+    #ifdef DEBUG
+    uint32_t none = 0;
+    notifyMicros.compare_exchange_strong(none, micros() | 1);
+    #endif
+    xTaskNotify(displayTaskHandle, dirty, eSetBits);
+  }
+}
+
+// Sleeps until a snapshot is published; no wakeups while nothing changes
+// except the marquee frames while a long title is scrolling
 void displayTask(void *param) {
   while(1) {
-    if (displayNeedsUpdate) {
+    uint32_t dirty = 0;
+    bool scrolling = rowMarquee.active() || titleMarquee.active();
+    TickType_t wait = scrolling ? pdMS_TO_TICKS(MARQUEE_FRAME_MS) : portMAX_DELAY;
+    
+    if (xTaskNotifyWait(0, 0xFFFFFFFF, &dirty, wait) != pdTRUE) {
+      // Marquee frame: shift the text windows, nothing else changed
       if (xSemaphoreTake(displayMutex, portMAX_DELAY)) {
-        updateDisplay();  
-        displayNeedsUpdate = false;
+        rowMarquee.tick(millis());
+        titleMarquee.tick(millis());
+        display.flush();
+        #ifdef DEBUG
+        stats.marqueeFrames++;
+        #endif
         xSemaphoreGive(displayMutex);
       }
+      continue;
+    }
+    
+    #ifdef DEBUG
+    // Notifies from here on are timed with the next frame
+    uint32_t notified = notifyMicros.exchange(0);
+    #endif
+    
+    // Only the panel is locked; UI state comes from the snapshot
+    const UiSnapshot& snapshot = acquireUiSnapshot();
+    
+    if (xSemaphoreTake(displayMutex, portMAX_DELAY)) {
+      panel.resetBytes();
+      updateDisplay(snapshot, dirty);
+      display.flush();
+      
+      #ifdef DEBUG
+      uint32_t now = micros();
+      uint32_t notifyLatency = notified ? now - notified : 0;
+      uint32_t requestLatency = snapshot.requestMicros ? now - snapshot.requestMicros : 0;
+      uint32_t sent = panel.bytesSent();
+      stats.frames++;
+      stats.totalBytes += sent;
+      stats.totalNotifyMicros += notifyLatency;
+      stats.totalRequestMicros += requestLatency;
+      if (sent > stats.maxBytes) stats.maxBytes = sent;
+      if (notifyLatency > stats.maxNotifyMicros) stats.maxNotifyMicros = notifyLatency;
+      if (requestLatency > stats.maxRequestMicros) stats.maxRequestMicros = requestLatency;
+      #endif
+      
+      xSemaphoreGive(displayMutex);
     }
     
     #ifdef DEBUG
@@ -32,11 +107,35 @@ void displayTask(void *param) {
       Serial.printf("⚠️ Display task stack low: %u bytes\n", highWater);
     }
     #endif
-    
-    vTaskDelay(50 / portTICK_PERIOD_MS);
   }
 }
 
+#ifdef DEBUG
+// Printed from the loop task, so an idle display task (no wakeups at
+// all) still reports
+void printDisplayStats() {
+  if (displayMutex == NULL || !xSemaphoreTake(displayMutex, portMAX_DELAY)) {
+    return;
+  }
+  DisplayStats s = stats;
+  memset(&stats, 0, sizeof(stats));
+  stats.sinceMs = millis();
+  xSemaphoreGive(displayMutex);
+  
+  unsigned long elapsed = stats.sinceMs - s.sinceMs;
+  float seconds = elapsed ? elapsed / 1000.0f : 1.0f;
+  Serial.printf("🖥️ Display wakeups/s over %lu ms: %.2f snapshot, %.2f marquee\n",
+                elapsed, s.frames / seconds, s.marqueeFrames / seconds);
+  if (s.frames > 0) {
+    Serial.printf("   notify->flush: avg %lu us, max %lu us; request->flush: avg %lu us, max %lu us\n",
+                  (unsigned long)(s.totalNotifyMicros / s.frames), (unsigned long)s.maxNotifyMicros,
+                  (unsigned long)(s.totalRequestMicros / s.frames), (unsigned long)s.maxRequestMicros);
+    Serial.printf("   SPI bytes/frame: avg %lu, max %lu\n",
+                  (unsigned long)(s.totalBytes / s.frames), (unsigned long)s.maxBytes);
+  }
+}
+#endif
+
 void initDisplay()
 {
   Serial.println("🖥️  Initializing ST7789 display (HSPI)...");
@@ -57,10 +156,14 @@ void initDisplay()
   Serial.println("🔆 Backlight PWM initialized on GPIO7 (TX)");  // UPDATED
 
   // Initialize display
-  display.init(SCREEN_WIDTH, SCREEN_HEIGHT);
+  panel.init(SCREEN_WIDTH, SCREEN_HEIGHT);
   
   // Set rotation (0 degrees as requested)
-  display.setRotation(3);
+  panel.setRotation(3);
+  
+  #if DISPLAY_USE_FRAMEBUFFER
+  display.begin();
+  #endif
   
   // Clear screen
   display.fillScreen(COLOR_BG);
@@ -80,6 +183,7 @@ void initDisplay()
   display.setCursor(60, 160);
   display.setTextSize(1);
   display.println("Loading...");
+  display.flush();
   
   // Turn on backlight to saved brightness - NEW
   setScreenBrightness(screenBrightness);
@@ -101,7 +205,7 @@ void initDisplay()
     4096,
     NULL,
     1,
-    NULL,
+    &displayTaskHandle,
     0
   );
   
@@ -114,11 +218,8 @@ void drawCenteredText(const char* text, int y, uint8_t textSize)
 {
   if (!text) return;
   
-  int16_t x1, y1;
-  uint16_t w, h;
   display.setTextSize(textSize);
-  display.getTextBounds(text, 0, y, &x1, &y1, &w, &h);
-  int16_t x = (display.width() - w) / 2;
+  int16_t x = (display.width() - FrameBuffer::textWidth(text, textSize)) / 2;
   display.setCursor(x, y);
   display.print(text);
 }
@@ -166,7 +267,7 @@ void drawMenuItem(const char* text, int y, bool selected, bool disabled)
   const int padding = 8;
   const int itemHeight = 36;
   
-  // Text is already truncated from database, just display it
+  // Callers pass labels that already fit the row
   
   // Draw selection background
   if (selected) {
@@ -257,53 +358,326 @@ void drawUI()
   display.setTextColor(COLOR_TEXT);
 }
 
-int calculateWindowStart(int currentIndex, int lastIdx, int lastWinStart, int listSize, const int maxDisplay)
+static const char* searchKindLabel(SearchKind kind)
 {
-  if (listSize <= maxDisplay) {
-    return 0;  // List fits on screen
+  switch (kind) {
+    case SEARCH_ARTIST: return "Artist";
+    case SEARCH_ALBUM: return "Album";
+    default: return "Song";
   }
+}
+
+// Query line, character picker and the first few matches
+static void drawSearchScreen(const UiSnapshot& s, bool fullRedraw)
+{
+  static char lastQuery[SEARCH_QUERY_MAX + 1] = "";
+  static int lastCharIndex = -1;
+  bool queryChanged = fullRedraw || strcmp(s.searchQuery, lastQuery) != 0;
+  bool pickerChanged = fullRedraw || s.searchCharIndex != lastCharIndex;
+  strcpy(lastQuery, s.searchQuery);
+  lastCharIndex = s.searchCharIndex;
   
-  // Calculate current cursor position in window
-  int cursorPos = lastIdx - lastWinStart;
+  display.setTextWrap(false);
   
-  // Clamp cursor position to valid range
-  if (cursorPos < 0) cursorPos = 0;
-  if (cursorPos >= maxDisplay) cursorPos = maxDisplay - 1;
+  if (queryChanged) {
+    display.fillRect(0, 45, SCREEN_WIDTH, 35, COLOR_BG);
+    display.drawRoundRect(4, 46, SCREEN_WIDTH - 8, 28, 4, COLOR_DISABLED);
+    display.setTextSize(2);
+    display.setTextColor(COLOR_TEXT);
+    display.setCursor(12, 53);
+    display.print(s.searchQuery);
+    display.print("_");
+  }
   
-  // Determine scroll direction
-  int delta = currentIndex - lastIdx;
+  // Picker strip, selected character centred
+  const int cells = 9;
+  const int cellWidth = 26;
+  const int stripX = (SCREEN_WIDTH - cells * cellWidth) / 2;
+  const int stripY = 86;
+  const int alphabetSize = strlen(SEARCH_ALPHABET);
   
-  int newWindowStart = lastWinStart;
+  if (pickerChanged) {
+    display.fillRect(0, stripY, SCREEN_WIDTH, 28, COLOR_BG);
+    display.setTextSize(2);
+  }
   
-  if (delta > 0) {
-    // Scrolling DOWN
-    if (cursorPos < maxDisplay - 1) {
-      // Cursor can move down within window
-      newWindowStart = lastWinStart;
+  for (int i = 0; pickerChanged && i < cells; i++) {
+    int charIndex = (s.searchCharIndex + i - cells / 2 + alphabetSize) % alphabetSize;
+    int x = stripX + i * cellWidth;
+    
+    if (i == cells / 2) {
+      display.fillRoundRect(x, stripY, cellWidth - 2, 26, 4, COLOR_SELECTED);
+      display.setTextColor(COLOR_BG);
     } else {
-      // Cursor at bottom, scroll the list
-      newWindowStart = lastWinStart + delta;
+      display.setTextColor(COLOR_TEXT);
     }
-  } else if (delta < 0) {
-    // Scrolling UP
-    if (cursorPos > 0) {
-      // Cursor can move up within window
-      newWindowStart = lastWinStart;
-    } else {
-      // Cursor at top, scroll the list
-      newWindowStart = lastWinStart + delta;
+    
+    display.setCursor(x + 7, stripY + 6);
+    display.print(SEARCH_ALPHABET[charIndex]);
+  }
+  
+  if (!queryChanged) {
+    return;
+  }
+  
+  // Preview of the best matches
+  display.fillRect(0, 120, SCREEN_WIDTH, SCREEN_HEIGHT - 120, COLOR_BG);
+  display.setTextSize(2);
+  display.setTextColor(COLOR_DISABLED);
+  
+  for (int i = 0; i < s.rowCount; i++) {
+    display.setCursor(8, 124 + i * 24);
+    display.print(s.rows[i].text);
+  }
+  
+  display.setTextSize(1);
+  display.setTextColor(COLOR_TEXT);
+  display.setCursor(8, SCREEN_HEIGHT - 20);
+  
+  if (s.searchQuery[0] == '\0') {
+    display.print("<: Delete  >: Results");
+  } else if (s.listSize >= SEARCH_MAX_RESULTS) {
+    display.printf("%d+ matches", SEARCH_MAX_RESULTS);
+  } else {
+    display.printf("%d matches", s.listSize);
+  }
+}
+
+// ============================================================================
+// RETAINED VIEWS
+// Each on-screen element remembers what it last sent to the panel and only
+// redraws the rectangle that changed, so unchanged pixels never cross SPI.
+// ============================================================================
+
+#define LIST_ROWS 5
+#define LIST_ITEM_HEIGHT 36
+#define LIST_TEXT_X 8
+
+struct RowView {
+  bool drawn;
+  int16_t y;
+  bool selected;
+  bool disabled;
+  bool playing;
+  PlayerState playState;
+  std::string text;
+};
+
+static RowView rowViews[LIST_ROWS];
+static char lastIndicator[16] = "";
+
+struct NowPlayingView {
+  bool valid;
+  bool volumeMode;
+  int volume;
+  std::string title;
+  std::string artist;
+  std::string album;
+};
+
+static NowPlayingView nowPlayingView;
+
+// Forget what the list area shows (after a clear or an overlay)
+static void invalidateRows()
+{
+  for (int i = 0; i < LIST_ROWS; i++) {
+    rowViews[i].drawn = false;
+  }
+  lastIndicator[0] = '\0';
+}
+
+static void clearListRow(int slot)
+{
+  RowView& view = rowViews[slot];
+  if (view.drawn) {
+    display.fillRect(0, view.y - 4, SCREEN_WIDTH, LIST_ITEM_HEIGHT, COLOR_BG);
+    view.drawn = false;
+    lastIndicator[0] = '\0';
+  }
+}
+
+// Draw list row `slot` (top of the list at `top`) if it changed. A label
+// change alone only repaints the span the old and new labels cover.
+static void drawListRow(int slot, int top, const UiRow& row, bool selected, PlayerState playerState)
+{
+  RowView& view = rowViews[slot];
+  int y = top + slot * LIST_ITEM_HEIGHT;
+  const char* text = row.text;
+  bool disabled = !row.enabled;
+  bool playing = row.playing;
+  PlayerState playState = playing ? playerState : STATE_STOPPED;
+  
+  bool sameFrame = view.drawn && view.y == y && view.selected == selected &&
+                   view.disabled == disabled && view.playing == playing &&
+                   view.playState == playState;
+  
+  if (sameFrame && view.text == text) {
+    return;
+  }
+  
+  if (sameFrame) {
+    // Cover the longer of the two labels, stopping short of the arrow
+    int width = max(FrameBuffer::textWidth(view.text.c_str(), 2), FrameBuffer::textWidth(text, 2));
+    width = min(width, SCREEN_WIDTH - 28 - LIST_TEXT_X);
+    display.fillRect(LIST_TEXT_X, y + 4, width, 16, selected ? COLOR_SELECTED : COLOR_BG);
+    
+    display.setTextWrap(false);
+    display.setTextSize(2);
+    display.setTextColor(selected ? COLOR_BG : (disabled ? COLOR_DISABLED : COLOR_TEXT));
+    display.setCursor(LIST_TEXT_X, y + 4);
+    display.print(text);
+    display.setTextColor(COLOR_TEXT);
+  } else {
+    display.fillRect(0, y - 4, SCREEN_WIDTH, LIST_ITEM_HEIGHT, COLOR_BG);
+    drawMenuItemWithPlayback(text, y, selected, disabled, playing, playState);
+    
+    // The last row shares pixels with the scroll indicator
+    if (slot == LIST_ROWS - 1) {
+      lastIndicator[0] = '\0';
     }
   }
   
-  // Clamp window to valid range
-  if (newWindowStart < 0) {
-    newWindowStart = 0;
+  view.drawn = true;
+  view.y = y;
+  view.selected = selected;
+  view.disabled = disabled;
+  view.playing = playing;
+  view.playState = playState;
+  view.text = text;
+}
+
+static void drawScrollIndicator(int index, int listSize, int visibleRows)
+{
+  if (listSize <= visibleRows) {
+    return;
+  }
+  
+  char text[16];
+  snprintf(text, sizeof(text), "%d/%d", index + 1, listSize);
+  if (strcmp(text, lastIndicator) == 0) {
+    return;
+  }
+  strcpy(lastIndicator, text);
+  
+  display.fillRect(SCREEN_WIDTH - 50, SCREEN_HEIGHT - 30, 50, 20, COLOR_BG);
+  display.setTextSize(1);
+  display.setTextColor(COLOR_TEXT);
+  display.setCursor(SCREEN_WIDTH - 40, SCREEN_HEIGHT - 20);
+  display.print(text);
+}
+
+// Volume overlay: percentage and only the part of the bar that moved
+static void drawVolumeView(int volume)
+{
+  NowPlayingView& view = nowPlayingView;
+  
+  const int barWidth = 200;
+  const int barHeight = 20;
+  const int barX = (SCREEN_WIDTH - barWidth) / 2;
+  const int barY = 160;
+  
+  if (!view.valid || !view.volumeMode) {
+    display.fillRect(0, 50, SCREEN_WIDTH, SCREEN_HEIGHT - 80, COLOR_BG);
+    display.setTextSize(2);
+    display.setTextColor(COLOR_TEXT);
+    drawCenteredText("Volume", 90);
+    display.drawRect(barX, barY, barWidth, barHeight, COLOR_TEXT);
+    
+    view.valid = true;
+    view.volumeMode = true;
+    view.volume = 0;
+    view.title.clear();
+  } else if (view.volume == volume) {
+    return;
   }
-  if (newWindowStart > listSize - maxDisplay) {
-    newWindowStart = listSize - maxDisplay;
+  
+  // Percentage (size 3 text is 24 px tall)
+  char volText[16];
+  snprintf(volText, sizeof(volText), "%d%%", volume);
+  display.fillRect(0, 120, SCREEN_WIDTH, 24, COLOR_BG);
+  display.setTextSize(3);
+  display.setTextColor(COLOR_TEXT);
+  drawCenteredText(volText, 120);
+  
+  int oldFill = (barWidth - 4) * view.volume / 100;
+  int newFill = (barWidth - 4) * volume / 100;
+  if (newFill > oldFill) {
+    display.fillRect(barX + 2 + oldFill, barY + 2, newFill - oldFill, barHeight - 4, COLOR_ACCENT);
+  } else if (newFill < oldFill) {
+    display.fillRect(barX + 2 + newFill, barY + 2, oldFill - newFill, barHeight - 4, COLOR_BG);
   }
   
-  return newWindowStart;
+  view.volume = volume;
+}
+
+static void drawNowPlaying(const UiSnapshot& s)
+{
+  if (s.volumeControlActive) {
+    drawVolumeView(s.volume);
+    return;
+  }
+  
+  const char* title = s.title;
+  const char* artist = s.artist;
+  const char* album = s.album;
+  
+  NowPlayingView& view = nowPlayingView;
+  
+  // Artist/album lines move up when there is no title
+  bool layoutChanged = !view.valid || view.volumeMode ||
+                       view.title.empty() != (strlen(title) == 0);
+  
+  if (layoutChanged) {
+    display.fillRect(0, 50, SCREEN_WIDTH, SCREEN_HEIGHT - 80, COLOR_BG);
+    view.valid = true;
+    view.volumeMode = false;
+    view.title.clear();
+    view.artist.clear();
+    view.album.clear();
+  }
+  
+  int centerY = 80;
+  
+  if (strlen(title) > 0) {
+    if (layoutChanged || view.title != title) {
+      display.fillRect(0, centerY, SCREEN_WIDTH, 60, COLOR_BG);
+      display.setTextSize(2);
+      display.setTextColor(COLOR_TEXT);
+      
+      // One line; a title wider than that scrolls in the marquee
+      if (FrameBuffer::textWidth(title, 2) <= SCREEN_WIDTH - 16) {
+        drawCenteredText(title, centerY + 20, 2);
+      } else if (!display.active()) {
+        display.setCursor(8, centerY + 20);
+        display.print(title);
+      }
+      view.title = title;
+    }
+    titleMarquee.show(title, 8, centerY + 20, SCREEN_WIDTH - 16, COLOR_TEXT, COLOR_BG);
+    
+    centerY += 70;
+  }
+  
+  if (layoutChanged || view.artist != artist) {
+    display.fillRect(0, centerY, SCREEN_WIDTH, 8, COLOR_BG);
+    display.setTextSize(1);
+    display.setTextColor(COLOR_DISABLED);
+    drawCenteredText(artist, centerY);
+    view.artist = artist;
+  }
+  if (strlen(artist) > 0) {
+    centerY += 16;
+  }
+  
+  if (layoutChanged || view.album != album) {
+    display.fillRect(0, centerY, SCREEN_WIDTH, 8, COLOR_BG);
+    display.setTextSize(1);
+    display.setTextColor(COLOR_DISABLED);
+    drawCenteredText(album, centerY);
+    view.album = album;
+  }
+  
+  display.setTextColor(COLOR_TEXT);
 }
 
 // Brightness control with hardware PWM - UPDATED
@@ -321,44 +695,32 @@ void setScreenBrightness(int brightness) {
     Serial.printf("🔆 Brightness set to: %d/255 (%d%%)\n", brightness, percent);
 }
 
-void updateDisplay()
+void updateDisplay(const UiSnapshot& s, uint32_t dirty)
 {
-  MenuType menu = currentMenu;
-  int idx = menuIndex;
-  int artIdx = artistIndex;
-  int albIdx = albumIndex;
-  int sngIdx = songIndex;
-  
-  char title[128] = {0};
-  char artist[128] = {0};
-  char album[128] = {0};
-  
-  strncpy(title, currentTitle.c_str(), 127);
-  strncpy(artist, currentArtist.c_str(), 127);
-  strncpy(album, currentAlbum.c_str(), 127);
+  MenuType menu = s.menu;
   
   // Track what was previously displayed
   static MenuType lastMenu = (MenuType)-1;  // Invalid initial state
-  static int lastDisplayedIndex = -1;
   static PlayerState lastPlayerState = STATE_STOPPED;
-  static unsigned long lastHeaderUpdate = 0;  // NEW - Track header updates
+  static int lastBatteryPercent = -1;
+  static bool lastBatteryCharging = false;
 
   // Full redraw if menu changed OR forced - UPDATED
-  bool fullRedraw = (menu != lastMenu) || forceDisplayRedraw;
+  bool fullRedraw = (menu != lastMenu) || (dirty & DISPLAY_DIRTY_FULL);
   lastMenu = menu;
   
-  if (forceDisplayRedraw) {
+  if (dirty & DISPLAY_DIRTY_FULL) {
     Serial.println("🔄 Force redraw requested");
-    forceDisplayRedraw = false;  // Reset flag
   }
   
-  // Also redraw header if playback state changed
-  bool playbackStateChanged = (player_state != lastPlayerState);
-  lastPlayerState = player_state;
-  
-  // Periodic header update for battery status - NEW
-  unsigned long now = millis();
-  bool periodicHeaderUpdate = (now - lastHeaderUpdate > 5000);  // Every 5 seconds
+  // Header is only resent when something it shows changed
+  bool headerChanged = fullRedraw ||
+                       s.playerState != lastPlayerState ||
+                       s.batteryPercent != lastBatteryPercent ||
+                       s.batteryCharging != lastBatteryCharging;
+  lastPlayerState = s.playerState;
+  lastBatteryPercent = s.batteryPercent;
+  lastBatteryCharging = s.batteryCharging;
   
   if (fullRedraw) {
     display.fillScreen(COLOR_BG);
@@ -368,14 +730,7 @@ void updateDisplay()
   display.setTextColor(COLOR_TEXT);
   display.setTextWrap(false);
 
-  if (fullRedraw || playbackStateChanged || periodicHeaderUpdate) {
-    if (periodicHeaderUpdate) {
-      lastHeaderUpdate = now;
-      #ifdef DEBUG
-      Serial.println("🔄 Periodic header update (battery status)");
-      #endif
-    }
-    
+  if (headerChanged) {
     const char* headerText = "ROUGE MP3";
     switch(menu) {
       case MENU_MAIN: headerText = "Main Menu"; break;
@@ -386,6 +741,8 @@ void updateDisplay()
       case MENU_ALBUM_LIST: headerText = "Albums"; break;
       case MENU_SONG_LIST: headerText = "Songs"; break;
       case MENU_NOW_PLAYING: headerText = "Now Playing"; break;
+      case MENU_SEARCH: headerText = "Search"; break;
+      case MENU_SEARCH_RESULTS: headerText = "Results"; break;
     }
     
     // Header bar
@@ -394,8 +751,8 @@ void updateDisplay()
     drawCenteredText(headerText, 12, 2);
     
     // Playback indicator in top-left of header
-    if (player_state == STATE_PLAYING || player_state == STATE_PAUSED) {
-      drawPlaybackIcon(8, 12, player_state);
+    if (s.playerState == STATE_PLAYING || s.playerState == STATE_PAUSED) {
+      drawPlaybackIcon(8, 12, s.playerState);
     }
     
     // Battery indicator in top-right of header - NEW
@@ -404,21 +761,19 @@ void updateDisplay()
     
     // Show percentage
     char batteryText[16];
-    snprintf(batteryText, sizeof(batteryText), "%d%%", batteryPercent);
+    snprintf(batteryText, sizeof(batteryText), "%d%%", s.batteryPercent);
     
     // Position at top-right
-    int16_t x1, y1;
-    uint16_t w, h;
-    display.getTextBounds(batteryText, 0, 0, &x1, &y1, &w, &h);
+    int16_t w = FrameBuffer::textWidth(batteryText, 1);
     
     // If charging, make room for icon
-    int iconWidth = batteryCharging ? 10 : 0;
+    int iconWidth = s.batteryCharging ? 10 : 0;
     display.setCursor(SCREEN_WIDTH - w - iconWidth - 8, 12);
     
     // Color based on battery level
-    if (batteryPercent <= 10) {
+    if (s.batteryPercent <= 10) {
       display.setTextColor(0xF800);  // Red
-    } else if (batteryPercent <= 20) {
+    } else if (s.batteryPercent <= 20) {
       display.setTextColor(0xFD20);  // Orange
     } else {
       display.setTextColor(COLOR_HEADER);  // White
@@ -427,469 +782,145 @@ void updateDisplay()
     display.print(batteryText);
     
     // Draw lightning icon if charging
-    if (batteryCharging) {
+    if (s.batteryCharging) {
       drawLightningIcon(SCREEN_WIDTH - iconWidth - 4, 12, COLOR_SELECTED);  // Green lightning
     }
     
     display.setTextColor(COLOR_TEXT);
-    
-    // Leave after header is updated if only a periodic update
-    if (!fullRedraw && !playbackStateChanged && periodicHeaderUpdate){
-      return;
-    }
+  }
+  
+  // Header-only updates (battery) leave the body alone
+  if (!fullRedraw && !(dirty & (DISPLAY_DIRTY_LIST | DISPLAY_DIRTY_NOW_PLAYING | DISPLAY_DIRTY_OVERLAY))) {
+    return;
   }
 
-  const int maxDisplay = 5;
+  const int maxDisplay = UI_LIST_ROWS;
   const int startY = 50;
-  const int itemHeight = 36;
+  bool rowScrolling = false;
+
+  if (fullRedraw) {
+    invalidateRows();
+    nowPlayingView.valid = false;
+  }
 
   // Render based on menu type
-  if (menu == MENU_MAIN || menu == MENU_MUSIC || 
-      menu == MENU_BLUETOOTH)
-  {
-    int listSize = currentMenuItems.size();
-    int windowStart = calculateWindowStart(idx, lastIndex[0], lastWindowStart[0], listSize, maxDisplay);
-    
-    // Detect if we need full list redraw (window scrolled)
-    bool windowChanged = (windowStart != lastWindowStart[0]) || fullRedraw;
+  if (menu == MENU_SETTINGS && s.brightnessControlActive) {
+    // BRIGHTNESS CONTROL MODE
+    // Clear ENTIRE screen below header - UPDATED
+    display.fillRect(0, 40, SCREEN_WIDTH, SCREEN_HEIGHT - 40, COLOR_BG);
+    invalidateRows();
     
-    lastWindowStart[0] = windowStart;
+    int centerY = 90;
     
-    if (windowChanged) {
-      // Clear menu area only
-      display.fillRect(0, startY - 5, SCREEN_WIDTH, maxDisplay * itemHeight + 10, COLOR_BG);
-      
-      // Redraw all visible items
-      for (int i = 0; i < maxDisplay && (windowStart + i) < listSize; i++)
-      {
-        int y = startY + i * itemHeight;
-        bool selected = (windowStart + i) == idx;
-        
-        const MenuItem& item = currentMenuItems[windowStart + i];
-        drawMenuItem(item.label.c_str(), y, selected, !item.enabled);
-      }
-    } else {
-      // Only selection changed within same window
-      // Redraw old selected item (unselected)
-      if (lastDisplayedIndex >= windowStart && lastDisplayedIndex < windowStart + maxDisplay) {
-        int oldPos = lastDisplayedIndex - windowStart;
-        int y = startY + oldPos * itemHeight;
-        
-        // Clear old selection
-        display.fillRect(0, y - 5, SCREEN_WIDTH, itemHeight + 5, COLOR_BG);
-        
-        const MenuItem& item = currentMenuItems[lastDisplayedIndex];
-        drawMenuItem(item.label.c_str(), y, false, !item.enabled);
-      }
-      
-      // Draw new selected item
-      if (idx >= windowStart && idx < windowStart + maxDisplay) {
-        int newPos = idx - windowStart;
-        int y = startY + newPos * itemHeight;
-        
-        // Clear new selection area
-        display.fillRect(0, y - 5, SCREEN_WIDTH, itemHeight + 5, COLOR_BG);
-        
-        const MenuItem& item = currentMenuItems[idx];
-        drawMenuItem(item.label.c_str(), y, true, !item.enabled);
-      }
+    // "Brightness" label
+    display.setTextSize(2);
+    display.setTextColor(COLOR_TEXT);
+    drawCenteredText("Brightness", centerY);
+    centerY += 30;
+    
+    // Brightness percentage
+    char brightText[16];
+    int brightPercent = (s.brightness * 100) / 255;
+    snprintf(brightText, sizeof(brightText), "%d%%", brightPercent);
+    display.setTextSize(3);
+    drawCenteredText(brightText, centerY);
+    centerY += 40;
+    
+    // Brightness bar
+    int barWidth = 200;
+    int barHeight = 20;
+    int barX = (SCREEN_WIDTH - barWidth) / 2;
+    int barY = centerY;
+    
+    // Background (empty bar)
+    display.drawRect(barX, barY, barWidth, barHeight, COLOR_TEXT);
+    
+    // Fill based on brightness
+    int fillWidth = (barWidth - 4) * s.brightness / 255;
+    if (fillWidth > 0) {
+        display.fillRect(barX + 2, barY + 2, fillWidth, barHeight - 4, COLOR_ACCENT);
     }
     
-    lastIndex[0] = idx;
-    lastDisplayedIndex = idx;
-    
-    // Scroll indicator (always redraw on change)
-    if (listSize > maxDisplay) {
-      // Clear indicator area
-      display.fillRect(SCREEN_WIDTH - 50, SCREEN_HEIGHT - 30, 50, 20, COLOR_BG);
-      
-      display.setTextSize(1);
-      display.setTextColor(COLOR_TEXT);
-      display.setCursor(SCREEN_WIDTH - 40, SCREEN_HEIGHT - 20);
-      display.printf("%d/%d", idx + 1, listSize);
-    }
-
-  } else if (menu == MENU_SETTINGS) {
-    // Check if showing brightness control
-    if (brightnessControlActive) {
-        // BRIGHTNESS CONTROL MODE
-        // Clear ENTIRE screen below header - UPDATED
-        display.fillRect(0, 40, SCREEN_WIDTH, SCREEN_HEIGHT - 40, COLOR_BG);
-        
-        int centerY = 90;
-        
-        // "Brightness" label
-        display.setTextSize(2);
-        display.setTextColor(COLOR_TEXT);
-        drawCenteredText("Brightness", centerY);
-        centerY += 30;
-        
-        // Brightness percentage
-        char brightText[16];
-        int brightPercent = (screenBrightness * 100) / 255;
-        snprintf(brightText, sizeof(brightText), "%d%%", brightPercent);
-        display.setTextSize(3);
-        drawCenteredText(brightText, centerY);
-        centerY += 40;
-        
-        // Brightness bar
-        int barWidth = 200;
-        int barHeight = 20;
-        int barX = (SCREEN_WIDTH - barWidth) / 2;
-        int barY = centerY;
-        
-        // Background (empty bar)
-        display.drawRect(barX, barY, barWidth, barHeight, COLOR_TEXT);
-        
-        // Fill based on brightness
-        int fillWidth = (barWidth - 4) * screenBrightness / 255;
-        if (fillWidth > 0) {
-            display.fillRect(barX + 2, barY + 2, fillWidth, barHeight - 4, COLOR_ACCENT);
-        }
-        
-        // Instructions
-        display.setTextSize(1);
-        display.setTextColor(COLOR_TEXT);
-        display.setCursor(10, SCREEN_HEIGHT - 30);
-        display.print("Turn: Adjust");
-        display.setCursor(10, SCREEN_HEIGHT - 15);
-        display.print("Wait/Back: Save");
-        
-    } else {
-        // Normal settings menu
-        int listSize = currentMenuItems.size();
-        int windowStart = calculateWindowStart(idx, lastIndex[0], lastWindowStart[0], listSize, maxDisplay);
-        bool windowChanged = (windowStart != lastWindowStart[0]) || fullRedraw;
-        
-        lastWindowStart[0] = windowStart;
-        
-        if (windowChanged) {
-          display.fillRect(0, startY - 5, SCREEN_WIDTH, maxDisplay * itemHeight + 10, COLOR_BG);
-          
-          for (int i = 0; i < maxDisplay && (windowStart + i) < listSize; i++)
-          {
-            int y = startY + i * itemHeight;
-            bool selected = (windowStart + i) == idx;
-            
-            const MenuItem& item = currentMenuItems[windowStart + i];
-            drawMenuItem(item.label.c_str(), y, selected, !item.enabled);
-          }
-        } else {
-          if (lastDisplayedIndex >= windowStart && lastDisplayedIndex < windowStart + maxDisplay) {
-            int oldPos = lastDisplayedIndex - windowStart;
-            int y = startY + oldPos * itemHeight;
-            
-            display.fillRect(0, y - 5, SCREEN_WIDTH, itemHeight + 5, COLOR_BG);
-            
-            const MenuItem& item = currentMenuItems[lastDisplayedIndex];
-            drawMenuItem(item.label.c_str(), y, false, !item.enabled);
-          }
-          
-          if (idx >= windowStart && idx < windowStart + maxDisplay) {
-            int newPos = idx - windowStart;
-            int y = startY + newPos * itemHeight;
-            
-            display.fillRect(0, y - 5, SCREEN_WIDTH, itemHeight + 5, COLOR_BG);
-            
-            const MenuItem& item = currentMenuItems[idx];
-            drawMenuItem(item.label.c_str(), y, true, !item.enabled);
-          }
-        }
-        
-        lastIndex[0] = idx;
-        lastDisplayedIndex = idx;
-        
-        if (listSize > maxDisplay) {
-          display.fillRect(SCREEN_WIDTH - 50, SCREEN_HEIGHT - 30, 50, 20, COLOR_BG);
-          
-          display.setTextSize(1);
-          display.setTextColor(COLOR_TEXT);
-          display.setCursor(SCREEN_WIDTH - 40, SCREEN_HEIGHT - 20);
-          display.printf("%d/%d", idx + 1, listSize);
-        }
-    }
+    // Instructions
+    display.setTextSize(1);
+    display.setTextColor(COLOR_TEXT);
+    display.setCursor(10, SCREEN_HEIGHT - 30);
+    display.print("Turn: Adjust");
+    display.setCursor(10, SCREEN_HEIGHT - 15);
+    display.print("Wait/Back: Save");
   }
-  else if (menu == MENU_ARTIST_LIST && !artists.empty())
+  else if (menu == MENU_SEARCH)
   {
-    int listSize = artists.size();
-    int windowStart = calculateWindowStart(artIdx, lastIndex[1], lastWindowStart[1], listSize, maxDisplay);
-    
-    bool windowChanged = (windowStart != lastWindowStart[1]) || fullRedraw;
-    lastWindowStart[1] = windowStart;
-    
-    if (windowChanged) {
-      display.fillRect(0, startY - 5, SCREEN_WIDTH, maxDisplay * itemHeight + 10, COLOR_BG);
-      
-      for (int i = 0; i < maxDisplay && (windowStart + i) < listSize; i++)
-      {
-        int y = startY + i * itemHeight;
-        bool selected = (windowStart + i) == artIdx;
-        
-        // Check if this is the currently playing artist
-        bool isPlayingArtist = (player_state != STATE_STOPPED && 
-                                !currentArtist.empty() && 
-                                artists[windowStart + i] == currentArtist);
-        
-        drawMenuItemWithPlayback(artists[windowStart + i].c_str(), y, selected, false, isPlayingArtist, player_state);
-      }
-    } else {
-      // Only selection changed
-      if (lastDisplayedIndex >= windowStart && lastDisplayedIndex < windowStart + maxDisplay) {
-        int oldPos = lastDisplayedIndex - windowStart;
-        int y = startY + oldPos * itemHeight;
-        display.fillRect(0, y - 5, SCREEN_WIDTH, itemHeight + 5, COLOR_BG);
-        
-        bool isPlayingArtist = (player_state != STATE_STOPPED && 
-                                !currentArtist.empty() && 
-                                artists[lastDisplayedIndex] == currentArtist);
-        
-        drawMenuItemWithPlayback(artists[lastDisplayedIndex].c_str(), y, false, false, isPlayingArtist, player_state);
-      }
-      
-      if (artIdx >= windowStart && artIdx < windowStart + maxDisplay) {
-        int newPos = artIdx - windowStart;
-        int y = startY + newPos * itemHeight;
-        display.fillRect(0, y - 5, SCREEN_WIDTH, itemHeight + 5, COLOR_BG);
-        
-        bool isPlayingArtist = (player_state != STATE_STOPPED && 
-                                !currentArtist.empty() && 
-                                artists[artIdx] == currentArtist);
-        
-        drawMenuItemWithPlayback(artists[artIdx].c_str(), y, true, false, isPlayingArtist, player_state);
-      }
-    }
-    
-    lastIndex[1] = artIdx;
-    lastDisplayedIndex = artIdx;
-    
-    if (listSize > maxDisplay) {
-      display.fillRect(SCREEN_WIDTH - 50, SCREEN_HEIGHT - 30, 50, 20, COLOR_BG);
-      display.setTextSize(1);
-      display.setTextColor(COLOR_TEXT);
-      display.setCursor(SCREEN_WIDTH - 40, SCREEN_HEIGHT - 20);
-      display.printf("%d/%d", artIdx + 1, listSize);
-    }
+    drawSearchScreen(s, fullRedraw);
   }
-  else if (menu == MENU_ALBUM_LIST && !albums.empty())
+  else if (menu == MENU_NOW_PLAYING)
   {
-    int listSize = albums.size();
-    int windowStart = calculateWindowStart(albIdx, lastIndex[2], lastWindowStart[2], listSize, maxDisplay);
-    
-    bool windowChanged = (windowStart != lastWindowStart[2]) || fullRedraw;
-    lastWindowStart[2] = windowStart;
-    
-    if (fullRedraw) {
-      // Show current artist in subheader
-      display.setTextSize(1);
-      display.setTextColor(COLOR_DISABLED);
-      display.setCursor(8, 45);
-      display.print(artist);
-    }
-    
-    int offsetY = 15;
-    
-    if (windowChanged) {
-      display.fillRect(0, startY + offsetY - 5, SCREEN_WIDTH, maxDisplay * itemHeight + 10, COLOR_BG);
-      
-      for (int i = 0; i < maxDisplay && (windowStart + i) < listSize; i++)
-      {
-        int y = startY + offsetY + i * itemHeight;
-        bool selected = (windowStart + i) == albIdx;
-        
-        // Check if this is the currently playing album
-        bool isPlayingAlbum = (player_state != STATE_STOPPED && 
-                               !currentAlbum.empty() && 
-                               albums[windowStart + i] == currentAlbum);
-        
-        drawMenuItemWithPlayback(albums[windowStart + i].c_str(), y, selected, false, isPlayingAlbum, player_state);
-      }
-    } else {
-      if (lastDisplayedIndex >= windowStart && lastDisplayedIndex < windowStart + maxDisplay) {
-        int oldPos = lastDisplayedIndex - windowStart;
-        int y = startY + offsetY + oldPos * itemHeight;
-        display.fillRect(0, y - 5, SCREEN_WIDTH, itemHeight + 5, COLOR_BG);
-        
-        bool isPlayingAlbum = (player_state != STATE_STOPPED && 
-                               !currentAlbum.empty() && 
-                               albums[lastDisplayedIndex] == currentAlbum);
-        
-        drawMenuItemWithPlayback(albums[lastDisplayedIndex].c_str(), y, false, false, isPlayingAlbum, player_state);
-      }
-      
-      if (albIdx >= windowStart && albIdx < windowStart + maxDisplay) {
-        int newPos = albIdx - windowStart;
-        int y = startY + offsetY + newPos * itemHeight;
-        display.fillRect(0, y - 5, SCREEN_WIDTH, itemHeight + 5, COLOR_BG);
-        
-        bool isPlayingAlbum = (player_state != STATE_STOPPED && 
-                               !currentAlbum.empty() && 
-                               albums[albIdx] == currentAlbum);
-        
-        drawMenuItemWithPlayback(albums[albIdx].c_str(), y, true, false, isPlayingAlbum, player_state);
-      }
-    }
-    
-    lastIndex[2] = albIdx;
-    lastDisplayedIndex = albIdx;
-    
-    if (listSize > maxDisplay) {
-      display.fillRect(SCREEN_WIDTH - 50, SCREEN_HEIGHT - 30, 50, 20, COLOR_BG);
-      display.setTextSize(1);
-      display.setTextColor(COLOR_TEXT);
-      display.setCursor(SCREEN_WIDTH - 40, SCREEN_HEIGHT - 20);
-      display.printf("%d/%d", albIdx + 1, listSize);
-    }
+    drawNowPlaying(s);
   }
-  else if (menu == MENU_SONG_LIST && !songs.empty())
+  else if (s.rowCount > 0)
   {
-    int listSize = songs.size();
-    int windowStart = calculateWindowStart(sngIdx, lastIndex[3], lastWindowStart[3], listSize, maxDisplay);
-    
-    bool windowChanged = (windowStart != lastWindowStart[3]) || fullRedraw;
-    lastWindowStart[3] = windowStart;
-    
-    if (fullRedraw) {
-      display.setTextSize(1);
-      display.setTextColor(COLOR_DISABLED);
-      display.setCursor(8, 45);
-      display.print(album);
+    // Album and song lists sit under a subheader naming their parent
+    int top = startY;
+    if (menu == MENU_ALBUM_LIST || menu == MENU_SONG_LIST) {
+      if (fullRedraw) {
+        display.setTextSize(1);
+        display.setTextColor(COLOR_DISABLED);
+        display.setCursor(8, 45);
+        display.print(s.subheader);
+      }
+      top += 15;
     }
     
-    int offsetY = 15;
+    // Search results keep the bottom row for the kind footer
+    int rows = (menu == MENU_SEARCH_RESULTS) ? maxDisplay - 1 : maxDisplay;
     
-    if (windowChanged) {
-      display.fillRect(0, startY + offsetY - 5, SCREEN_WIDTH, maxDisplay * itemHeight + 10, COLOR_BG);
-      
-      for (int i = 0; i < maxDisplay && (windowStart + i) < listSize; i++)
-      {
-        int y = startY + offsetY + i * itemHeight;
-        bool selected = (windowStart + i) == sngIdx;
-        
-        // Check if this is the currently playing song
-        bool isPlayingSong = (player_state != STATE_STOPPED && 
-                              !currentTitle.empty() && 
-                              songs[windowStart + i].title == currentTitle);
-        
-        drawMenuItemWithPlayback(songs[windowStart + i].displayTitle.c_str(), y, selected, false, isPlayingSong, player_state);
-      }
-    } else {
-      if (lastDisplayedIndex >= windowStart && lastDisplayedIndex < windowStart + maxDisplay) {
-        int oldPos = lastDisplayedIndex - windowStart;
-        int y = startY + offsetY + oldPos * itemHeight;
-        display.fillRect(0, y - 5, SCREEN_WIDTH, itemHeight + 5, COLOR_BG);
-        
-        bool isPlayingSong = (player_state != STATE_STOPPED && 
-                              !currentTitle.empty() && 
-                              songs[lastDisplayedIndex].title == currentTitle);
-        
-        drawMenuItemWithPlayback(songs[lastDisplayedIndex].displayTitle.c_str(), y, false, false, isPlayingSong, player_state);
-      }
-      
-      if (sngIdx >= windowStart && sngIdx < windowStart + maxDisplay) {
-        int newPos = sngIdx - windowStart;
-        int y = startY + offsetY + newPos * itemHeight;
-        display.fillRect(0, y - 5, SCREEN_WIDTH, itemHeight + 5, COLOR_BG);
-        
-        bool isPlayingSong = (player_state != STATE_STOPPED && 
-                              !currentTitle.empty() && 
-                              songs[sngIdx].title == currentTitle);
-        
-        drawMenuItemWithPlayback(songs[sngIdx].displayTitle.c_str(), y, true, false, isPlayingSong, player_state);
+    for (int i = 0; i < rows; i++) {
+      if (i < s.rowCount) {
+        drawListRow(i, top, s.rows[i], i == s.selectedRow, s.playerState);
+      } else {
+        clearListRow(i);
       }
     }
     
-    lastIndex[3] = sngIdx;
-    lastDisplayedIndex = sngIdx;
+    // Full name of a shortened selected row scrolls in place
+    if (s.selectedText[0] != '\0' && s.jumpLetter == '\0' &&
+        s.selectedRow >= 0 && s.selectedRow < s.rowCount) {
+      int y = top + s.selectedRow * LIST_ITEM_HEIGHT + 4;
+      rowScrolling = rowMarquee.show(s.selectedText, LIST_TEXT_X, y, SCREEN_WIDTH - 28 - LIST_TEXT_X,
+                                     COLOR_BG, COLOR_SELECTED);
+    }
     
-    if (listSize > maxDisplay) {
-      display.fillRect(SCREEN_WIDTH - 50, SCREEN_HEIGHT - 30, 50, 20, COLOR_BG);
-      display.setTextSize(1);
+    // Current letter over the list while jumping by letter
+    if (s.jumpLetter != '\0') {
+      char letter[2] = { s.jumpLetter, '\0' };
+      display.fillRoundRect(80, 100, 80, 80, 8, COLOR_ACCENT);
+      display.setTextColor(COLOR_HEADER);
+      drawCenteredText(letter, 116, 6);
       display.setTextColor(COLOR_TEXT);
-      display.setCursor(SCREEN_WIDTH - 40, SCREEN_HEIGHT - 20);
-      display.printf("%d/%d", sngIdx + 1, listSize);
     }
-  }
-  else if (menu == MENU_NOW_PLAYING)
-  {
-    // Check if showing volume control
-    if (volumeControlActive) {
-      // VOLUME CONTROL MODE
-      display.fillRect(0, 50, SCREEN_WIDTH, SCREEN_HEIGHT - 80, COLOR_BG);
-      
-      int centerY = 90;
-      
-      // "Volume" label
-      display.setTextSize(2);
-      display.setTextColor(COLOR_TEXT);
-      drawCenteredText("Volume", centerY);
-      centerY += 30;
-      
-      // Volume percentage
-      char volText[16];
-      snprintf(volText, sizeof(volText), "%d%%", currentVolume);
-      display.setTextSize(3);
-      drawCenteredText(volText, centerY);
-      centerY += 40;
-      
-      // Volume bar
-      int barWidth = 200;
-      int barHeight = 20;
-      int barX = (SCREEN_WIDTH - barWidth) / 2;
-      int barY = centerY;
-      
-      // Background (empty bar)
-      display.drawRect(barX, barY, barWidth, barHeight, COLOR_TEXT);
-      
-      // Fill based on volume
-      int fillWidth = (barWidth - 4) * currentVolume / 100;
-      if (fillWidth > 0) {
-        display.fillRect(barX + 2, barY + 2, fillWidth, barHeight - 4, COLOR_ACCENT);
-      }
-      
-    } else {
-      // NORMAL NOW PLAYING DISPLAY
-      display.fillRect(0, 50, SCREEN_WIDTH, SCREEN_HEIGHT - 80, COLOR_BG);
-      
-      int centerY = 80;
-      
-      if (strlen(title) > 0) {
-        display.setTextSize(2);
-        display.setTextColor(COLOR_TEXT);
-        
-        String titleStr = String(title);
-        int charsPerLine = 16;
-        
-        for (int line = 0; line < 3 && !titleStr.isEmpty(); line++) {
-          String chunk = titleStr.substring(0, min((int)titleStr.length(), charsPerLine));
-          drawCenteredText(chunk.c_str(), centerY + line * 20, 2);
-          titleStr = titleStr.substring(chunk.length());
-        }
-        
-        centerY += 70;
-      }
-      
-      if (strlen(artist) > 0) {
-        display.setTextSize(1);
-        display.setTextColor(COLOR_DISABLED);
-        drawCenteredText(artist, centerY);
-        centerY += 16;
-      }
+    
+    // Kind of the selected result
+    if (menu == MENU_SEARCH_RESULTS) {
+      static SearchKind lastKind = SEARCH_ARTIST;
       
-      if (strlen(album) > 0) {
+      if (fullRedraw || s.selectedKind != lastKind) {
+        lastKind = s.selectedKind;
+        display.fillRect(0, SCREEN_HEIGHT - 30, 100, 20, COLOR_BG);
         display.setTextSize(1);
         display.setTextColor(COLOR_DISABLED);
-        drawCenteredText(album, centerY);
+        display.setCursor(8, SCREEN_HEIGHT - 20);
+        display.print(searchKindLabel(s.selectedKind));
+        display.setTextColor(COLOR_TEXT);
       }
     }
     
-    // Only redraw controls on fullRedraw
-    // if (fullRedraw) {
-    //   display.setTextSize(1);
-    //   display.setTextColor(COLOR_TEXT);
-    //   display.setCursor(10, SCREEN_HEIGHT - 30);
-    //   display.print("Press: Play/Pause");
-    //   display.setCursor(10, SCREEN_HEIGHT - 15);
-    //   display.print("Turn: Volume");
-    // }
+    drawScrollIndicator(s.index, s.listSize, rows);
+  }
+  
+  if (!rowScrolling) {
+    rowMarquee.stop();
+  }
+  if (menu != MENU_NOW_PLAYING || s.volumeControlActive) {
+    titleMarquee.stop();
   }
 }
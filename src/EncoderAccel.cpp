@@ -0,0 +1,62 @@
+#include "EncoderAccel.h"
+
+void encoderAccelReset(EncoderAccel& accel)
+{
+  accel.lastMs = 0;
+  accel.rate = 0.0f;
+  accel.moving = false;
+  accel.spinStartMs = 0;
+  accel.spinning = false;
+}
+
+uint32_t encoderAccelSpinMs(const EncoderAccel& accel)
+{
+  return accel.spinning ? accel.lastMs - accel.spinStartMs : 0;
+}
+
+int encoderAccelSteps(EncoderAccel& accel, uint32_t nowMs, int detents)
+{
+  if (detents <= 0) {
+    return 0;
+  }
+
+  uint32_t elapsed = nowMs - accel.lastMs;
+  accel.lastMs = nowMs;
+
+  // First detents of a spin always move one row each
+  if (!accel.moving || elapsed > ENCODER_ACCEL_IDLE_MS) {
+    accel.moving = true;
+    accel.rate = 0.0f;
+    accel.spinning = false;
+    return detents;
+  }
+
+  // Even-weight moving average: one fast reading can't launch the list.
+  // The rest of a batch already timed (same timestamp) keeps its speed.
+  if (elapsed > 0) {
+    float instant = detents * 1000.0f / elapsed;
+    accel.rate = (accel.rate + instant) * 0.5f;
+  }
+
+  if (accel.rate < ENCODER_ACCEL_SPIN_RATE) {
+    accel.spinning = false;
+  } else if (!accel.spinning) {
+    accel.spinning = true;
+    accel.spinStartMs = nowMs;
+  }
+
+  if (accel.rate <= ENCODER_ACCEL_SLOW_RATE) {
+    return detents;
+  }
+
+  // Quadratic ease-in between the slow and fast rates
+  float t = (accel.rate - ENCODER_ACCEL_SLOW_RATE) /
+            (ENCODER_ACCEL_FAST_RATE - ENCODER_ACCEL_SLOW_RATE);
+  if (t > 1.0f) {
+    t = 1.0f;
+  }
+
+  float multiplier = 1.0f + t * t * (ENCODER_ACCEL_MAX_STEP - 1);
+  int steps = (int)(detents * multiplier + 0.5f);
+  return steps > detents ? steps : detents;
+}
@@ -1,4 +1,6 @@
 #include "EncoderModule.h"
+#include "EncoderAccel.h"
+#include "InputQueue.h"
 #include "State.h"
 #include "Display.h"
 #include "Haptics.h"
@@ -10,15 +12,23 @@
 #define ENCODER_PIN_B 25
 
 static RotaryEncoder encoder(ENCODER_PIN_A, ENCODER_PIN_B, RotaryEncoder::LatchMode::TWO03);
-static int lastPos = 0;
-static int lastValidPos = 0;
+static int isrLastPos = 0;             // Position last reported by the ISR
+
+// Detents queued by the ISR and not yet applied, and when the last arrived
+static int pendingDetents = 0;
+static uint32_t lastDetentTime = 0;
 
 // Tuning parameters
 static unsigned long lastEncoderUpdate = 0;
 const unsigned long ENCODER_UPDATE_INTERVAL = 90;
 
-// Anti-jump threshold
-const int ENCODER_JUMP_THRESHOLD = 3;
+// Most detents applied in one update. Anything beyond stays pending for
+// the next one, so a burst queued while loop() was busy is spread out
+// rather than lost; glitches are left to the direction filter below.
+const int ENCODER_MAX_UPDATE_DETENTS = 12;
+
+// Spin speed -> rows per detent (lists and volume)
+static EncoderAccel accel;
 
 // Track scroll direction
 int lastScrollDirection = 0;  // -1 = up, 1 = down, 0 = none
@@ -38,6 +48,18 @@ unsigned long lastEncoderMovement = 0;
 void IRAM_ATTR encoderISR()
 {
   encoder.tick();
+  
+  int pos = encoder.getPosition();
+  if (pos != isrLastPos) {
+    postInputEvent(INPUT_ENCODER, pos - isrLastPos);
+    isrLastPos = pos;
+  }
+}
+
+void queueEncoderDetents(int detents, uint32_t timeMs)
+{
+  pendingDetents += detents;
+  lastDetentTime = timeMs;
 }
 
 void initEncoder()
@@ -51,8 +73,8 @@ void initEncoder()
   attachInterrupt(digitalPinToInterrupt(ENCODER_PIN_A), encoderISR, CHANGE);
   attachInterrupt(digitalPinToInterrupt(ENCODER_PIN_B), encoderISR, CHANGE);
   
-  lastPos = encoder.getPosition();
-  lastValidPos = lastPos;
+  isrLastPos = encoder.getPosition();
+  encoderAccelReset(accel);
   
   Serial.println("✅ Encoder initialized");
 }
@@ -72,27 +94,23 @@ int getDominantDirection() {
   return 0;
 }
 
+// A rejected update discards the one glitched detent; whatever else is
+// pending is real movement and gets applied on later updates
+static void dropReversedDetent(int delta) {
+  pendingDetents -= (delta > 0) ? 1 : -1;
+}
+
 bool isEncoderScrolling() {
   return (millis() - lastEncoderMovement < BUTTON_SUPPRESS_TIME);
 }
 
 void updateEncoder()
 {
-  int newPos = encoder.getPosition();
-  
-  if (newPos != lastPos)
+  if (pendingDetents != 0)
   {
-    int delta = newPos - lastPos;
-    
-    // Anti-jump protection
-    if (abs(delta) > ENCODER_JUMP_THRESHOLD) {
-      Serial.printf("⚠️ Encoder jump detected: %d steps, ignoring\n", delta);
-      encoder.setPosition(lastValidPos);
-      lastPos = lastValidPos;
-      return;
-    }
+    int delta = constrain(pendingDetents, -ENCODER_MAX_UPDATE_DETENTS, ENCODER_MAX_UPDATE_DETENTS);
     
-    // Throttle updates
+    // Throttle updates; skipped detents stay pending
     unsigned long now = millis();
     if (now - lastEncoderUpdate < ENCODER_UPDATE_INTERVAL) {
       return;
@@ -125,8 +143,7 @@ void updateEncoder()
         if (step != dominantDirection) {
           Serial.printf("🔧 Strong filter: locked to direction %d, ignoring %d\n", 
                        dominantDirection, step);
-          lastPos = newPos;
-          lastValidPos = newPos;
+          dropReversedDetent(delta);
           return;
         }
       } else {
@@ -143,8 +160,7 @@ void updateEncoder()
           if (oppositeCount <= 1) {
             Serial.printf("🔧 Filtered direction glitch: step=%d, dominant=%d\n", 
                          step, dominantDirection);
-            lastPos = newPos;
-            lastValidPos = newPos;
+            dropReversedDetent(delta);
             return;
           }
         }
@@ -157,150 +173,196 @@ void updateEncoder()
       lastScrollDirection = step;
     }
     
-    lastPos = newPos;
-    lastValidPos = newPos;
-    
     // Haptic feedback on encoder tick
     hapticEncoderTick();
 
-    // Take mutex to safely update shared variables
-    if (xSemaphoreTake(displayMutex, 10)) {
+    pendingDetents -= delta;
+    
+    // Fast spins move several rows per detent
+    int rows = step * encoderAccelSteps(accel, lastDetentTime, abs(delta));
+    
+    // SPECIAL HANDLING: Now Playing Volume Control
+    if (currentMenu == MENU_NOW_PLAYING) {
+      volumeModeTicks++;
       
-      // SPECIAL HANDLING: Now Playing Volume Control
-      if (currentMenu == MENU_NOW_PLAYING) {
-        volumeModeTicks++;
-        
-        if (volumeModeTicks >= VOLUME_ACTIVATION_TICKS) {
-          if (!volumeControlActive) {
-            Serial.println("🔊 Entering volume control mode");
-            volumeControlActive = true;
-          }
-          
-          currentVolume += (step * 2);
-          if (currentVolume < 0) currentVolume = 0;
-          if (currentVolume > 100) currentVolume = 100;
-          
-          player.setVolume(currentVolume / 100.0f);
-          lastVolumeChange = millis();
-          displayNeedsUpdate = true;
-          
-          xSemaphoreGive(displayMutex);
-          return;
+      if (volumeModeTicks >= VOLUME_ACTIVATION_TICKS) {
+        if (!volumeControlActive) {
+          Serial.println("🔊 Entering volume control mode");
+          volumeControlActive = true;
         }
-      }
-      
-      // SPECIAL HANDLING: Brightness Control (only when active)
-      else if (brightnessControlActive) {
-        screenBrightness += (step * 5);  // Adjust by 5 per tick
-        if (screenBrightness < 0) screenBrightness = 0;
-        if (screenBrightness > 255) screenBrightness = 255;
         
-        // Update display immediately (no save yet)
-        ledcWrite(BL_PWM_CHANNEL, screenBrightness);
+        currentVolume += (rows * 2);
+        if (currentVolume < 0) currentVolume = 0;
+        if (currentVolume > 100) currentVolume = 100;
         
-        lastBrightnessChange = millis();
-        displayNeedsUpdate = true;
+        setPlaybackVolume(currentVolume);
+        lastVolumeChange = millis();
+        requestDisplayUpdate(DISPLAY_DIRTY_OVERLAY);
         
-        xSemaphoreGive(displayMutex);
         return;
       }
+    }
+    
+    // SPECIAL HANDLING: Brightness Control (only when active)
+    else if (brightnessControlActive) {
+      screenBrightness += (step * 5);  // Adjust by 5 per tick
+      if (screenBrightness < 0) screenBrightness = 0;
+      if (screenBrightness > 255) screenBrightness = 255;
       
-      else {
-        volumeModeTicks = 0;
-        volumeControlActive = false;
+      // Update display immediately (no save yet)
+      ledcWrite(BL_PWM_CHANNEL, screenBrightness);
+      
+      lastBrightnessChange = millis();
+      requestDisplayUpdate(DISPLAY_DIRTY_OVERLAY);
+      
+      return;
+    }
+    
+    else {
+      volumeModeTicks = 0;
+      volumeControlActive = false;
+    }
+    
+    // Handle based on current menu
+    if (currentMenu == MENU_MAIN || currentMenu == MENU_MUSIC || 
+        currentMenu == MENU_SETTINGS || currentMenu == MENU_BLUETOOTH)
+    {
+      int oldIndex = menuIndex;
+      int listSize = currentMenuItems.size();
+      
+      menuIndex += step;
+      
+      if (menuIndex < 0) {
+        menuIndex = 0;
+      } else if (menuIndex >= listSize) {
+        menuIndex = listSize - 1;
       }
       
-      // Handle based on current menu
-      if (currentMenu == MENU_MAIN || currentMenu == MENU_MUSIC || 
-          currentMenu == MENU_SETTINGS || currentMenu == MENU_BLUETOOTH)
-      {
-        int oldIndex = menuIndex;
-        int listSize = currentMenuItems.size();
+      if (oldIndex != menuIndex) {
+        requestDisplayUpdate(DISPLAY_DIRTY_LIST);
         
-        menuIndex += step;
-        
-        if (menuIndex < 0) {
-          menuIndex = 0;
-        } else if (menuIndex >= listSize) {
-          menuIndex = listSize - 1;
-        }
-        
-        if (oldIndex != menuIndex) {
-          displayNeedsUpdate = true;
-          
-          #ifdef DEBUG
-          Serial.printf("Menu: %d -> %d\n", oldIndex, menuIndex);
-          #endif
-        }
+        #ifdef DEBUG
+        Serial.printf("Menu: %d -> %d\n", oldIndex, menuIndex);
+        #endif
       }
-      else if (currentMenu == MENU_ARTIST_LIST && !artists.empty())
-      {
-        int oldIndex = artistIndex;
-        int listSize = artists.size();
-        
-        artistIndex += step;
-        
-        if (artistIndex < 0) {
-          artistIndex = 0;
-        } else if (artistIndex >= listSize) {
-          artistIndex = listSize - 1;
-        }
-        
-        if (oldIndex != artistIndex) {
-          displayNeedsUpdate = true;
-          
-          #ifdef DEBUG
-          Serial.printf("Artist: %d -> %d (%s)\n", 
-                       oldIndex, artistIndex, artists[artistIndex].c_str());
-          #endif
-        }
+    }
+    else if (currentMenu == MENU_ARTIST_LIST && !artists.empty())
+    {
+      int oldIndex = artistIndex;
+      int listSize = artists.size();
+      
+      // A sustained fast spin switches to moving by whole letters
+      if (!letterJumpActive && !artistJumps.empty() &&
+          encoderAccelSpinMs(accel) >= LETTER_JUMP_SPIN_MS) {
+        Serial.println("🔤 Entering letter jump mode");
+        letterJumpActive = true;
+        letterJumpRun = letterJumpRunAt(artistIndex);
       }
-      else if (currentMenu == MENU_ALBUM_LIST && !albums.empty())
-      {
-        int oldIndex = albumIndex;
-        int listSize = albums.size();
-        
-        albumIndex += step;
-        
-        if (albumIndex < 0) {
-          albumIndex = 0;
-        } else if (albumIndex >= listSize) {
-          albumIndex = listSize - 1;
+      
+      if (letterJumpActive) {
+        // Going up from inside a run lands on its first row first
+        int run = letterJumpRun;
+        if (step > 0 || artistIndex == artistJumps[run].row) {
+          run += step;
         }
         
-        if (oldIndex != albumIndex) {
-          displayNeedsUpdate = true;
-          
-          #ifdef DEBUG
-          Serial.printf("Album: %d -> %d (%s)\n", 
-                       oldIndex, albumIndex, albums[albumIndex].c_str());
-          #endif
+        if (run < 0) {
+          run = 0;
+        } else if (run >= (int)artistJumps.size()) {
+          run = artistJumps.size() - 1;
         }
+        
+        letterJumpRun = run;
+        artistIndex = artistJumps[run].row;
+        lastLetterJump = millis();
+        requestDisplayUpdate(DISPLAY_DIRTY_LIST | DISPLAY_DIRTY_OVERLAY);
+      } else {
+        artistIndex += rows;
       }
-      else if (currentMenu == MENU_SONG_LIST && !songs.empty())
-      {
-        int oldIndex = songIndex;
-        int listSize = songs.size();
+      
+      if (artistIndex < 0) {
+        artistIndex = 0;
+      } else if (artistIndex >= listSize) {
+        artistIndex = listSize - 1;
+      }
+      
+      if (oldIndex != artistIndex) {
+        requestDisplayUpdate(DISPLAY_DIRTY_LIST);
         
-        songIndex += step;
+        #ifdef DEBUG
+        Serial.printf("Artist: %d -> %d (%s)\n", 
+                     oldIndex, artistIndex, artists[artistIndex].name.c_str());
+        #endif
+      }
+    }
+    else if (currentMenu == MENU_ALBUM_LIST && !albums.empty())
+    {
+      int oldIndex = albumIndex;
+      int listSize = albums.size();
+      
+      albumIndex += rows;
+      
+      if (albumIndex < 0) {
+        albumIndex = 0;
+      } else if (albumIndex >= listSize) {
+        albumIndex = listSize - 1;
+      }
+      
+      if (oldIndex != albumIndex) {
+        requestDisplayUpdate(DISPLAY_DIRTY_LIST);
         
-        if (songIndex < 0) {
-          songIndex = 0;
-        } else if (songIndex >= listSize) {
-          songIndex = listSize - 1;
-        }
+        #ifdef DEBUG
+        Serial.printf("Album: %d -> %d (%s)\n", 
+                     oldIndex, albumIndex, albums[albumIndex].name.c_str());
+        #endif
+      }
+    }
+    else if (currentMenu == MENU_SONG_LIST && !songs.empty())
+    {
+      int oldIndex = songIndex;
+      int listSize = songs.size();
+      
+      songIndex += rows;
+      
+      if (songIndex < 0) {
+        songIndex = 0;
+      } else if (songIndex >= listSize) {
+        songIndex = listSize - 1;
+      }
+      
+      if (oldIndex != songIndex) {
+        requestDisplayUpdate(DISPLAY_DIRTY_LIST);
         
-        if (oldIndex != songIndex) {
-          displayNeedsUpdate = true;
-          
-          #ifdef DEBUG
-          Serial.printf("Song: %d -> %d (%s)\n", 
-                       oldIndex, songIndex, songs[songIndex].title.c_str());
-          #endif
-        }
+        #ifdef DEBUG
+        Serial.printf("Song: %d -> %d (%s)\n", 
+                     oldIndex, songIndex, songs[songIndex].title.c_str());
+        #endif
+      }
+    }
+    
+    else if (currentMenu == MENU_SEARCH)
+    {
+      // Picker wraps around the alphabet
+      int alphabetSize = strlen(SEARCH_ALPHABET);
+      searchCharIndex = (searchCharIndex + step + alphabetSize) % alphabetSize;
+      requestDisplayUpdate(DISPLAY_DIRTY_LIST);
+    }
+    else if (currentMenu == MENU_SEARCH_RESULTS && !searchResults.empty())
+    {
+      int oldIndex = searchResultIndex;
+      int listSize = searchResults.size();
+      
+      searchResultIndex += rows;
+      
+      if (searchResultIndex < 0) {
+        searchResultIndex = 0;
+      } else if (searchResultIndex >= listSize) {
+        searchResultIndex = listSize - 1;
       }
       
-      xSemaphoreGive(displayMutex);
+      if (oldIndex != searchResultIndex) {
+        requestDisplayUpdate(DISPLAY_DIRTY_LIST);
+      }
     }
   }
   else {
@@ -313,10 +375,17 @@ void updateEncoder()
         Serial.println("🔊 Exiting volume control mode");
         volumeControlActive = false;
         volumeModeTicks = 0;
-        displayNeedsUpdate = true;
+        requestDisplayUpdate(DISPLAY_DIRTY_OVERLAY);
       }
     }
     
+    // Letter jump timeout: drop the overlay, back to row scrolling
+    if (letterJumpActive && millis() - lastLetterJump > LETTER_JUMP_TIMEOUT) {
+      Serial.println("🔤 Exiting letter jump mode");
+      letterJumpActive = false;
+      requestDisplayUpdate(DISPLAY_DIRTY_FULL);
+    }
+    
     // Brightness control timeout - UPDATED
     // Brightness control timeout
     if (brightnessControlActive) {
@@ -328,15 +397,8 @@ void updateEncoder()
         // SAVE ONLY ONCE when exiting
         rougePrefs.saveBrightness(screenBrightness);
         
-        // Force full redraw - NEW
-        if (xSemaphoreTake(displayMutex, 10)) {
-          display.fillScreen(COLOR_BG);
-          xSemaphoreGive(displayMutex);
-        }
-
-        // Force full redraw - UPDATED
-        forceDisplayRedraw = true;
-        displayNeedsUpdate = true;
+        // Full redraw clears the overlay
+        requestDisplayUpdate(DISPLAY_DIRTY_FULL);
       }
     }
     
@@ -0,0 +1,343 @@
+#include "FrameBuffer.h"
+#include <esp_heap_caps.h>
+
+// One row mask per glyph row, bit n = column n lit. Captured from the
+// library's own drawChar so output matches the slow path exactly.
+static uint8_t glyphRows[256][FB_GLYPH_HEIGHT];
+static bool glyphAtlasReady = false;
+
+static void buildGlyphAtlas() {
+  GFXcanvas1 cell(FB_GLYPH_WIDTH, FB_GLYPH_HEIGHT);
+
+  for (int c = 0; c < 256; c++) {
+    cell.fillScreen(0);
+    cell.drawChar(0, 0, c, 1, 0, 1);
+
+    for (int row = 0; row < FB_GLYPH_HEIGHT; row++) {
+      uint8_t bits = 0;
+      for (int col = 0; col < FB_GLYPH_WIDTH; col++) {
+        if (cell.getPixel(col, row)) {
+          bits |= 1 << col;
+        }
+      }
+      glyphRows[c][row] = bits;
+    }
+  }
+
+  glyphAtlasReady = true;
+}
+
+FrameBuffer::FrameBuffer(Adafruit_SPITFT& panel, int16_t w, int16_t h)
+  : Adafruit_GFX(w, h), panel(panel), pixels(NULL), lineBuffer(NULL), bands(NULL),
+    bandCount((h + FB_BAND_HEIGHT - 1) / FB_BAND_HEIGHT) {}
+
+FrameBuffer::~FrameBuffer() {
+  free(pixels);
+  heap_caps_free(lineBuffer);
+  free(bands);
+}
+
+bool FrameBuffer::begin() {
+  if (pixels != NULL) {
+    return true;
+  }
+
+  size_t frameBytes = (size_t)WIDTH * HEIGHT * sizeof(uint16_t);
+  size_t lineBytes = (size_t)WIDTH * FB_BAND_HEIGHT * sizeof(uint16_t);
+
+  uint16_t* frame = (uint16_t*)ps_malloc(frameBytes);
+  uint16_t* line = (uint16_t*)heap_caps_malloc(lineBytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+  Band* dirty = (Band*)malloc(bandCount * sizeof(Band));
+
+  if (frame == NULL || line == NULL || dirty == NULL) {
+    Serial.println("⚠️ Framebuffer allocation failed, drawing direct to panel");
+    free(frame);
+    heap_caps_free(line);
+    free(dirty);
+    return false;
+  }
+
+  pixels = frame;
+  lineBuffer = line;
+  bands = dirty;
+
+  // Start from a black frame; the first flush repaints the whole panel
+  memset(pixels, 0, frameBytes);
+  for (int b = 0; b < bandCount; b++) {
+    bands[b].x0 = 0;
+    bands[b].x1 = WIDTH - 1;
+  }
+
+  if (!glyphAtlasReady) {
+    buildGlyphAtlas();
+  }
+
+  Serial.printf("🖼️ Framebuffer: %u bytes PSRAM, %u byte line buffer\n",
+                (unsigned)frameBytes, (unsigned)lineBytes);
+  return true;
+}
+
+int FrameBuffer::flush() {
+  if (pixels == NULL) {
+    return 0;
+  }
+
+  int sent = 0;
+
+  panel.startWrite();
+  for (int b = 0; b < bandCount; b++) {
+    Band& band = bands[b];
+    if (band.x0 > band.x1) {
+      continue;
+    }
+
+    int16_t y = b * FB_BAND_HEIGHT;
+    int16_t h = HEIGHT - y;
+    if (h > FB_BAND_HEIGHT) h = FB_BAND_HEIGHT;
+    int16_t w = band.x1 - band.x0 + 1;
+
+    // PSRAM isn't DMA-capable: gather the band into internal RAM first
+    uint16_t* dst = lineBuffer;
+    for (int16_t row = 0; row < h; row++) {
+      memcpy(dst, pixels + (y + row) * WIDTH + band.x0, w * sizeof(uint16_t));
+      dst += w;
+    }
+
+    panel.setAddrWindow(band.x0, y, w, h);
+    panel.writePixels(lineBuffer, (uint32_t)w * h);
+
+    band.x0 = WIDTH;
+    band.x1 = -1;
+    sent++;
+  }
+  panel.endWrite();
+
+  return sent;
+}
+
+// Clip to the frame; false when nothing is left
+bool FrameBuffer::clip(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const {
+  if (w < 0) { x += w + 1; w = -w; }
+  if (h < 0) { y += h + 1; h = -h; }
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > WIDTH) w = WIDTH - x;
+  if (y + h > HEIGHT) h = HEIGHT - y;
+  return w > 0 && h > 0;
+}
+
+void FrameBuffer::fill(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (!clip(x, y, w, h)) {
+    return;
+  }
+
+  for (int16_t row = 0; row < h; row++) {
+    uint16_t* dst = pixels + (y + row) * WIDTH + x;
+    for (int16_t col = 0; col < w; col++) {
+      dst[col] = color;
+    }
+  }
+  markDirty(x, y, w, h);
+}
+
+void FrameBuffer::markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
+  int first = y / FB_BAND_HEIGHT;
+  int last = (y + h - 1) / FB_BAND_HEIGHT;
+
+  int16_t right = x + w - 1;
+
+  for (int b = first; b <= last; b++) {
+    if (x < bands[b].x0) bands[b].x0 = x;
+    if (right > bands[b].x1) bands[b].x1 = right;
+  }
+}
+
+// Primitives
+
+void FrameBuffer::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (pixels == NULL) {
+    panel.drawPixel(x, y, color);
+    return;
+  }
+  fill(x, y, 1, 1, color);
+}
+
+void FrameBuffer::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (pixels == NULL) {
+    panel.fillRect(x, y, w, h, color);
+    return;
+  }
+  fill(x, y, w, h, color);
+}
+
+void FrameBuffer::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  if (pixels == NULL) {
+    panel.drawFastHLine(x, y, w, color);
+    return;
+  }
+  fill(x, y, w, 1, color);
+}
+
+void FrameBuffer::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  if (pixels == NULL) {
+    panel.drawFastVLine(x, y, h, color);
+    return;
+  }
+  fill(x, y, 1, h, color);
+}
+
+void FrameBuffer::fillScreen(uint16_t color) {
+  if (pixels == NULL) {
+    panel.fillScreen(color);
+    return;
+  }
+  fill(0, 0, WIDTH, HEIGHT, color);
+}
+
+// Batched variants used inside text and shape drawing. Without a frame
+// they keep the panel's single-transaction behaviour.
+
+void FrameBuffer::startWrite() {
+  if (pixels == NULL) {
+    panel.startWrite();
+  }
+}
+
+void FrameBuffer::endWrite() {
+  if (pixels == NULL) {
+    panel.endWrite();
+  }
+}
+
+void FrameBuffer::writePixel(int16_t x, int16_t y, uint16_t color) {
+  if (pixels == NULL) {
+    panel.writePixel(x, y, color);
+    return;
+  }
+  fill(x, y, 1, 1, color);
+}
+
+void FrameBuffer::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (pixels == NULL) {
+    panel.writeFillRect(x, y, w, h, color);
+    return;
+  }
+  fill(x, y, w, h, color);
+}
+
+void FrameBuffer::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  if (pixels == NULL) {
+    panel.writeFastHLine(x, y, w, color);
+    return;
+  }
+  fill(x, y, w, 1, color);
+}
+
+void FrameBuffer::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  if (pixels == NULL) {
+    panel.writeFastVLine(x, y, h, color);
+    return;
+  }
+  fill(x, y, 1, h, color);
+}
+
+void FrameBuffer::drawMaskWindow(int16_t x, int16_t y, int16_t w, int16_t h,
+                                 const uint8_t* mask, int16_t stride, int16_t maskWidth, int16_t srcX,
+                                 uint16_t fg, uint16_t bg) {
+  // Callers keep windows on screen; anything else is skipped, not clipped
+  if (pixels == NULL || maskWidth <= 0 || x < 0 || y < 0 ||
+      x + w > WIDTH || y + h > HEIGHT) {
+    return;
+  }
+
+  for (int16_t row = 0; row < h; row++) {
+    const uint8_t* bits = mask + row * stride;
+    uint16_t* dst = pixels + (y + row) * WIDTH + x;
+    int16_t col = srcX % maskWidth;
+
+    for (int16_t i = 0; i < w; i++) {
+      dst[i] = (bits[col >> 3] & (0x80 >> (col & 7))) ? fg : bg;
+      if (++col == maskWidth) {
+        col = 0;
+      }
+    }
+  }
+
+  markDirty(x, y, w, h);
+}
+
+// Text
+
+size_t FrameBuffer::write(uint8_t c) {
+  if (pixels == NULL || gfxFont != NULL) {
+    return Adafruit_GFX::write(c);
+  }
+
+  if (c == '\n') {
+    cursor_x = 0;
+    cursor_y += textsize_y * FB_GLYPH_HEIGHT;
+  } else if (c != '\r') {
+    if (wrap && cursor_x + textsize_x * FB_GLYPH_WIDTH > _width) {
+      cursor_x = 0;
+      cursor_y += textsize_y * FB_GLYPH_HEIGHT;
+    }
+    blitGlyph(cursor_x, cursor_y, c, textsize_x, textsize_y, textcolor, textbgcolor);
+    cursor_x += textsize_x * FB_GLYPH_WIDTH;
+  }
+  return 1;
+}
+
+// Copy one glyph cell out of the atlas. Transparent text (bg == fg, as
+// set by setTextColor(fg)) only writes lit pixels.
+void FrameBuffer::blitGlyph(int16_t x, int16_t y, uint8_t c, uint8_t sx, uint8_t sy, uint16_t fg, uint16_t bg) {
+  int16_t w = FB_GLYPH_WIDTH * sx;
+  int16_t h = FB_GLYPH_HEIGHT * sy;
+
+  // Cells crossing an edge take the per-pixel path, which clips
+  if (x < 0 || y < 0 || x + w > WIDTH || y + h > HEIGHT) {
+    Adafruit_GFX::drawChar(x, y, c, fg, bg, sx, sy);
+    return;
+  }
+
+  bool opaque = (bg != fg);
+  const uint8_t* rows = glyphRows[c];
+
+  for (int16_t row = 0; row < FB_GLYPH_HEIGHT; row++) {
+    uint8_t bits = rows[row];
+    if (bits == 0 && !opaque) {
+      continue;
+    }
+
+    uint16_t* line = pixels + (y + row * sy) * WIDTH + x;
+    for (int16_t col = 0; col < FB_GLYPH_WIDTH; col++) {
+      bool lit = bits & (1 << col);
+      if (!lit && !opaque) {
+        continue;
+      }
+      uint16_t color = lit ? fg : bg;
+      uint16_t* dst = line + col * sx;
+      for (uint8_t k = 0; k < sx; k++) {
+        dst[k] = color;
+      }
+    }
+
+    // Repeat the scaled row. Opaque rows are complete, so copy them;
+    // transparent ones must leave unlit pixels alone.
+    for (uint8_t k = 1; k < sy; k++) {
+      uint16_t* next = line + k * WIDTH;
+      if (opaque) {
+        memcpy(next, line, w * sizeof(uint16_t));
+        continue;
+      }
+      for (int16_t col = 0; col < FB_GLYPH_WIDTH; col++) {
+        if (bits & (1 << col)) {
+          for (uint8_t j = 0; j < sx; j++) {
+            next[col * sx + j] = fg;
+          }
+        }
+      }
+    }
+  }
+
+  markDirty(x, y, w, h);
+}
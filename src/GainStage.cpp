@@ -0,0 +1,167 @@
+#include "GainStage.h"
+#include <math.h>
+
+// Saturate to int16. Xtensa LX6 has no packed 16-bit SIMD, but CLAMPS
+// does the saturation in one instruction; the portable form is for host
+// builds.
+#if defined(ESP32) && defined(__XTENSA__)
+static inline int32_t clamp16(int32_t v) {
+    int32_t r;
+    __asm__("clamps %0, %1, 15" : "=a"(r) : "a"(v));
+    return r;
+}
+#else
+static inline int32_t clamp16(int32_t v) {
+    return v > 32767 ? 32767 : (v < -32768 ? -32768 : v);
+}
+#endif
+
+// One stereo frame per 32-bit word (left in the low half), so each frame
+// is a single load and store
+static inline uint32_t scaleFrame(uint32_t frame, int32_t gain) {
+    int32_t l = (int16_t)(frame & 0xFFFF);
+    int32_t r = (int16_t)(frame >> 16);
+    l = clamp16((l * gain + 0x4000) >> 15);
+    r = clamp16((r * gain + 0x4000) >> 15);
+    return (uint16_t)l | ((uint32_t)r << 16);
+}
+
+int32_t volumeToGain(int percent) {
+    if (percent <= 0) {
+        return 0;
+    }
+    if (percent >= 100) {
+        return GAIN_UNITY;
+    }
+    float db = -VOLUME_RANGE_DB * (100 - percent) / 100.0f;
+    return (int32_t)lroundf(GAIN_UNITY * powf(10.0f, db / 20.0f));
+}
+
+int32_t decibelsToGain(int centiDb) {
+    float gain = GAIN_UNITY * powf(10.0f, centiDb / 2000.0f);
+    if (gain >= GAIN_MAX) {
+        return GAIN_MAX;
+    }
+    return gain < 1.0f ? 1 : (int32_t)lroundf(gain);
+}
+
+void applyGain(uint32_t* frames, uint32_t count, int32_t gain) {
+    if (gain == GAIN_UNITY) {
+        return;
+    }
+
+    uint32_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        uint32_t a = frames[i];
+        uint32_t b = frames[i + 1];
+        frames[i] = scaleFrame(a, gain);
+        frames[i + 1] = scaleFrame(b, gain);
+    }
+    if (i < count) {
+        frames[i] = scaleFrame(frames[i], gain);
+    }
+}
+
+// Both factors are at most 2^16, so the product fits unsigned and the
+// result is at most GAIN_MAX
+static inline int32_t combineGain(int32_t a, int32_t b) {
+    return ((uint32_t)a * (uint32_t)b) >> 15;
+}
+
+// Volume moving by `step` every frame, both << GAIN_RAMP_SHIFT, times a
+// fixed track gain; returns the volume after the last frame
+static int32_t rampGain(uint32_t* frames, uint32_t count, int32_t fine, int32_t step, int32_t track) {
+    for (uint32_t i = 0; i < count; i++) {
+        frames[i] = scaleFrame(frames[i], combineGain(fine >> GAIN_RAMP_SHIFT, track));
+        fine += step;
+    }
+    return fine;
+}
+
+GainStage::GainStage(Print& out)
+    : output(out), target(GAIN_UNITY), trackGain(GAIN_UNITY), current(GAIN_UNITY << GAIN_RAMP_SHIFT), step(0),
+      rampTarget(GAIN_UNITY), rampFrames(0) {}
+
+void GainStage::setVolume(int percent) {
+    target = volumeToGain(percent);
+}
+
+void GainStage::setTrackGain(int32_t gain) {
+    trackGain = constrain(gain, 0, GAIN_MAX);
+}
+
+size_t GainStage::write(uint8_t b) {
+    return 1;  // Decoders only write whole frames
+}
+
+size_t GainStage::write(const uint8_t* data, size_t len) {
+    uint32_t block[GAIN_BLOCK_FRAMES];
+    size_t frames = len / 4;
+
+    while (frames > 0) {
+        uint32_t n = min(frames, (size_t)GAIN_BLOCK_FRAMES);
+        memcpy(block, data, n * 4);
+
+        // A new volume restarts the ramp from wherever it is now; the track
+        // gain applies as it stands
+        int32_t want = target;
+        int32_t track = trackGain;
+        if (want != rampTarget) {
+            rampTarget = want;
+            rampFrames = GAIN_RAMP_FRAMES;
+            step = want - (current >> GAIN_RAMP_SHIFT);  // Delta / GAIN_RAMP_FRAMES, scaled
+        }
+
+        uint32_t ramped = 0;
+        if (rampFrames > 0) {
+            ramped = min(n, rampFrames);
+            current = rampGain(block, ramped, current, step, track);
+            rampFrames -= ramped;
+            if (rampFrames == 0) {
+                current = rampTarget << GAIN_RAMP_SHIFT;
+            }
+        }
+        applyGain(block + ramped, n - ramped, combineGain(current >> GAIN_RAMP_SHIFT, track));
+
+        output.write((const uint8_t*)block, n * 4);
+        data += n * 4;
+        frames -= n;
+    }
+    return len;
+}
+
+#ifdef DEBUG
+void benchmarkGain() {
+    const uint32_t frames = GAIN_BLOCK_FRAMES;
+    const int rounds = 200;
+    static uint32_t block[GAIN_BLOCK_FRAMES];
+
+    for (uint32_t i = 0; i < frames; i++) {
+        block[i] = (uint16_t)(i * 97) | ((uint32_t)(uint16_t)(i * -89) << 16);
+    }
+
+    uint32_t start = micros();
+    for (int r = 0; r < rounds; r++) {
+        applyGain(block, frames, volumeToGain(60));
+    }
+    uint32_t fixedMicros = micros() - start;
+
+    // What the float volume path did: multiply, clip, store
+    int16_t* samples = (int16_t*)block;
+    volatile float volume = 0.6f;
+    start = micros();
+    for (int r = 0; r < rounds; r++) {
+        float v = volume;
+        for (uint32_t i = 0; i < frames * 2; i++) {
+            float s = samples[i] * v;
+            samples[i] = s > 32767.0f ? 32767 : (s < -32768.0f ? -32768 : (int16_t)s);
+        }
+    }
+    uint32_t floatMicros = micros() - start;
+
+    uint32_t total = frames * 2 * rounds;
+    Serial.printf("🔊 Gain kernel: Q15 %.1f samples/us, float %.1f samples/us\n",
+                  (float)total / max(fixedMicros, (uint32_t)1),
+                  (float)total / max(floatMicros, (uint32_t)1));
+}
+#endif
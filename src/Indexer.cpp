@@ -1,9 +1,93 @@
 #include "Indexer.h"
 #include "Database.h"
+#include "LibraryImage.h"
 
 SdFat32 sd;
 
-bool loadDatabase() {
+volatile LibraryState libraryState = LIBRARY_IDLE;
+volatile int libraryLoadPercent = 0;
+
+#ifdef DEBUG
+// Keyset-walk every artist plus the albums and songs of the first few
+// artists, the same access pattern as scrolling the library lists
+template <typename Backend>
+static unsigned long timeLibraryWalk(Backend& backend, int artistSample) {
+    StringArena strings[2];
+    if (!strings[0].begin(PAGE_ARENA_BYTES) || !strings[1].begin(PAGE_ARENA_BYTES)) {
+        return 0;
+    }
+
+    unsigned long start = micros();
+    std::vector<Artist> artistPage;
+    std::vector<int> sampled;
+    int current = 0;
+
+    // Alternate arenas so the previous page's anchor stays readable
+    backend.fetchArtists(PAGE_AT_OFFSET, NULL, 0, PAGE_SIZE, strings[current], artistPage);
+    while (!artistPage.empty()) {
+        for (const Artist& artist : artistPage) {
+            if ((int)sampled.size() < artistSample) sampled.push_back(artist.id);
+        }
+        Artist anchor = artistPage.back();
+        artistPage.clear();
+        current = 1 - current;
+        strings[current].reset();
+        backend.fetchArtists(PAGE_AFTER, &anchor, 0, PAGE_SIZE, strings[current], artistPage);
+    }
+
+    std::vector<Album> albumPage;
+    std::vector<Song> songPage;
+    for (int artistId : sampled) {
+        albumPage.clear();
+        strings[0].reset();
+        backend.fetchAlbums(artistId, PAGE_AT_OFFSET, NULL, 0, PAGE_SIZE, strings[0], albumPage);
+        for (const Album& album : albumPage) {
+            songPage.clear();
+            strings[1].reset();
+            backend.fetchSongs(album.id, PAGE_AT_OFFSET, NULL, 0, PAGE_SIZE, strings[1], songPage);
+        }
+    }
+
+    return micros() - start;
+}
+
+static void benchmarkLibraryBackends() {
+    if (!musicDB.open("music.db")) {
+        return;
+    }
+
+    const int sample = 32;
+    unsigned long sqliteMicros = timeLibraryWalk(musicDB, sample);
+    unsigned long imageMicros = timeLibraryWalk(libraryImage, sample);
+
+    Serial.println("⏱️ Library walk (all artists, albums+songs of first 32):");
+    Serial.printf("   SQLite: %lu us\n", sqliteMicros);
+    Serial.printf("   Image:  %lu us\n", imageMicros);
+
+    musicDB.close();
+}
+#endif
+
+// Music.lib wins when present: listing from it needs no SQL engine
+static bool useLibraryImage() {
+    return libraryImage.isLoaded();
+}
+
+bool loadDatabase(LoadProgressCallback progress) {
+    if (sd.exists(LIBRARY_IMAGE_PATH) && libraryImage.load(LIBRARY_IMAGE_PATH, progress)) {
+        Serial.println("✅ Library image loaded successfully");
+        Serial.printf("   Artists: %d, Albums: %d, Songs: %d\n",
+                      libraryImage.getArtistCount(), libraryImage.getAlbumCount(),
+                      libraryImage.getSongCount());
+
+#ifdef DEBUG
+        if (sd.exists("music.db")) {
+            benchmarkLibraryBackends();
+        }
+#endif
+        return true;
+    }
+
     // Check if database file exists
     if (!sd.exists("music.db")) {
         Serial.println("❌ music.db not found on SD card!");
@@ -19,7 +103,7 @@ bool loadDatabase() {
     }
     
     // Open the database
-    if (!musicDB.open("music.db")) {
+    if (!musicDB.open("music.db", progress)) {
         Serial.println("❌ Failed to open music.db");
         return false;
     }
@@ -36,58 +120,164 @@ bool loadDatabase() {
     return true;
 }
 
+// ============================================================================
+// BACKGROUND LOAD (SD -> PSRAM off the main task so the UI comes up first)
+// ============================================================================
+
+static void reportLoadProgress(size_t loaded, size_t total) {
+    if (total > 0) {
+        libraryLoadPercent = (int)((uint64_t)loaded * 100 / total);
+    }
+}
+
+static void libraryLoadTask(void* parameter) {
+    unsigned long start = millis();
+    Serial.println("📚 Library load task started");
+
+    bool ok = loadDatabase(reportLoadProgress) && buildArtistList();
+
+    libraryLoadPercent = 100;
+    libraryState = ok ? LIBRARY_READY : LIBRARY_FAILED;
+    Serial.printf("%s Library load %s in %lu ms\n", ok ? "✅" : "❌",
+                  ok ? "finished" : "failed", millis() - start);
+
+    vTaskDelete(NULL);
+}
+
+bool startLibraryLoad() {
+    if (libraryState == LIBRARY_LOADING) {
+        Serial.println("⚠️ Library load already running!");
+        return false;
+    }
+
+    libraryLoadPercent = 0;
+    libraryState = LIBRARY_LOADING;
+
+    // Core 0 alongside the spinner and Bluetooth stack; loop() stays on core 1
+    BaseType_t result = xTaskCreatePinnedToCore(
+        libraryLoadTask,
+        "LibraryLoad",
+        8192,
+        NULL,
+        1,
+        NULL,
+        0
+    );
+
+    if (result != pdPASS) {
+        Serial.println("❌ Failed to create library load task!");
+        libraryState = LIBRARY_FAILED;
+        return false;
+    }
+
+    return true;
+}
+
+// ============================================================================
+// PAGE SOURCES (rows for the windowed library lists)
+// ============================================================================
+
+int PageSource<Artist>::count(int parentId) {
+    if (useLibraryImage()) return libraryImage.getArtistCount();
+    return musicDB.getArtistCount();
+}
+
+int PageSource<Artist>::fetch(int parentId, PageDirection dir, const Artist* anchor,
+                              int offset, int limit, StringArena& strings, std::vector<Artist>& out) {
+    if (useLibraryImage()) return libraryImage.fetchArtists(dir, anchor, offset, limit, strings, out);
+    return musicDB.fetchArtists(dir, anchor, offset, limit, strings, out);
+}
+
+int PageSource<Album>::count(int artistId) {
+    if (useLibraryImage()) return libraryImage.getAlbumCountByArtist(artistId);
+    return musicDB.getAlbumCountByArtist(artistId);
+}
+
+int PageSource<Album>::fetch(int artistId, PageDirection dir, const Album* anchor,
+                             int offset, int limit, StringArena& strings, std::vector<Album>& out) {
+    if (useLibraryImage()) return libraryImage.fetchAlbums(artistId, dir, anchor, offset, limit, strings, out);
+    return musicDB.fetchAlbums(artistId, dir, anchor, offset, limit, strings, out);
+}
+
+int PageSource<Song>::count(int albumId) {
+    if (useLibraryImage()) return libraryImage.getSongCountByAlbum(albumId);
+    return musicDB.getSongCountByAlbum(albumId);
+}
+
+int PageSource<Song>::fetch(int albumId, PageDirection dir, const Song* anchor,
+                            int offset, int limit, StringArena& strings, std::vector<Song>& out) {
+    if (useLibraryImage()) return libraryImage.fetchSongs(albumId, dir, anchor, offset, limit, strings, out);
+    return musicDB.fetchSongs(albumId, dir, anchor, offset, limit, strings, out);
+}
+
+// ============================================================================
+// LIST BUILDERS (only counts are loaded here; rows are paged in on demand)
+// ============================================================================
+
 bool buildArtistList() {
-    artists.clear();
-    
-    // Query database for artists
-    artists = musicDB.getArtistNames();
-    
-    if (artists.empty()) {
+    if (artists.reset(-1) == 0) {
         Serial.println("⚠️ No artists found in database");
         return false;
     }
     
-    // Serial.printf("✅ Loaded %d artists\n", artists.size());
+    // Loaded once here so letter scrolling never queries
+    artistJumps.clear();
+    if (useLibraryImage()) {
+        libraryImage.fetchArtistJumps(artistJumps);
+    } else {
+        musicDB.fetchArtistJumps(artistJumps);
+    }
+    
+    Serial.printf("✅ %d artists available (%d letter jumps)\n", artists.size(), (int)artistJumps.size());
     return true;
 }
 
-bool buildAlbumList(const std::string &artist) {
-    albums.clear();
-    
-    if (artist.empty()) {
-        Serial.println("❌ Artist name is empty!");
+bool buildAlbumList(const Artist &artist) {
+    if (artist.id < 0) {
+        Serial.println("❌ Artist id is invalid!");
+        albums.clear();
         return false;
     }
     
-    // Query database for albums by artist
-    albums = musicDB.getAlbumNamesByArtist(artist);
-    
-    if (albums.empty()) {
-        Serial.printf("⚠️ Artist '%s' has no albums\n", artist.c_str());
+    if (albums.reset(artist.id) == 0) {
+        Serial.printf("⚠️ Artist '%s' has no albums\n", artist.name.c_str());
         return false;
     }
     
-    // Serial.printf("✅ Loaded %d albums for %s\n", albums.size(), artist.c_str());
+    // Serial.printf("✅ %d albums for %s\n", albums.size(), artist.name.c_str());
     return true;
 }
 
-bool buildSongList(const std::string &artist, const std::string &album) {
-    songs.clear();
-    
-    if (artist.empty() || album.empty()) {
-        Serial.println("❌ Artist or album name is empty!");
+bool buildSongList(const Album &album) {
+    if (album.id < 0) {
+        Serial.println("❌ Album id is invalid!");
+        songs.clear();
         return false;
     }
     
-    // Query database for songs
-    songs = musicDB.getSongsByAlbum(artist, album);
-    
-    if (songs.empty()) {
-        Serial.printf("⚠️ No songs found for %s - %s\n", artist.c_str(), album.c_str());
+    if (songs.reset(album.id) == 0) {
+        Serial.printf("⚠️ No songs found for album '%s'\n", album.name.c_str());
         return false;
     }
     
-    // Serial.printf("✅ Loaded %d songs from %s - %s\n", 
-    //               songs.size(), artist.c_str(), album.c_str());
+    // Serial.printf("✅ %d songs from %s\n", songs.size(), album.name.c_str());
     return true;
-}
\ No newline at end of file
+}
+
+// ============================================================================
+// SEARCH
+// ============================================================================
+
+bool librarySearchAvailable() {
+    return libraryReady() && !useLibraryImage();
+}
+
+int searchLibrary(const char* prefix, int limit, StringArena& strings, std::vector<SearchResult>& out) {
+    if (!librarySearchAvailable()) return 0;
+    return musicDB.search(prefix, limit, strings, out);
+}
+
+bool locateSearchResult(const SearchResult& result, SearchLocation& where) {
+    if (!librarySearchAvailable()) return false;
+    return musicDB.locate(result, where);
+}
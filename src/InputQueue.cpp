@@ -0,0 +1,37 @@
+#include "InputQueue.h"
+#include "EncoderModule.h"
+#include "Buttons.h"
+
+SpscRing<InputEvent, INPUT_QUEUE_SIZE> inputQueue;
+
+void IRAM_ATTR postInputEvent(InputEventType type, int value)
+{
+  InputEvent event;
+  event.timeMs = millis();
+  event.type = type;
+  event.value = value;
+  inputQueue.push(event);
+}
+
+void processInputEvents()
+{
+  static uint32_t reportedDrops = 0;
+  InputEvent event;
+
+  while (inputQueue.pop(event)) {
+    switch (event.type) {
+      case INPUT_ENCODER:
+        queueEncoderDetents(event.value, event.timeMs);
+        break;
+      case INPUT_BUTTON:
+      case INPUT_BUTTON_UP:
+        queueButtonEdge(event.value, event.type == INPUT_BUTTON, event.timeMs);
+        break;
+    }
+  }
+
+  if (inputQueue.dropped() != reportedDrops) {
+    reportedDrops = inputQueue.dropped();
+    Serial.printf("⚠️ Input queue full, %lu events dropped\n", (unsigned long)reportedDrops);
+  }
+}
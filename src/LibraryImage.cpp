@@ -0,0 +1,272 @@
+#include "LibraryImage.h"
+#include "SdLoader.h"
+
+LibraryImage libraryImage;
+
+LibraryImage::LibraryImage()
+    : data(nullptr), size(0), header(nullptr), artistTable(nullptr),
+      albumTable(nullptr), songTable(nullptr), jumpTable(nullptr), strings(nullptr) {}
+
+LibraryImage::~LibraryImage() {
+    close();
+}
+
+// Resolve a page request to the index range [first, last) of a list with
+// `count` rows. anchorPos is the anchor row's position within the list.
+static void pageRange(PageDirection dir, int anchorPos, int offset, int limit, int count,
+                      int& first, int& last) {
+    switch (dir) {
+        case PAGE_AFTER:
+            first = anchorPos + 1;
+            last = first + limit;
+            break;
+        case PAGE_BEFORE:
+            last = anchorPos;
+            first = last - limit;
+            break;
+        default:
+            first = offset;
+            last = first + limit;
+            break;
+    }
+
+    if (first < 0) first = 0;
+    if (last > count) last = count;
+    if (last < first) last = first;
+}
+
+bool LibraryImage::load(const char* sdPath, LoadProgressCallback progress) {
+    Serial.printf("📦 Loading library image to PSRAM: %s\n", sdPath);
+
+    size_t fileSize = 0;
+    uint8_t* buffer = loadFileToPsram(sdPath, fileSize, progress);
+    if (!buffer) {
+        return false;
+    }
+
+    if (fileSize < sizeof(LibraryImageHeader)) {
+        Serial.println("❌ Library image too small");
+        free(buffer);
+        return false;
+    }
+
+    close();
+    data = buffer;
+    size = fileSize;
+
+    if (!validate()) {
+        close();
+        return false;
+    }
+
+    Serial.printf("✅ Library image loaded (%u artists, %u albums, %u songs)\n",
+                  header->artistCount, header->albumCount, header->songCount);
+    return true;
+}
+
+// Check the header, that every table lies inside the buffer and that every
+// record's ranges, back-references and string offsets stay inside their
+// tables, so queries can index records without further bounds checks
+bool LibraryImage::validate() {
+    header = (const LibraryImageHeader*)data;
+
+    if (memcmp(header->magic, "RLIB", 4) != 0 || header->version != LIBRARY_IMAGE_VERSION) {
+        Serial.println("❌ Not a supported library image");
+        return false;
+    }
+
+    struct Table { uint32_t offset; uint32_t count; uint32_t recordSize; };
+    const Table tables[] = {
+        { header->artistTable, header->artistCount, sizeof(ArtistRecord) },
+        { header->albumTable, header->albumCount, sizeof(AlbumRecord) },
+        { header->songTable, header->songCount, sizeof(SongRecord) },
+        { header->jumpTable, header->jumpCount, sizeof(JumpRecord) },
+        { header->stringPool, header->stringPoolSize, 1 },
+    };
+
+    for (const Table& t : tables) {
+        uint64_t end = (uint64_t)t.offset + (uint64_t)t.count * t.recordSize;
+        if ((t.offset % 4) != 0 || end > size) {
+            Serial.println("❌ Library image table out of bounds");
+            return false;
+        }
+    }
+
+    // Pool must end in a terminator so no string can run past the buffer
+    if (header->stringPoolSize == 0 || data[header->stringPool + header->stringPoolSize - 1] != 0) {
+        Serial.println("❌ Library image string pool corrupt");
+        return false;
+    }
+
+    artistTable = (const ArtistRecord*)(data + header->artistTable);
+    albumTable = (const AlbumRecord*)(data + header->albumTable);
+    songTable = (const SongRecord*)(data + header->songTable);
+    jumpTable = (const JumpRecord*)(data + header->jumpTable);
+    strings = (const char*)(data + header->stringPool);
+
+    if (!validateRecords()) {
+        Serial.println("❌ Library image records corrupt");
+        return false;
+    }
+    return true;
+}
+
+// Child ranges are checked as first <= total && count <= total - first so
+// no sum can wrap
+bool LibraryImage::validateRecords() const {
+    const uint32_t pool = header->stringPoolSize;
+
+    for (uint32_t i = 0; i < header->artistCount; i++) {
+        const ArtistRecord& r = artistTable[i];
+        if (r.name >= pool || r.displayName >= pool ||
+            r.firstAlbum > header->albumCount || r.albumCount > header->albumCount - r.firstAlbum) {
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < header->albumCount; i++) {
+        const AlbumRecord& r = albumTable[i];
+        if (r.name >= pool || r.displayName >= pool || r.artist >= header->artistCount ||
+            r.firstSong > header->songCount || r.songCount > header->songCount - r.firstSong) {
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < header->songCount; i++) {
+        const SongRecord& r = songTable[i];
+        if (r.title >= pool || r.displayName >= pool || r.path >= pool ||
+            r.album >= header->albumCount) {
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < header->jumpCount; i++) {
+        if (jumpTable[i].row >= header->artistCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LibraryImage::close() {
+    if (data) {
+        free(data);
+        data = nullptr;
+        size = 0;
+        header = nullptr;
+        artistTable = nullptr;
+        albumTable = nullptr;
+        songTable = nullptr;
+        jumpTable = nullptr;
+        strings = nullptr;
+        Serial.println("📦 Library image closed");
+    }
+}
+
+const char* LibraryImage::str(uint32_t offset) const {
+    return offset < header->stringPoolSize ? strings + offset : "";
+}
+
+int LibraryImage::fetchArtists(PageDirection dir, const Artist* anchor, int offset, int limit,
+                               StringArena& strings, std::vector<Artist>& out) const {
+    if (!data || (dir != PAGE_AT_OFFSET && !anchor)) return 0;
+
+    int first, last;
+    pageRange(dir, anchor ? anchor->id : 0, offset, limit, header->artistCount, first, last);
+
+    for (int i = first; i < last; i++) {
+        Artist artist;
+        artist.id = i;
+        artist.name = StringRef(str(artistTable[i].name));
+        artist.displayName = StringRef(str(artistTable[i].displayName));
+        out.push_back(artist);
+    }
+    return last - first;
+}
+
+int LibraryImage::fetchAlbums(int artistId, PageDirection dir, const Album* anchor, int offset, int limit,
+                              StringArena& strings, std::vector<Album>& out) const {
+    if (!data || artistId < 0 || artistId >= (int)header->artistCount) return 0;
+    if (dir != PAGE_AT_OFFSET && !anchor) return 0;
+
+    const ArtistRecord& artist = artistTable[artistId];
+    int base = artist.firstAlbum;
+    int count = artist.albumCount;  // Range checked by validate()
+
+    int first, last;
+    pageRange(dir, anchor ? anchor->id - base : 0, offset, limit, count, first, last);
+
+    for (int i = base + first; i < base + last; i++) {
+        Album album;
+        album.id = i;
+        album.artistId = albumTable[i].artist;
+        album.name = StringRef(str(albumTable[i].name));
+        album.displayName = StringRef(str(albumTable[i].displayName));
+        album.year = albumTable[i].year;
+        out.push_back(album);
+    }
+    return last - first;
+}
+
+int LibraryImage::fetchSongs(int albumId, PageDirection dir, const Song* anchor, int offset, int limit,
+                             StringArena& strings, std::vector<Song>& out) const {
+    if (!data || albumId < 0 || albumId >= (int)header->albumCount) return 0;
+    if (dir != PAGE_AT_OFFSET && !anchor) return 0;
+
+    const AlbumRecord& album = albumTable[albumId];
+    int base = album.firstSong;
+    int count = album.songCount;  // Range checked by validate()
+
+    int first, last;
+    pageRange(dir, anchor ? anchor->id - base : 0, offset, limit, count, first, last);
+
+    for (int i = base + first; i < base + last; i++) {
+        const SongRecord& record = songTable[i];
+        Song song;
+        song.id = i;
+        song.albumId = record.album;
+        song.title = StringRef(str(record.title));
+        song.displayName = StringRef(str(record.displayName));
+        song.path = StringRef(str(record.path));
+        song.track = record.track;
+        song.duration = record.duration;
+        song.gain.track = record.trackGain;
+        song.gain.album = record.albumGain;
+        out.push_back(song);
+    }
+    return last - first;
+}
+
+int LibraryImage::fetchArtistJumps(std::vector<LetterJump>& out) const {
+    if (!data) return 0;
+
+    for (uint32_t i = 0; i < header->jumpCount; i++) {
+        LetterJump jump;
+        jump.row = jumpTable[i].row;
+        jump.letter = (char)jumpTable[i].letter;
+        out.push_back(jump);
+    }
+    return header->jumpCount;
+}
+
+int LibraryImage::getAlbumCountByArtist(int artistId) const {
+    if (!data || artistId < 0 || artistId >= (int)header->artistCount) return 0;
+    return artistTable[artistId].albumCount;
+}
+
+int LibraryImage::getSongCountByAlbum(int albumId) const {
+    if (!data || albumId < 0 || albumId >= (int)header->albumCount) return 0;
+    return albumTable[albumId].songCount;
+}
+
+int LibraryImage::getSongCount() const {
+    return data ? header->songCount : 0;
+}
+
+int LibraryImage::getArtistCount() const {
+    return data ? header->artistCount : 0;
+}
+
+int LibraryImage::getAlbumCount() const {
+    return data ? header->albumCount : 0;
+}
@@ -0,0 +1,79 @@
+#include "Marquee.h"
+#include "Display.h"
+#include <string.h>
+
+#define MARQUEE_HEIGHT (FB_GLYPH_HEIGHT * MARQUEE_TEXT_SIZE)
+#define MARQUEE_STRIP_MAX ((MARQUEE_TEXT_MAX + MARQUEE_GAP_CHARS) * FB_GLYPH_WIDTH * MARQUEE_TEXT_SIZE)
+
+Marquee::Marquee()
+  : strip(NULL), stripWidth(0), x(0), y(0), width(0), fg(0), bg(0),
+    offset(0), pauseUntil(0), running(false) {
+  text[0] = '\0';
+}
+
+Marquee::~Marquee() {
+  delete strip;
+}
+
+bool Marquee::show(const char* newText, int16_t newX, int16_t newY, int16_t w, uint16_t newFg, uint16_t newBg) {
+  int16_t textWidth = FrameBuffer::textWidth(newText, MARQUEE_TEXT_SIZE);
+
+  if (!display.active() || textWidth <= w) {
+    running = false;
+    return false;
+  }
+
+  bool same = running && strcmp(text, newText) == 0 && x == newX && y == newY &&
+              width == w && fg == newFg && bg == newBg;
+
+  if (!same) {
+    // One ~3 KB strip, reused for every text
+    if (strip == NULL) {
+      strip = new GFXcanvas1(MARQUEE_STRIP_MAX, MARQUEE_HEIGHT);
+    }
+
+    strncpy(text, newText, MARQUEE_TEXT_MAX - 1);
+    text[MARQUEE_TEXT_MAX - 1] = '\0';
+
+    strip->fillScreen(0);
+    strip->setTextWrap(false);
+    strip->setTextSize(MARQUEE_TEXT_SIZE);
+    strip->setTextColor(1);
+    strip->setCursor(0, 0);
+    strip->print(text);
+
+    stripWidth = FrameBuffer::textWidth(text, MARQUEE_TEXT_SIZE) +
+                 MARQUEE_GAP_CHARS * FB_GLYPH_WIDTH * MARQUEE_TEXT_SIZE;
+    x = newX;
+    y = newY;
+    width = w;
+    fg = newFg;
+    bg = newBg;
+    offset = 0;
+    pauseUntil = millis() + MARQUEE_PAUSE_MS;
+    running = true;
+  }
+
+  draw();
+  return true;
+}
+
+void Marquee::tick(uint32_t nowMs) {
+  if (!running || (int32_t)(nowMs - pauseUntil) < 0) {
+    return;
+  }
+
+  offset += MARQUEE_STEP;
+  if (offset >= stripWidth) {
+    // Back at the start: hold again before the next pass
+    offset = 0;
+    pauseUntil = nowMs + MARQUEE_PAUSE_MS;
+  }
+
+  draw();
+}
+
+void Marquee::draw() {
+  display.drawMaskWindow(x, y, width, MARQUEE_HEIGHT, strip->getBuffer(),
+                         (MARQUEE_STRIP_MAX + 7) / 8, stripWidth, offset, fg, bg);
+}
@@ -5,6 +5,129 @@
 #include "State.h"
 #include "Haptics.h"
 #include "Preferences.h"
+#include "Crossfade.h"
+
+// Make the artist/album at the given list position the current one
+static void selectArtist(int index)
+{
+  currentArtist = artists[index].name;
+  currentArtistId = artists[index].id;
+}
+
+static void selectAlbum(int index)
+{
+  currentAlbum = albums[index].name;
+  currentAlbumId = albums[index].id;
+}
+
+// Play songs[songIndex], or resume/show it if it is already loaded
+static void playSelectedSong()
+{
+  const Song& selectedSong = songs[songIndex];
+  
+  // Check if this is the currently playing/paused song
+  bool isSameSong = (selectedSong.id == currentSongId);
+  
+  if (isSameSong && (player_state == STATE_PLAYING || player_state == STATE_PAUSED)) {
+    // Same song is already loaded
+    if (player_state == STATE_PAUSED) {
+      Serial.println("Same song paused, resuming playback");
+      resumePlayback();
+    } else {
+      Serial.println("Same song playing, navigating to Now Playing");
+    }
+    navigateToMenu(MENU_NOW_PLAYING);
+  } else {
+    // Different song OR nothing playing - need to start fresh
+    if (player_state != STATE_STOPPED) {
+      // CRITICAL: Stop current playback first if anything is playing/paused
+      Serial.println("Stopping current playback before starting new song");
+      stopPlayback();  // This properly stops and resets everything
+      delay(100);      // Give it time to clean up
+    }
+    
+    Serial.println("Starting new song");
+    playCurrentSong(false);
+    navigateToMenu(MENU_NOW_PLAYING);
+  }
+}
+
+// Picker: '<' deletes, '>' opens the results, anything else is typed
+static void handleSearchCharacter()
+{
+  char c = SEARCH_ALPHABET[searchCharIndex];
+  
+  if (c == '>') {
+    if (searchResults.empty()) {
+      hapticError();
+      return;
+    }
+    hapticSelection();
+    navigateToMenu(MENU_SEARCH_RESULTS);
+    return;
+  }
+  
+  if (c == '<') {
+    if (searchQuery.empty()) {
+      hapticError();
+      return;
+    }
+    searchQuery.erase(searchQuery.size() - 1);
+    hapticBack();
+  } else {
+    if (searchQuery.size() >= SEARCH_QUERY_MAX) {
+      hapticError();
+      return;
+    }
+    searchQuery += c;
+    hapticSelection();
+  }
+  
+  updateSearchResults();
+}
+
+// Jump into the library lists at a search result. Artists open their
+// albums, albums their songs, and songs start playing.
+static void openSearchResult(const SearchResult& result)
+{
+  SearchLocation where;
+  if (!locateSearchResult(result, where)) {
+    Serial.println("❌ Search result not found in library");
+    hapticError();
+    return;
+  }
+  
+  hapticSelection();
+  
+  artistIndex = where.artistIndex;
+  selectArtist(artistIndex);
+  if (!buildAlbumList(artists[artistIndex])) {
+    hapticError();
+    return;
+  }
+  
+  if (result.kind == SEARCH_ARTIST) {
+    albumIndex = 0;
+    navigateToMenu(MENU_ALBUM_LIST);
+    return;
+  }
+  
+  albumIndex = where.albumIndex;
+  selectAlbum(albumIndex);
+  if (!buildSongList(albums[albumIndex])) {
+    hapticError();
+    return;
+  }
+  
+  if (result.kind == SEARCH_ALBUM) {
+    songIndex = 0;
+    navigateToMenu(MENU_SONG_LIST);
+    return;
+  }
+  
+  songIndex = where.songIndex;
+  playSelectedSong();
+}
 
 void handleButtonPress(int buttonIndex)
 {
@@ -65,7 +188,7 @@ void handleCenter()
         }
         
         buildBluetoothMenu();
-        displayNeedsUpdate = true;
+        requestDisplayUpdate(DISPLAY_DIRTY_LIST);
       }
       
       if (currentMenu == MENU_SETTINGS) {
@@ -74,16 +197,45 @@ void handleCenter()
           Serial.println("🔆 Entering brightness adjustment");
           brightnessControlActive = true;
           lastBrightnessChange = millis();
-          displayNeedsUpdate = true;
+          requestDisplayUpdate(DISPLAY_DIRTY_OVERLAY);
           hapticSelection();
           return;
-        }        
+        }
+        
+        // Crossfade steps up to the maximum, then back to off
+        if (item.label.find("Crossfade:") == 0) {
+          crossfadeSeconds += CROSSFADE_STEP_SECONDS;
+          if (crossfadeSeconds > CROSSFADE_MAX_SECONDS) {
+            crossfadeSeconds = 0;
+          }
+          rougePrefs.saveCrossfade(crossfadeSeconds);
+          
+          int keepIndex = menuIndex;
+          buildSettingsMenu();
+          menuIndex = keepIndex;
+          requestDisplayUpdate(DISPLAY_DIRTY_LIST);
+          hapticSelection();
+          return;
+        }
+        
+        // Loudness cycles off, track, album
+        if (item.label.find("Loudness:") == 0) {
+          replayGainMode = (replayGainMode + 1) % REPLAY_GAIN_MODE_COUNT;
+          rougePrefs.saveReplayGainMode(replayGainMode);
+          
+          int keepIndex = menuIndex;
+          buildSettingsMenu();
+          menuIndex = keepIndex;
+          requestDisplayUpdate(DISPLAY_DIRTY_LIST);
+          hapticSelection();
+          return;
+        }
         return;
       }
       
       // Navigate to selected menu
       navigateToMenu(item.action);
-      displayNeedsUpdate = true;
+      requestDisplayUpdate(DISPLAY_DIRTY_LIST);
     }
     return;
   }
@@ -98,11 +250,11 @@ void handleCenter()
   if (currentMenu == MENU_ARTIST_LIST)
   {
     if (artistIndex >= 0 && artistIndex < (int)artists.size()) {
-      currentArtist = artists[artistIndex];
+      selectArtist(artistIndex);
       
       hapticSelection();
       
-      if (buildAlbumList(currentArtist)) {
+      if (buildAlbumList(artists[artistIndex])) {
         navigateToMenu(MENU_ALBUM_LIST);
         albumIndex = 0;
       } else {
@@ -116,11 +268,11 @@ void handleCenter()
   else if (currentMenu == MENU_ALBUM_LIST)
   {
     if (albumIndex >= 0 && albumIndex < (int)albums.size()) {
-      currentAlbum = albums[albumIndex];
+      selectAlbum(albumIndex);
       
       hapticSelection();
       
-      if (buildSongList(currentArtist, currentAlbum)) {
+      if (buildSongList(albums[albumIndex])) {
         navigateToMenu(MENU_SONG_LIST);
         songIndex = 0;
       } else {
@@ -135,40 +287,25 @@ void handleCenter()
   {
     if (songIndex >= 0 && songIndex < (int)songs.size()) {
       hapticSelection();
-      
-      const Song& selectedSong = songs[songIndex];
-      
-      // Check if this is the currently playing/paused song
-      bool isSameSong = (selectedSong.title == currentTitle);
-      
-      if (isSameSong && (player_state == STATE_PLAYING || player_state == STATE_PAUSED)) {
-        // Same song is already loaded
-        if (player_state == STATE_PAUSED) {
-          Serial.println("Same song paused, resuming playback");
-          resumePlayback();
-        } else {
-          Serial.println("Same song playing, navigating to Now Playing");
-        }
-        navigateToMenu(MENU_NOW_PLAYING);
-      } else {
-        // Different song OR nothing playing - need to start fresh
-        if (player_state != STATE_STOPPED) {
-          // CRITICAL: Stop current playback first if anything is playing/paused
-          Serial.println("Stopping current playback before starting new song");
-          stopPlayback();  // This properly stops and resets everything
-          delay(100);      // Give it time to clean up
-        }
-        
-        Serial.println("Starting new song");
-        playCurrentSong(false);
-        navigateToMenu(MENU_NOW_PLAYING);
-      }
+      playSelectedSong();
     } else {
       Serial.println("❌ Invalid song index!");
     }
   }
+  else if (currentMenu == MENU_SEARCH)
+  {
+    handleSearchCharacter();
+  }
+  else if (currentMenu == MENU_SEARCH_RESULTS)
+  {
+    if (searchResultIndex >= 0 && searchResultIndex < (int)searchResults.size()) {
+      openSearchResult(searchResults[searchResultIndex]);
+    } else {
+      Serial.println("❌ Invalid search result index!");
+    }
+  }
   
-  displayNeedsUpdate = true;
+  requestDisplayUpdate(DISPLAY_DIRTY_LIST);
 }
 
 void handleTop()
@@ -183,14 +320,13 @@ void handleTop()
     rougePrefs.saveBrightness(screenBrightness);
     
     // Force full redraw - UPDATED
-    forceDisplayRedraw = true;
-    displayNeedsUpdate = true;
+    requestDisplayUpdate(DISPLAY_DIRTY_FULL);
     hapticBack();
     return;
   }
   
   navigateBack();
-  displayNeedsUpdate = true;
+  requestDisplayUpdate(DISPLAY_DIRTY_LIST);
 }
 
 void handleBottom()
@@ -216,7 +352,7 @@ void handleBottom()
     }
   }
   
-  displayNeedsUpdate = true;
+  requestDisplayUpdate(DISPLAY_DIRTY_LIST);
 }
 
 void handleLeft()
@@ -256,7 +392,7 @@ void autoPrevious()
   {
     songIndex--;
     playCurrentSong(true);
-    displayNeedsUpdate = true;
+    requestDisplayUpdate(DISPLAY_DIRTY_PLAYBACK);
     logRamSpace("auto previous - same album");
     return;
   }
@@ -266,15 +402,15 @@ void autoPrevious()
   {
     albumIndex--;
     
-    currentAlbum = albums[albumIndex];
+    selectAlbum(albumIndex);
 
-    if (buildSongList(currentArtist, currentAlbum))
+    if (buildSongList(albums[albumIndex]))
     {
       if (!songs.empty())
       {
         songIndex = songs.size() - 1;  // Go to last song of previous album
         playCurrentSong(true);
-        displayNeedsUpdate = true;
+        requestDisplayUpdate(DISPLAY_DIRTY_PLAYBACK);
         logRamSpace("auto previous - previous album");
         return;
       }
@@ -298,22 +434,22 @@ void autoPrevious()
   {
     artistIndex--;
     
-    currentArtist = artists[artistIndex];
+    selectArtist(artistIndex);
 
-    if (buildAlbumList(currentArtist))
+    if (buildAlbumList(artists[artistIndex]))
     {
       if (!albums.empty())
       {
         albumIndex = albums.size() - 1;  // Go to last album of previous artist
-        currentAlbum = albums[albumIndex];
+        selectAlbum(albumIndex);
 
-        if (buildSongList(currentArtist, currentAlbum))
+        if (buildSongList(albums[albumIndex]))
         {
           if (!songs.empty())
           {
             songIndex = songs.size() - 1;  // Go to last song
             playCurrentSong(true);
-            displayNeedsUpdate = true;
+            requestDisplayUpdate(DISPLAY_DIRTY_PLAYBACK);
             logRamSpace("auto previous - previous artist");
             return;
           }
@@ -338,107 +474,200 @@ void autoPrevious()
   Serial.println("📀 At beginning of library");
   // Restart current song
   playCurrentSong(true);
-  displayNeedsUpdate = true;
+  requestDisplayUpdate(DISPLAY_DIRTY_PLAYBACK);
   logRamSpace("auto previous - restart");
 }
 
-void autoNext()
+// Move to the track after the current one, loading the next album's or
+// artist's lists when this one runs out. False at the end of the library.
+bool selectNextSong()
 {
-  Serial.println("Auto-advancing to next track...");
-
-  // Try next song in current album
+  // Next song in current album
   if (songIndex + 1 < (int)songs.size())
   {
     songIndex++;
-    playCurrentSong(true);
-    displayNeedsUpdate = true;
-    logRamSpace("auto next - same album");
-    return;
+    return true;
   }
 
-  // Try next album
-  if (albumIndex + 1 < (int)albums.size())
+  // Next album with songs
+  while (albumIndex + 1 < (int)albums.size())
   {
     albumIndex++;
     songIndex = 0;
+    selectAlbum(albumIndex);
 
-    if (albumIndex < (int)albums.size())
+    if (buildSongList(albums[albumIndex]) && !songs.empty())
     {
-      currentAlbum = albums[albumIndex];
-
-      if (buildSongList(currentArtist, currentAlbum))
-      {
-        if (!songs.empty())
-        {
-          playCurrentSong(true);
-          displayNeedsUpdate = true;
-          logRamSpace("auto next - next album");
-          return;
-        }
-        else
-        {
-          Serial.println("⚠️ Album has no songs, trying next");
-          autoNext();
-          return;
-        }
-      }
-      else
-      {
-        Serial.println("⚠️ Failed to load album songs");
-        autoNext();
-        return;
-      }
+      return true;
     }
+    Serial.println("⚠️ Album has no songs, trying next");
   }
 
-  // Try next artist
-  if (artistIndex + 1 < (int)artists.size())
+  // First album with songs of the next artist
+  while (artistIndex + 1 < (int)artists.size())
   {
     artistIndex++;
     albumIndex = 0;
     songIndex = 0;
+    selectArtist(artistIndex);
 
-    if (artistIndex < (int)artists.size())
+    if (!buildAlbumList(artists[artistIndex]) || albums.empty())
     {
-      currentArtist = artists[artistIndex];
+      Serial.println("⚠️ Artist has no albums");
+      continue;
+    }
 
-      if (buildAlbumList(currentArtist))
+    for (albumIndex = 0; albumIndex < (int)albums.size(); albumIndex++)
+    {
+      selectAlbum(albumIndex);
+      if (buildSongList(albums[albumIndex]) && !songs.empty())
       {
-        if (!albums.empty())
-        {
-          currentAlbum = albums[0];
+        return true;
+      }
+      Serial.println("⚠️ No songs found");
+    }
+    albumIndex = (int)albums.size() - 1;
+  }
 
-          if (buildSongList(currentArtist, currentAlbum))
-          {
-            if (!songs.empty())
-            {
-              playCurrentSong(true);
-              displayNeedsUpdate = true;
-              logRamSpace("auto next - next artist");
-              return;
-            }
-            else
-            {
-              Serial.println("⚠️ No songs found");
-              autoNext();
-              return;
-            }
-          }
-        }
-        else
-        {
-          Serial.println("⚠️ Artist has no albums");
-          autoNext();
-          return;
-        }
+  return false;
+}
+
+// First song of an album, without loading it into the song list. The
+// arena only has to hold this one row, so it is emptied first.
+static bool peekFirstSong(int albumId, StringArena& strings, QueuedSong& next)
+{
+  std::vector<Song> rows;
+  strings.reset();
+  if (PageSource<Song>::fetch(albumId, PAGE_AT_OFFSET, NULL, 0, 1, strings, rows) < 1 || rows.empty())
+  {
+    return false;
+  }
+  next.albumId = albumId;
+  next.songIndex = 0;
+  next.songId = rows[0].id;
+  next.path = rows[0].path;
+  next.title = rows[0].title;
+  next.gain = rows[0].gain;
+  if (strings.full())
+  {
+    next.path.clear();  // Truncated row; don't queue it
+  }
+  return true;
+}
+
+// Same order as selectNextSong(), but only looks; the lists stay put.
+// False at the end of the library, or if the song found has no usable
+// path (autoNext() then deals with it when the track ends).
+bool peekNextSong(QueuedSong& next)
+{
+  static StringArena strings;
+  if (!strings.begin(1024))
+  {
+    return false;
+  }
+
+  next.artistIndex = artistIndex;
+  next.artistId = albums.parent();
+
+  if (songIndex + 1 < (int)songs.size())
+  {
+    Song song = songs[songIndex + 1];
+    next.albumIndex = albumIndex;
+    next.albumId = songs.parent();
+    next.songIndex = songIndex + 1;
+    next.songId = song.id;
+    next.path = song.path;
+    next.title = song.title;
+    next.gain = song.gain;
+    return !next.path.empty();
+  }
+
+  for (int i = albumIndex + 1; i < (int)albums.size(); i++)
+  {
+    next.albumIndex = i;
+    if (peekFirstSong(albums[i].id, strings, next))
+    {
+      return !next.path.empty();
+    }
+  }
+
+  for (int i = artistIndex + 1; i < (int)artists.size(); i++)
+  {
+    int artistId = artists[i].id;
+    int albumCount = PageSource<Album>::count(artistId);
+    next.artistIndex = i;
+    next.artistId = artistId;
+
+    for (int j = 0; j < albumCount; j++)
+    {
+      std::vector<Album> rows;
+      strings.reset();
+      if (PageSource<Album>::fetch(artistId, PAGE_AT_OFFSET, NULL, j, 1, strings, rows) < 1 || rows.empty())
+      {
+        break;
+      }
+      next.albumIndex = j;
+      if (peekFirstSong(rows[0].id, strings, next))
+      {
+        return !next.path.empty();
       }
     }
   }
 
+  return false;
+}
+
+// Load the lists around a song peekNextSong() picked. The indices may
+// have been browsed away since, so this goes by the saved positions and
+// checks the ids still match.
+bool selectQueuedSong(const QueuedSong& next)
+{
+  if (next.artistIndex >= (int)artists.size() || artists[next.artistIndex].id != next.artistId)
+  {
+    return false;
+  }
+  artistIndex = next.artistIndex;
+  selectArtist(artistIndex);
+
+  if (albums.parent() != next.artistId && !buildAlbumList(artists[artistIndex]))
+  {
+    return false;
+  }
+  if (next.albumIndex >= (int)albums.size() || albums[next.albumIndex].id != next.albumId)
+  {
+    return false;
+  }
+  albumIndex = next.albumIndex;
+  selectAlbum(albumIndex);
+
+  if (songs.parent() != next.albumId && !buildSongList(albums[albumIndex]))
+  {
+    return false;
+  }
+  if (next.songIndex >= (int)songs.size() || songs[next.songIndex].id != next.songId)
+  {
+    return false;
+  }
+  songIndex = next.songIndex;
+  return true;
+}
+
+void autoNext()
+{
+  Serial.println("Auto-advancing to next track...");
+
+  if (selectNextSong())
+  {
+    playCurrentSong(true);
+    requestDisplayUpdate(DISPLAY_DIRTY_PLAYBACK);
+    logRamSpace("auto next");
+    return;
+  }
+
   // End of library
   Serial.println("📀 Reached end of library");
   stopPlayback();
   navigateToMenu(MENU_NOW_PLAYING);
-  displayNeedsUpdate = true;
+  requestDisplayUpdate(DISPLAY_DIRTY_PLAYBACK);
   logRamSpace("auto next - end");
 }
\ No newline at end of file
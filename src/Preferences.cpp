@@ -1,4 +1,5 @@
 #include "Preferences.h"
+#include "State.h"
 
 RougePreferences rougePrefs;
 
@@ -128,4 +129,55 @@ int RougePreferences::loadBrightness() {
     }
     
     return (int)brightness;
-}
\ No newline at end of file
+}
+
+void RougePreferences::saveCrossfade(int seconds) {
+    if (!isOpen) return;
+    
+    esp_err_t err = nvs_set_i32(nvsHandle, "crossfade", seconds);
+    if (err != ESP_OK) {
+        Serial.printf("⚠️  Failed to save crossfade: %d\n", err);
+        return;
+    }
+    
+    nvs_commit(nvsHandle);
+    Serial.printf("💾 Crossfade saved: %ds\n", seconds);
+}
+
+int RougePreferences::loadCrossfade() {
+    if (!isOpen) return 0;
+    
+    int32_t seconds = 0;
+    esp_err_t err = nvs_get_i32(nvsHandle, "crossfade", &seconds);
+    if (err != ESP_OK) {
+        return 0;  // Not set yet: off
+    }
+    
+    if (seconds < 0) seconds = 0;
+    if (seconds > 10) seconds = 10;
+    return (int)seconds;
+}
+
+void RougePreferences::saveReplayGainMode(int mode) {
+    if (!isOpen) return;
+    
+    esp_err_t err = nvs_set_i32(nvsHandle, "replaygain", mode);
+    if (err != ESP_OK) {
+        Serial.printf("⚠️  Failed to save loudness mode: %d\n", err);
+        return;
+    }
+    
+    nvs_commit(nvsHandle);
+    Serial.printf("💾 Loudness mode saved: %d\n", mode);
+}
+
+int RougePreferences::loadReplayGainMode() {
+    if (!isOpen) return REPLAY_GAIN_ALBUM;
+    
+    int32_t mode = REPLAY_GAIN_ALBUM;
+    esp_err_t err = nvs_get_i32(nvsHandle, "replaygain", &mode);
+    if (err != ESP_OK || mode < 0 || mode >= REPLAY_GAIN_MODE_COUNT) {
+        return REPLAY_GAIN_ALBUM;  // Not set yet
+    }
+    return (int)mode;
+}
@@ -0,0 +1,128 @@
+#include "SdLoader.h"
+#include <SdFat.h>
+
+extern SdFat32 sd;
+
+#define SECTOR_SIZE 512
+
+SemaphoreHandle_t sdMutex = NULL;
+
+// Whole sectors straight from the card, bypassing the FAT layer
+static bool readContiguous(File32& file, uint8_t* buffer, size_t fileSize,
+                           LoadProgressCallback progress) {
+    uint32_t firstSector, lastSector;
+    if (!file.contiguousRange(&firstSector, &lastSector)) {
+        return false;
+    }
+
+    SdCard* card = sd.card();
+    const uint32_t sectorsPerChunk = SD_LOAD_CHUNK_SIZE / SECTOR_SIZE;
+    uint32_t fullSectors = fileSize / SECTOR_SIZE;
+    uint32_t sector = 0;
+
+    while (sector < fullSectors) {
+        uint32_t count = min(sectorsPerChunk, fullSectors - sector);
+        if (!card->readSectors(firstSector + sector, buffer + (size_t)sector * SECTOR_SIZE, count)) {
+            Serial.printf("❌ Sector read error at %lu\n", (unsigned long)(firstSector + sector));
+            return false;
+        }
+        sector += count;
+
+        if (progress) {
+            progress((size_t)sector * SECTOR_SIZE, fileSize);
+        }
+    }
+
+    // Partial tail sector goes through a bounce buffer
+    size_t tail = fileSize % SECTOR_SIZE;
+    if (tail) {
+        uint8_t sectorBuffer[SECTOR_SIZE];
+        if (!card->readSector(firstSector + fullSectors, sectorBuffer)) {
+            Serial.println("❌ Sector read error at file tail");
+            return false;
+        }
+        memcpy(buffer + (size_t)fullSectors * SECTOR_SIZE, sectorBuffer, tail);
+
+        if (progress) {
+            progress(fileSize, fileSize);
+        }
+    }
+
+    return true;
+}
+
+// Fragmented file: large reads still let SdFat transfer whole sectors
+// directly into the buffer
+static bool readChunked(File32& file, uint8_t* buffer, size_t fileSize,
+                        LoadProgressCallback progress) {
+    size_t bytesRead = 0;
+
+    while (bytesRead < fileSize) {
+        size_t toRead = min((size_t)SD_LOAD_CHUNK_SIZE, fileSize - bytesRead);
+        int read = file.read(buffer + bytesRead, toRead);
+
+        if (read <= 0) {
+            Serial.println("❌ Read error");
+            return false;
+        }
+        bytesRead += read;
+
+        if (progress) {
+            progress(bytesRead, fileSize);
+        }
+    }
+
+    return true;
+}
+
+uint8_t* loadFileToPsram(const char* sdPath, size_t& fileSize, LoadProgressCallback progress) {
+    fileSize = 0;
+
+    xSemaphoreTake(sdMutex, portMAX_DELAY);
+    File32 file = sd.open(sdPath, O_RDONLY);
+    if (!file) {
+        Serial.printf("❌ Cannot open %s\n", sdPath);
+        xSemaphoreGive(sdMutex);
+        return nullptr;
+    }
+
+    size_t size = file.size();
+    size_t freePSRAM = ESP.getFreePsram();
+    Serial.printf("   File size: %lu bytes (%.1f KB), free PSRAM: %.1f KB\n",
+                  size, size / 1024.0, freePSRAM / 1024.0);
+
+    if (size == 0 || size + SD_LOAD_PSRAM_RESERVE > freePSRAM) {
+        Serial.println("❌ Not enough PSRAM");
+        file.close();
+        xSemaphoreGive(sdMutex);
+        return nullptr;
+    }
+
+    uint8_t* buffer = (uint8_t*)ps_malloc(size);
+    if (!buffer) {
+        Serial.println("❌ Failed to allocate PSRAM");
+        file.close();
+        xSemaphoreGive(sdMutex);
+        return nullptr;
+    }
+
+    unsigned long start = micros();
+    bool contiguous = readContiguous(file, buffer, size, progress);
+    bool ok = contiguous || readChunked(file, buffer, size, progress);
+    unsigned long elapsed = micros() - start;
+    file.close();
+    xSemaphoreGive(sdMutex);
+
+    if (!ok) {
+        free(buffer);
+        return nullptr;
+    }
+
+    Serial.printf("   📥 Read %lu bytes in %lu ms (%.2f MB/s, %s, %d KB chunks)\n",
+                  size, elapsed / 1000,
+                  elapsed ? (size / 1048576.0) / (elapsed / 1000000.0) : 0.0,
+                  contiguous ? "contiguous" : "fragmented", SD_LOAD_CHUNK_SIZE / 1024);
+
+    fileSize = size;
+    return buffer;
+}
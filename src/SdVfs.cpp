@@ -0,0 +1,367 @@
+#include "SdVfs.h"
+#include <sqlite3.h>
+#include <string.h>
+#include <new>
+#include <unordered_map>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <SdFat.h>
+#include "SdLoader.h"
+
+extern SdFat32 sd;
+
+#define VFS_PRINTF Serial.printf
+#define VFS_ALLOC ps_malloc
+#define VFS_MICROS micros
+#else
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define VFS_PRINTF printf
+#define VFS_ALLOC malloc
+
+static uint32_t VFS_MICROS() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
+#endif
+
+static SdVfsStats stats;
+
+// ============================================================================
+// BACKING FILE (SdFat on the device, stdio on the host)
+// ============================================================================
+
+struct BackingFile {
+#ifdef ARDUINO
+    File32 file;
+
+    bool open(const char* path) {
+        file = sd.open(path, O_RDONLY);
+        return (bool)file;
+    }
+
+    int64_t size() { return file.size(); }
+
+    // Card access is shared with audio playback
+    int readAt(int64_t offset, uint8_t* dst, int len) {
+        xSemaphoreTake(sdMutex, portMAX_DELAY);
+        int read = file.seekSet(offset) ? file.read(dst, len) : -1;
+        xSemaphoreGive(sdMutex);
+        return read;
+    }
+
+    void close() { file.close(); }
+#else
+    FILE* fp;
+
+    bool open(const char* path) {
+        fp = fopen(path, "rb");
+        return fp != NULL;
+    }
+
+    int64_t size() {
+        fseek(fp, 0, SEEK_END);
+        return ftell(fp);
+    }
+
+    int readAt(int64_t offset, uint8_t* dst, int len) {
+        if (fseek(fp, offset, SEEK_SET) != 0) return -1;
+        return fread(dst, 1, len, fp);
+    }
+
+    void close() {
+        if (fp) fclose(fp);
+        fp = NULL;
+    }
+#endif
+};
+
+// ============================================================================
+// LRU PAGE CACHE
+// ============================================================================
+
+// sqlite3_file subclass; `base` must stay first so SQLite can cast it
+struct SdVfsFile {
+    sqlite3_file base;
+    BackingFile backing;
+    int64_t fileSize;
+
+    uint8_t* pages;                 // SD_VFS_CACHE_PAGES * SD_VFS_PAGE_SIZE
+    int32_t block[SD_VFS_CACHE_PAGES];
+    int16_t prev[SD_VFS_CACHE_PAGES];
+    int16_t next[SD_VFS_CACHE_PAGES];
+    int16_t head;                   // Most recently used
+    int16_t tail;                   // Least recently used
+    std::unordered_map<uint32_t, int16_t> lookup;
+
+    void unlink(int16_t slot) {
+        if (prev[slot] >= 0) next[prev[slot]] = next[slot]; else head = next[slot];
+        if (next[slot] >= 0) prev[next[slot]] = prev[slot]; else tail = prev[slot];
+    }
+
+    void pushFront(int16_t slot) {
+        prev[slot] = -1;
+        next[slot] = head;
+        if (head >= 0) prev[head] = slot;
+        head = slot;
+        if (tail < 0) tail = slot;
+    }
+
+    void initCache() {
+        head = tail = -1;
+        for (int16_t i = SD_VFS_CACHE_PAGES - 1; i >= 0; i--) {
+            block[i] = -1;
+            pushFront(i);
+        }
+        lookup.reserve(SD_VFS_CACHE_PAGES);
+    }
+
+    // Cached copy of `blockNo`, reading it from the card on a miss
+    const uint8_t* page(uint32_t blockNo) {
+        auto it = lookup.find(blockNo);
+        if (it != lookup.end()) {
+            stats.hits++;
+            unlink(it->second);
+            pushFront(it->second);
+            return pages + (size_t)it->second * SD_VFS_PAGE_SIZE;
+        }
+
+        stats.misses++;
+        int16_t slot = tail;
+        if (block[slot] >= 0) {
+            lookup.erase(block[slot]);
+            stats.evictions++;
+        }
+
+        uint8_t* dst = pages + (size_t)slot * SD_VFS_PAGE_SIZE;
+        uint32_t start = VFS_MICROS();
+        int read = backing.readAt((int64_t)blockNo * SD_VFS_PAGE_SIZE, dst, SD_VFS_PAGE_SIZE);
+        stats.readMicros += VFS_MICROS() - start;
+
+        if (read < 0) {
+            block[slot] = -1;
+            return NULL;
+        }
+        if (read < SD_VFS_PAGE_SIZE) {
+            memset(dst + read, 0, SD_VFS_PAGE_SIZE - read);
+        }
+
+        block[slot] = blockNo;
+        lookup[blockNo] = slot;
+        unlink(slot);
+        pushFront(slot);
+        return dst;
+    }
+};
+
+// ============================================================================
+// SQLITE IO METHODS (read-only)
+// ============================================================================
+
+static int vfsClose(sqlite3_file* f) {
+    SdVfsFile* file = (SdVfsFile*)f;
+    file->backing.close();
+    free(file->pages);
+    file->~SdVfsFile();
+    return SQLITE_OK;
+}
+
+static int vfsRead(sqlite3_file* f, void* buf, int amount, sqlite3_int64 offset) {
+    SdVfsFile* file = (SdVfsFile*)f;
+    uint8_t* out = (uint8_t*)buf;
+
+    int available = 0;
+    if (offset < file->fileSize) {
+        available = (int)(file->fileSize - offset < amount ? file->fileSize - offset : amount);
+    }
+
+    int done = 0;
+    while (done < available) {
+        int64_t pos = offset + done;
+        uint32_t blockNo = pos / SD_VFS_PAGE_SIZE;
+        int within = pos % SD_VFS_PAGE_SIZE;
+        int n = SD_VFS_PAGE_SIZE - within;
+        if (n > available - done) n = available - done;
+
+        const uint8_t* src = file->page(blockNo);
+        if (!src) {
+            return SQLITE_IOERR_READ;
+        }
+        memcpy(out + done, src + within, n);
+        done += n;
+    }
+
+    if (available < amount) {
+        // SQLite requires the unread tail to be zeroed
+        memset(out + available, 0, amount - available);
+        return SQLITE_IOERR_SHORT_READ;
+    }
+    return SQLITE_OK;
+}
+
+static int vfsWrite(sqlite3_file*, const void*, int, sqlite3_int64) {
+    return SQLITE_READONLY;
+}
+
+static int vfsTruncate(sqlite3_file*, sqlite3_int64) {
+    return SQLITE_READONLY;
+}
+
+static int vfsSync(sqlite3_file*, int) {
+    return SQLITE_OK;
+}
+
+static int vfsFileSize(sqlite3_file* f, sqlite3_int64* size) {
+    *size = ((SdVfsFile*)f)->fileSize;
+    return SQLITE_OK;
+}
+
+// Single reader, nothing ever writes: locks are no-ops
+static int vfsLock(sqlite3_file*, int) {
+    return SQLITE_OK;
+}
+
+static int vfsCheckReservedLock(sqlite3_file*, int* out) {
+    *out = 0;
+    return SQLITE_OK;
+}
+
+static int vfsFileControl(sqlite3_file*, int, void*) {
+    return SQLITE_NOTFOUND;
+}
+
+static int vfsSectorSize(sqlite3_file*) {
+    return 512;
+}
+
+static int vfsDeviceCharacteristics(sqlite3_file*) {
+    return SQLITE_IOCAP_IMMUTABLE;
+}
+
+// Filled in by sdVfsRegister(); static, so any fields newer SQLite
+// versions add past version 1 stay zero
+static sqlite3_io_methods ioMethods;
+
+// ============================================================================
+// VFS METHODS
+// ============================================================================
+
+static int vfsOpen(sqlite3_vfs*, const char* path, sqlite3_file* f, int flags, int* outFlags) {
+    f->pMethods = NULL;
+
+    // Only the main database, read-only: no journals or temp files
+    if (!path || !(flags & SQLITE_OPEN_MAIN_DB) || (flags & SQLITE_OPEN_READWRITE)) {
+        return SQLITE_CANTOPEN;
+    }
+
+    SdVfsFile* file = new (f) SdVfsFile();
+    file->pages = (uint8_t*)VFS_ALLOC((size_t)SD_VFS_CACHE_PAGES * SD_VFS_PAGE_SIZE);
+
+    if (!file->pages || !file->backing.open(path)) {
+        VFS_PRINTF("❌ VFS cannot open %s\n", path);
+        free(file->pages);
+        file->~SdVfsFile();
+        return SQLITE_CANTOPEN;
+    }
+
+    file->fileSize = file->backing.size();
+    file->initCache();
+    f->pMethods = &ioMethods;
+
+    if (outFlags) *outFlags = SQLITE_OPEN_READONLY;
+    return SQLITE_OK;
+}
+
+static int vfsDelete(sqlite3_vfs*, const char*, int) {
+    return SQLITE_IOERR_DELETE;
+}
+
+// Journals never exist; the database itself is opened directly
+static int vfsAccess(sqlite3_vfs*, const char*, int, int* out) {
+    *out = 0;
+    return SQLITE_OK;
+}
+
+static int vfsFullPathname(sqlite3_vfs*, const char* path, int size, char* out) {
+    strncpy(out, path, size);
+    out[size - 1] = '\0';
+    return SQLITE_OK;
+}
+
+// Randomness, sleep and time come from the platform's default VFS
+static sqlite3_vfs* defaultVfs() {
+    return sqlite3_vfs_find(NULL);
+}
+
+static int vfsRandomness(sqlite3_vfs*, int n, char* out) {
+    return defaultVfs()->xRandomness(defaultVfs(), n, out);
+}
+
+static int vfsSleep(sqlite3_vfs*, int micros) {
+    return defaultVfs()->xSleep(defaultVfs(), micros);
+}
+
+static int vfsCurrentTime(sqlite3_vfs*, double* out) {
+    return defaultVfs()->xCurrentTime(defaultVfs(), out);
+}
+
+static int vfsGetLastError(sqlite3_vfs*, int, char*) {
+    return 0;
+}
+
+static sqlite3_vfs sdVfs;  // Likewise
+
+bool sdVfsRegister() {
+    if (sqlite3_vfs_find(SD_VFS_NAME)) {
+        return true;
+    }
+    
+    ioMethods.iVersion = 1;
+    ioMethods.xClose = vfsClose;
+    ioMethods.xRead = vfsRead;
+    ioMethods.xWrite = vfsWrite;
+    ioMethods.xTruncate = vfsTruncate;
+    ioMethods.xSync = vfsSync;
+    ioMethods.xFileSize = vfsFileSize;
+    ioMethods.xLock = vfsLock;
+    ioMethods.xUnlock = vfsLock;
+    ioMethods.xCheckReservedLock = vfsCheckReservedLock;
+    ioMethods.xFileControl = vfsFileControl;
+    ioMethods.xSectorSize = vfsSectorSize;
+    ioMethods.xDeviceCharacteristics = vfsDeviceCharacteristics;
+    
+    sdVfs.iVersion = 1;
+    sdVfs.szOsFile = sizeof(SdVfsFile);
+    sdVfs.mxPathname = 256;
+    sdVfs.zName = SD_VFS_NAME;
+    sdVfs.xOpen = vfsOpen;
+    sdVfs.xDelete = vfsDelete;
+    sdVfs.xAccess = vfsAccess;
+    sdVfs.xFullPathname = vfsFullPathname;
+    sdVfs.xRandomness = vfsRandomness;
+    sdVfs.xSleep = vfsSleep;
+    sdVfs.xCurrentTime = vfsCurrentTime;
+    sdVfs.xGetLastError = vfsGetLastError;
+    
+    return sqlite3_vfs_register(&sdVfs, 0) == SQLITE_OK;
+}
+
+const SdVfsStats& sdVfsGetStats() {
+    return stats;
+}
+
+void sdVfsResetStats() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+void sdVfsPrintStats() {
+    uint32_t lookups = stats.hits + stats.misses;
+    VFS_PRINTF("📊 VFS pages: %lu hits, %lu misses (%.1f%% hit), %lu evictions, %lu ms reading\n",
+               (unsigned long)stats.hits, (unsigned long)stats.misses,
+               lookups ? stats.hits * 100.0 / lookups : 0.0,
+               (unsigned long)stats.evictions, (unsigned long)(stats.readMicros / 1000));
+}
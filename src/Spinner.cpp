@@ -50,6 +50,7 @@ void fancySpinnerTask(void * parameter) {
         
         display.fillCircle(x, y, DOT_RADIUS, color);
       }
+      display.flush();
       
       xSemaphoreGive(displayMutex);
       
@@ -72,6 +73,7 @@ void fancySpinnerTask(void * parameter) {
   
   if (xSemaphoreTake(displayMutex, 100 / portTICK_PERIOD_MS)) {
     display.fillScreen(COLOR_BG);
+    display.flush();
     xSemaphoreGive(displayMutex);
   }
   
@@ -104,6 +106,7 @@ void startLoadingAnimation() {
   display.setTextColor(COLOR_DISABLED);
   display.setTextSize(1);
   drawCenteredText("Loading...", SCREEN_HEIGHT - 30);
+  display.flush();
 
   BaseType_t result = xTaskCreatePinnedToCore(
     fancySpinnerTask,
@@ -0,0 +1,249 @@
+#include "TrackDecoder.h"
+#include "GainStage.h"
+
+extern SdFat32 sd;
+
+// Layer III bitrates in kbps by header index: MPEG-1, then MPEG-2/2.5
+static const uint16_t LAYER3_BITRATES[2][16] = {
+    {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0},
+    {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0}
+};
+
+static const uint32_t MPEG1_SAMPLE_RATES[3] = {44100, 48000, 32000};
+
+static uint32_t readBigEndian32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+TrackDecoder::TrackDecoder()
+    : output(NULL), preroll(NULL), prerollUsed(0), position(0), dataEnd(0),
+      skipFrames(0), keepFrames(UINT32_MAX), bitrate(0), sampleRate(0),
+      replayGain(GAIN_UNITY), opened(false) {
+    decoder.setOutput(*this);
+}
+
+TrackDecoder::~TrackDecoder() {
+    close();
+    free(preroll);
+}
+
+bool TrackDecoder::open(const char* path) {
+    close();
+
+    file = sd.open(path, O_RDONLY);
+    if (!file) {
+        Serial.printf("❌ Could not open file: %s\n", path);
+        return false;
+    }
+
+    // ID3v1 trailer is not audio
+    dataEnd = file.fileSize();
+    if (dataEnd > 128) {
+        uint8_t tag[3];
+        file.seekSet(dataEnd - 128);
+        if (file.read(tag, 3) == 3 && memcmp(tag, "TAG", 3) == 0) {
+            dataEnd -= 128;
+        }
+    }
+
+    position = skipId3v2();
+    skipFrames = 0;
+    keepFrames = UINT32_MAX;
+    bitrate = 0;
+    sampleRate = 0;
+    replayGain = GAIN_UNITY;
+    readGaplessInfo();
+    file.seekSet(position);
+
+    output = NULL;
+    prerollUsed = 0;
+    decoder.begin();
+    opened = true;
+    return true;
+}
+
+void TrackDecoder::close() {
+    if (opened) {
+        decoder.end();
+        file.close();
+        opened = false;
+    }
+    output = NULL;
+    prerollUsed = 0;
+}
+
+// Offset of the first frame after an ID3v2 tag (0 if there is none)
+uint32_t TrackDecoder::skipId3v2() {
+    uint8_t header[10];
+    file.seekSet(0);
+    if (file.read(header, 10) != 10 || memcmp(header, "ID3", 3) != 0) {
+        return 0;
+    }
+
+    // Syncsafe size, excluding the header and optional footer
+    uint32_t size = ((uint32_t)(header[6] & 0x7F) << 21) | ((uint32_t)(header[7] & 0x7F) << 14) |
+                    ((uint32_t)(header[8] & 0x7F) << 7) | (header[9] & 0x7F);
+    return 10 + size + ((header[5] & 0x10) ? 10 : 0);
+}
+
+// Xing/Info frame written by LAME (and ffmpeg): frame count, encoder delay
+// and end padding. The frame itself holds no audio and is skipped.
+void TrackDecoder::readGaplessInfo() {
+    file.seekSet(position);
+    int n = file.read(chunk, 192);
+    if (n < 4 || chunk[0] != 0xFF || (chunk[1] & 0xE0) != 0xE0) {
+        return;
+    }
+
+    int version = (chunk[1] >> 3) & 3;      // 3: MPEG-1, 2: MPEG-2, 0: MPEG-2.5
+    int layer = (chunk[1] >> 1) & 3;        // 1: Layer III
+    int bitrateIndex = chunk[2] >> 4;
+    int rateIndex = (chunk[2] >> 2) & 3;
+    int paddingSlot = (chunk[2] >> 1) & 1;
+    bool mono = (chunk[3] >> 6) == 3;
+
+    if (version == 1 || layer != 1 || rateIndex == 3 || bitrateIndex == 0 || bitrateIndex == 15) {
+        return;
+    }
+
+    bool mpeg1 = version == 3;
+    bitrate = LAYER3_BITRATES[mpeg1 ? 0 : 1][bitrateIndex];
+    sampleRate = MPEG1_SAMPLE_RATES[rateIndex] >> (mpeg1 ? 0 : (version == 2 ? 1 : 2));
+    uint32_t samplesPerFrame = mpeg1 ? 1152 : 576;
+    int sideInfo = mpeg1 ? (mono ? 17 : 32) : (mono ? 9 : 17);
+
+    const uint8_t* xing = chunk + 4 + sideInfo;
+    if (4 + sideInfo + 8 > n || (memcmp(xing, "Xing", 4) != 0 && memcmp(xing, "Info", 4) != 0)) {
+        return;
+    }
+
+    uint32_t flags = readBigEndian32(xing + 4);
+    const uint8_t* p = xing + 8;
+    uint32_t frames = 0;
+    if (flags & 0x1) { frames = readBigEndian32(p); p += 4; }
+    if (flags & 0x2) p += 4;     // Byte count
+    if (flags & 0x4) p += 100;   // Seek table
+    if (flags & 0x8) p += 4;     // Quality
+
+    uint32_t frameBytes = (mpeg1 ? 144000 : 72000) * bitrate / sampleRate + paddingSlot;
+    position += frameBytes;
+
+    // Length without trimming; this frame's bitrate says nothing for VBR
+    uint32_t total = frames * samplesPerFrame;
+    if (frames > 0) {
+        keepFrames = total;
+    }
+
+    // LAME extension: 9-character encoder id, delay/padding 21 bytes in
+    if (p + 24 > chunk + n || p[0] != 'L') {
+        return;
+    }
+
+    uint32_t delay = ((uint32_t)p[21] << 4) | (p[22] >> 4);
+    uint32_t padding = ((uint32_t)(p[22] & 0x0F) << 8) | p[23];
+
+    skipFrames = delay + MP3_DECODER_DELAY;
+    if (frames > 0) {
+        keepFrames = total > delay + padding ? total - delay - padding : 0;
+    }
+}
+
+uint32_t TrackDecoder::framesLeft() const {
+    if (!opened) {
+        return 0;
+    }
+    if (keepFrames != UINT32_MAX) {
+        return keepFrames;
+    }
+    if (bitrate == 0) {
+        return UINT32_MAX;
+    }
+    // Constant bitrate: bitrate * 125 bytes per second
+    return (uint64_t)bytesLeft() * sampleRate / (bitrate * 125);
+}
+
+void TrackDecoder::prime() {
+    if (!opened || output != NULL) {
+        return;
+    }
+
+    if (preroll == NULL) {
+        preroll = (uint8_t*)ps_malloc(TRACK_PREROLL_BYTES);
+        if (preroll == NULL) {
+            return;  // Starts cold at the splice instead
+        }
+    }
+
+    while (prerollUsed < TRACK_PREROLL_TARGET && position < dataEnd) {
+        int n = file.read(chunk, min((uint32_t)TRACK_PRIME_CHUNK, dataEnd - position));
+        if (n <= 0) {
+            break;
+        }
+        position += n;
+        decoder.write(chunk, n);
+    }
+}
+
+void TrackDecoder::setOutput(Print& out) {
+    output = &out;
+    if (prerollUsed > 0) {
+        out.write(preroll, prerollUsed);
+        prerollUsed = 0;
+    }
+}
+
+size_t TrackDecoder::decode() {
+    if (!opened || position >= dataEnd) {
+        return 0;
+    }
+
+    int n = file.read(chunk, min((uint32_t)TRACK_READ_CHUNK, dataEnd - position));
+    if (n <= 0) {
+        return 0;
+    }
+    position += n;
+    decoder.write(chunk, n);
+    return n;
+}
+
+size_t TrackDecoder::write(uint8_t b) {
+    return write(&b, 1);
+}
+
+// Trim delay and padding in whole PCM frames, then pass the rest on
+size_t TrackDecoder::write(const uint8_t* data, size_t len) {
+    int channels = decoder.audioInfo().channels;
+    size_t frameBytes = 2 * (channels > 0 ? channels : 2);
+    uint32_t frames = len / frameBytes;
+
+    if (skipFrames > 0) {
+        uint32_t skip = min(skipFrames, frames);
+        skipFrames -= skip;
+        frames -= skip;
+        data += skip * frameBytes;
+    }
+
+    if (frames > keepFrames) {
+        frames = keepFrames;
+    }
+    if (keepFrames != UINT32_MAX) {
+        keepFrames -= frames;
+    }
+
+    size_t bytes = frames * frameBytes;
+    if (bytes == 0) {
+        return len;
+    }
+
+    if (output != NULL) {
+        output->write(data, bytes);
+    } else if (preroll != NULL) {
+        size_t room = TRACK_PREROLL_BYTES - prerollUsed;
+        if (bytes > room) {
+            bytes = room;
+        }
+        memcpy(preroll + prerollUsed, data, bytes);
+        prerollUsed += bytes;
+    }
+    return len;
+}
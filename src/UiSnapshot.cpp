@@ -0,0 +1,223 @@
+#include "UiSnapshot.h"
+#include "Display.h"
+#include <atomic>
+#include <string.h>
+
+// Triple buffer: the loop task fills `writing`, the display task reads
+// `reading`, and `middle` holds the last published slot. Swapping with
+// the middle slot hands a buffer over without either side waiting.
+#define UI_SLOT_MASK  0x03
+#define UI_SLOT_FRESH 0x80  // Middle slot not yet picked up by the reader
+
+static UiSnapshot slots[3];
+static std::atomic<uint8_t> middle(1);
+static uint8_t writing = 0;  // Loop task only
+static uint8_t reading = 2;  // Display task only
+
+static std::atomic<uint32_t> pendingDirty(0);
+
+#ifdef DEBUG
+static std::atomic<uint32_t> pendingMicros(0);
+#endif
+
+// Window position per list, kept between snapshots so the selection
+// scrolls the window only at its edges
+enum { WINDOW_MENU, WINDOW_ARTISTS, WINDOW_ALBUMS, WINDOW_SONGS, WINDOW_COUNT };
+static int lastWindowStart[WINDOW_COUNT] = {0, 0, 0, 0};
+
+template <size_t N>
+static void copyText(char (&dst)[N], const char* src)
+{
+  strncpy(dst, src, N - 1);
+  dst[N - 1] = '\0';
+}
+
+// First visible row of list `window` for a `rows`-high window
+static int windowFor(int window, int index, int listSize, int rows)
+{
+  int windowStart = listWindowStart(index, lastWindowStart[window], listSize, rows);
+  lastWindowStart[window] = windowStart;
+  return windowStart;
+}
+
+static void setRow(UiSnapshot& s, int slot, const char* text, bool enabled, bool playing)
+{
+  UiRow& row = s.rows[slot];
+  copyText(row.text, text);
+  row.enabled = enabled;
+  row.playing = playing;
+}
+
+// The indexer shortens long labels; keep the full name for the marquee
+static void setSelectedText(UiSnapshot& s, const StringRef& name, const StringRef& label)
+{
+  if (name.length() > label.length()) {
+    copyText(s.selectedText, name.c_str());
+  }
+}
+
+static void buildList(UiSnapshot& s)
+{
+  bool playing = player_state != STATE_STOPPED;
+
+  switch (s.menu) {
+    case MENU_MAIN:
+    case MENU_MUSIC:
+    case MENU_SETTINGS:
+    case MENU_BLUETOOTH: {
+      s.listSize = currentMenuItems.size();
+      s.index = menuIndex;
+      int start = windowFor(WINDOW_MENU, s.index, s.listSize, UI_LIST_ROWS);
+      s.selectedRow = s.index - start;
+      for (int i = 0; i < UI_LIST_ROWS && start + i < s.listSize; i++) {
+        const MenuItem& item = currentMenuItems[start + i];
+        setRow(s, s.rowCount++, item.label.c_str(), item.enabled, false);
+      }
+      break;
+    }
+
+    case MENU_ARTIST_LIST: {
+      s.listSize = artists.size();
+      s.index = artistIndex;
+      int start = windowFor(WINDOW_ARTISTS, s.index, s.listSize, UI_LIST_ROWS);
+      s.selectedRow = s.index - start;
+      for (int i = 0; i < UI_LIST_ROWS && start + i < s.listSize; i++) {
+        Artist row = artists[start + i];
+        setRow(s, s.rowCount++, row.displayName.c_str(), true, playing && row.id == currentArtistId);
+        if (start + i == s.index) {
+          setSelectedText(s, row.name, row.displayName);
+        }
+      }
+      if (letterJumpActive && letterJumpRun < (int)artistJumps.size()) {
+        s.jumpLetter = artistJumps[letterJumpRun].letter;
+      }
+      break;
+    }
+
+    case MENU_ALBUM_LIST: {
+      s.listSize = albums.size();
+      s.index = albumIndex;
+      copyText(s.subheader, currentArtist.c_str());
+      int start = windowFor(WINDOW_ALBUMS, s.index, s.listSize, UI_LIST_ROWS);
+      s.selectedRow = s.index - start;
+      for (int i = 0; i < UI_LIST_ROWS && start + i < s.listSize; i++) {
+        Album row = albums[start + i];
+        setRow(s, s.rowCount++, row.displayName.c_str(), true, playing && row.id == currentAlbumId);
+        if (start + i == s.index) {
+          setSelectedText(s, row.name, row.displayName);
+        }
+      }
+      break;
+    }
+
+    case MENU_SONG_LIST: {
+      s.listSize = songs.size();
+      s.index = songIndex;
+      copyText(s.subheader, currentAlbum.c_str());
+      int start = windowFor(WINDOW_SONGS, s.index, s.listSize, UI_LIST_ROWS);
+      s.selectedRow = s.index - start;
+      for (int i = 0; i < UI_LIST_ROWS && start + i < s.listSize; i++) {
+        Song row = songs[start + i];
+        bool isPlaying = playing && row.id == currentSongId;
+        setRow(s, s.rowCount++, row.displayName.c_str(), true, isPlaying);
+        if (start + i == s.index) {
+          setSelectedText(s, row.title, row.displayName);
+        }
+      }
+      break;
+    }
+
+    case MENU_SEARCH: {
+      // Preview of the best matches under the picker
+      s.listSize = searchResults.size();
+      s.index = 0;
+      for (int i = 0; i < 3 && i < s.listSize; i++) {
+        setRow(s, s.rowCount++, searchResults[i].displayName.c_str(), true, false);
+      }
+      copyText(s.searchQuery, searchQuery.c_str());
+      s.searchCharIndex = searchCharIndex;
+      break;
+    }
+
+    case MENU_SEARCH_RESULTS: {
+      // Bottom row holds the kind footer
+      s.listSize = searchResults.size();
+      s.index = searchResultIndex;
+      int start = windowFor(WINDOW_MENU, s.index, s.listSize, UI_LIST_ROWS - 1);
+      s.selectedRow = s.index - start;
+      for (int i = 0; i < UI_LIST_ROWS - 1 && start + i < s.listSize; i++) {
+        setRow(s, s.rowCount++, searchResults[start + i].displayName.c_str(), true, false);
+      }
+      if (s.index < s.listSize) {
+        const SearchResult& selected = searchResults[s.index];
+        s.selectedKind = selected.kind;
+        setSelectedText(s, selected.name, selected.displayName);
+      }
+      break;
+    }
+
+    case MENU_NOW_PLAYING:
+      break;
+  }
+}
+
+void requestDisplayUpdate(uint32_t dirty)
+{
+  #ifdef DEBUG
+  uint32_t none = 0;
+  pendingMicros.compare_exchange_strong(none, micros() | 1);
+  #endif
+
+  pendingDirty.fetch_or(dirty);
+}
+
+void publishUiSnapshot()
+{
+  uint32_t dirty = pendingDirty.exchange(0);
+  if (dirty == 0) {
+    return;
+  }
+
+  UiSnapshot& s = slots[writing];
+
+  s.menu = currentMenu;
+  s.playerState = player_state;
+  s.batteryPercent = batteryPercent;
+  s.batteryCharging = batteryCharging;
+
+  s.listSize = 0;
+  s.index = 0;
+  s.rowCount = 0;
+  s.selectedRow = -1;
+  s.selectedText[0] = '\0';
+  s.subheader[0] = '\0';
+  s.selectedKind = SEARCH_ARTIST;
+  s.jumpLetter = '\0';
+  s.searchQuery[0] = '\0';
+  s.searchCharIndex = 0;
+  buildList(s);
+
+  s.volumeControlActive = volumeControlActive;
+  s.volume = currentVolume;
+  s.brightnessControlActive = brightnessControlActive;
+  s.brightness = screenBrightness;
+
+  copyText(s.title, currentTitle.c_str());
+  copyText(s.artist, currentArtist.c_str());
+  copyText(s.album, currentAlbum.c_str());
+
+  #ifdef DEBUG
+  s.requestMicros = pendingMicros.exchange(0);
+  #endif
+
+  writing = middle.exchange(writing | UI_SLOT_FRESH) & UI_SLOT_MASK;
+  wakeDisplayTask(dirty);
+}
+
+const UiSnapshot& acquireUiSnapshot()
+{
+  if (middle.load() & UI_SLOT_FRESH) {
+    reading = middle.exchange(reading) & UI_SLOT_MASK;
+  }
+  return slots[reading];
+}
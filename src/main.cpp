@@ -15,6 +15,8 @@
 #include "Database.h"
 #include "Preferences.h"
 #include "Battery.h"
+#include "SdLoader.h"
+#include "InputQueue.h"
 
 #define WDT_TIMEOUT 30
 const int cs = 32;
@@ -47,10 +49,10 @@ void setup()
 
     // Show loading animation
     startLoadingAnimation();
-    delay(500);
 
     // Initialize SD card
-    if (!sd.begin(cs, SD_SCK_MHZ(25)))
+    sdMutex = xSemaphoreCreateMutex();
+    if (!sd.begin(cs, SD_SCK_MHZ(SD_CLOCK_MHZ)))
     {
         Serial.println("❌ SD initialization failed!");
         stopLoadingAnimation();
@@ -63,53 +65,24 @@ void setup()
     Serial.println("✅ SD initialized");
     logRamSpace("SD Init");
 
-    // Load database (replaces loadIndex())
-    if (!loadDatabase())
-    {
-        Serial.println("❌ Database initialization failed!");
-        stopLoadingAnimation();
-        delay(100);
-        display.fillScreen(COLOR_BG);
-        display.setTextColor(COLOR_TEXT);
-        drawCenteredText("Database Error", SCREEN_HEIGHT / 2);
-        display.setTextSize(1);
-        display.setCursor(10, SCREEN_HEIGHT / 2 + 30);
-        display.println("Run indexer tool");
-        return;
-    }
-    Serial.println("✅ Database initialized");
-    logRamSpace("Database load");
-
-    // Build artist list
-    if (!buildArtistList()) {
-        Serial.println("❌ Failed to build artist list!");
-        stopLoadingAnimation();
-        delay(100);
-        display.fillScreen(COLOR_BG);
-        display.setTextColor(COLOR_TEXT);
-        drawCenteredText("No Artists", SCREEN_HEIGHT / 2);
-        return;
-    }
+    // Load the library in the background; the menu and Bluetooth come up
+    // meanwhile with Music disabled until it is ready
+    startLibraryLoad();
 
-    // Stop loading animation
+    // Stop loading animation (the spinner task clears the screen as it ends)
     stopLoadingAnimation();
     delay(200);
     
-    if (xSemaphoreTake(displayMutex, 100 / portTICK_PERIOD_MS)) {
-        display.fillScreen(COLOR_BG);
-        xSemaphoreGive(displayMutex);
-    }
-    
     // Initialize audio system
     initAudio();
     
     // Build and show main menu
     buildMainMenu();
     navigateToMenu(MENU_MAIN);
-    displayNeedsUpdate = true;
+    requestDisplayUpdate(DISPLAY_DIRTY_FULL);
     delay(200);
 
-    Serial.println("✅ Setup complete!");
+    Serial.printf("✅ Setup complete! (interactive after %lu ms)\n", millis());
     Serial.println("==========================================");
     logRamSpace("setup complete");
 
@@ -118,23 +91,61 @@ void setup()
     esp_task_wdt_add(NULL);
 }
 
+// Refresh the main menu's Music entry as the background load progresses
+static void updateLibraryStatus()
+{
+    static LibraryState shownState = LIBRARY_IDLE;
+    static int shownPercent = -1;
+
+    LibraryState state = libraryState;
+    int percent = libraryLoadPercent;
+
+    // Progress label only needs to move in 5% steps
+    if (state == shownState && (state != LIBRARY_LOADING || percent / 5 == shownPercent / 5)) {
+        return;
+    }
+
+    if (state == LIBRARY_READY && shownState != LIBRARY_READY) {
+        logRamSpace("library load");
+    }
+
+    shownState = state;
+    shownPercent = percent;
+
+    if (currentMenu == MENU_MAIN) {
+        int keepIndex = menuIndex;
+        buildMainMenu();
+        menuIndex = keepIndex;
+        requestDisplayUpdate(DISPLAY_DIRTY_LIST);
+    }
+}
+
 void loop()
 {
     // Feed the watchdog
     esp_task_wdt_reset();
 
-    // CORE 1: Audio processing - highest priority
+    // Track changes and volume saving; decoding has its own task
     audioLoop();
 
     // Battery monitoring
     updateBattery();
 
+    // Hand queued ISR input to the encoder and button handlers
+    processInputEvents();
+
     // Encoder updates (lightweight)
     updateEncoder();
 
     // Button processing
     pollButtons();
 
+    // Library load progress (Music menu entry)
+    updateLibraryStatus();
+
+    // Hand the display task a fresh copy of whatever changed above
+    publishUiSnapshot();
+
     #ifdef DEBUG
     // Monitor heap periodically (debug builds only)
     static unsigned long lastHeapCheck = 0;
@@ -158,6 +169,8 @@ void loop()
 
         Serial.printf("Heap: %u (min: %u), PSRAM: %u (min: %u)\n", 
                       freeHeap, minHeap, freePSRAM, minPSRAM);
+        musicDB.printQueryStats();
+        printDisplayStats();
         lastHeapCheck = millis();
     }
     #endif
@@ -1,5 +1,7 @@
 #include "State.h"
 #include "Haptics.h"
+#include "Indexer.h"
+#include "Display.h"
 #include <Arduino.h>
 
 // Bluetooth status
@@ -15,11 +17,28 @@ std::vector<MenuStackEntry> menuStack;
 std::string currentArtist = "";
 std::string currentAlbum = "";
 std::string currentTitle = "";
+int currentArtistId = -1;
+int currentAlbumId = -1;
+int currentSongId = -1;
 
 // Library data
-std::vector<std::string> artists;
-std::vector<std::string> albums;
-std::vector<Song> songs;
+PagedList<Artist> artists;
+PagedList<Album> albums;
+PagedList<Song> songs;
+
+// Letter jumps
+std::vector<LetterJump> artistJumps;
+bool letterJumpActive = false;
+int letterJumpRun = 0;
+unsigned long lastLetterJump = 0;
+
+// Search state
+std::string searchQuery;
+int searchCharIndex = 1;
+std::vector<SearchResult> searchResults;
+int searchResultIndex = 0;
+const char SEARCH_ALPHABET[] = "<ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789>";
+static StringArena searchStrings;
 
 // Navigation indices
 volatile int artistIndex = 0;
@@ -46,13 +65,31 @@ int screenBrightness = 255;  // Default full brightness
 bool brightnessControlActive = false;
 unsigned long lastBrightnessChange = 0;
 
-// Display control - NEW
-bool forceDisplayRedraw = false;
+int crossfadeSeconds = 0;
+int replayGainMode = REPLAY_GAIN_ALBUM;
 
 // Menu builders
+// Music stays disabled until the background library load finishes
+static void addMusicMenuItem() {
+  char label[24];
+
+  switch (libraryState) {
+    case LIBRARY_READY:
+      currentMenuItems.push_back(MenuItem("Music", MENU_MUSIC));
+      return;
+    case LIBRARY_FAILED:
+      currentMenuItems.push_back(MenuItem("Music: No Library", MENU_MUSIC, false));
+      return;
+    default:
+      snprintf(label, sizeof(label), "Music (%d%%)", libraryLoadPercent);
+      currentMenuItems.push_back(MenuItem(label, MENU_MUSIC, false));
+      return;
+  }
+}
+
 void buildMainMenu() {
   currentMenuItems.clear();
-  currentMenuItems.push_back(MenuItem("Music", MENU_MUSIC));
+  addMusicMenuItem();
   currentMenuItems.push_back(MenuItem("Now Playing", MENU_NOW_PLAYING, (player_state == STATE_PLAYING || player_state == STATE_PAUSED)));  // Disabled if not playing
   currentMenuItems.push_back(MenuItem("Settings", MENU_SETTINGS));
   currentMenuItems.push_back(MenuItem("Bluetooth", MENU_BLUETOOTH));
@@ -65,12 +102,65 @@ void buildMusicMenu() {
   currentMenuItems.push_back(MenuItem("Albums", MENU_ALBUM_LIST));  // Future: album browser
   currentMenuItems.push_back(MenuItem("All Songs", MENU_SONG_LIST)); // Future: all songs
   currentMenuItems.push_back(MenuItem("Playlists", MENU_MUSIC));     // Future: playlists
+  currentMenuItems.push_back(MenuItem("Search", MENU_SEARCH, librarySearchAvailable()));
   menuIndex = 0;
 }
 
+// Re-run the search for the current query. Results reference
+// searchStrings, which is only reset here; the display task only sees
+// copies taken when the next UI snapshot is published.
+void updateSearchResults() {
+  searchStrings.begin(SEARCH_ARENA_BYTES);
+  searchStrings.reset();
+  searchResults.clear();
+  searchResultIndex = 0;
+
+  if (!searchQuery.empty()) {
+    #ifdef DEBUG
+    unsigned long start = micros();
+    #endif
+
+    searchLibrary(searchQuery.c_str(), SEARCH_MAX_RESULTS, searchStrings, searchResults);
+
+    #ifdef DEBUG
+    Serial.printf("🔎 '%s': %d results in %lu us\n", searchQuery.c_str(),
+                  (int)searchResults.size(), micros() - start);
+    #endif
+  }
+}
+
+// Binary search over a few dozen runs; scrolling then steps by run
+int letterJumpRunAt(int row) {
+  int lo = 0;
+  int hi = (int)artistJumps.size() - 1;
+
+  while (lo < hi) {
+    int mid = (lo + hi + 1) / 2;
+    if (artistJumps[mid].row <= row) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return lo;
+}
+
 void buildSettingsMenu() {
   currentMenuItems.clear();
   currentMenuItems.push_back(MenuItem("Brightness", MENU_SETTINGS));  // NEW
+  
+  char crossfadeLabel[24];
+  if (crossfadeSeconds > 0) {
+    snprintf(crossfadeLabel, sizeof(crossfadeLabel), "Crossfade: %ds", crossfadeSeconds);
+  } else {
+    snprintf(crossfadeLabel, sizeof(crossfadeLabel), "Crossfade: Off");
+  }
+  currentMenuItems.push_back(MenuItem(crossfadeLabel, MENU_SETTINGS));
+  
+  static const char* const loudnessLabels[REPLAY_GAIN_MODE_COUNT] = {
+    "Loudness: Off", "Loudness: Track", "Loudness: Album"
+  };
+  currentMenuItems.push_back(MenuItem(loudnessLabels[replayGainMode], MENU_SETTINGS));
   currentMenuItems.push_back(MenuItem("Shuffle: Off", MENU_SETTINGS));
   currentMenuItems.push_back(MenuItem("Repeat: Off", MENU_SETTINGS));
   currentMenuItems.push_back(MenuItem("About", MENU_SETTINGS));
@@ -126,6 +216,14 @@ void navigateToMenu(MenuType menu) {
     case MENU_NOW_PLAYING:
       // Just switch to now playing screen
       break;
+    case MENU_SEARCH:
+      searchQuery.clear();
+      searchCharIndex = 1;
+      updateSearchResults();
+      break;
+    case MENU_SEARCH_RESULTS:
+      searchResultIndex = 0;
+      break;
   }
   
   Serial.printf("Navigated to menu: %d\n", menu);
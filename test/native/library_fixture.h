@@ -0,0 +1,293 @@
+#ifndef LIBRARY_FIXTURE_H
+#define LIBRARY_FIXTURE_H
+
+// Synthetic music.db with the indexer's schema (music_indexer.py), for
+// the native suites that run MusicDatabase or the SD VFS against a real
+// file. Names are generated from a seed, so every run builds the same
+// library.
+
+#include <sqlite3.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#define FIXTURE_LABEL_CHARS 24
+
+struct FixtureShape {
+  int artists;
+  int albumsPerArtist;   // Varies by +-50% per artist
+  int songsPerAlbum;     // Varies by +-50% per album
+};
+
+static const char* const FIXTURE_SYLLABLES[] = {
+  "ka", "lo", "mi", "ra", "ven", "tor", "sa", "el", "bri", "don",
+  "ne", "qu", "zu", "pha", "ri", "mon", "ta", "ol", "gre", "yu",
+  "ash", "ber", "cy", "dru", "fen", "hal", "ix", "jo", "wen", "xo"
+};
+
+inline uint32_t fixtureRandom(uint32_t& seed) {
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+// Capitalised pseudo-word of 1-4 syllables
+inline std::string fixtureWord(uint32_t& seed) {
+  std::string word;
+  int syllables = fixtureRandom(seed) % 4 + 1;
+  for (int i = 0; i < syllables; i++) {
+    word += FIXTURE_SYLLABLES[fixtureRandom(seed) % 30];
+  }
+  word[0] = toupper(word[0]);
+  return word;
+}
+
+inline std::string fixtureName(uint32_t& seed, int words) {
+  std::string name = fixtureWord(seed);
+  for (int i = 1; i < words; i++) {
+    name += " " + fixtureWord(seed);
+  }
+  return name;
+}
+
+// Same rule as the indexer's display_name()
+inline std::string fixtureLabel(const std::string& text) {
+  if (text.size() <= FIXTURE_LABEL_CHARS) {
+    return text;
+  }
+  std::string label = text.substr(0, FIXTURE_LABEL_CHARS - 3);
+  while (!label.empty() && label[label.size() - 1] == ' ') {
+    label.erase(label.size() - 1);
+  }
+  return label + "...";
+}
+
+inline bool fixtureExec(sqlite3* db, const char* sql) {
+  char* error = NULL;
+  if (sqlite3_exec(db, sql, NULL, NULL, &error) != SQLITE_OK) {
+    printf("fixture: %s\n  in %s\n", error, sql);
+    sqlite3_free(error);
+    return false;
+  }
+  return true;
+}
+
+static const char* const FIXTURE_SCHEMA =
+  "CREATE TABLE artists ("
+  "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
+  "  name TEXT NOT NULL UNIQUE,"
+  "  display_name TEXT NOT NULL);"
+  "CREATE TABLE albums ("
+  "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
+  "  artist_id INTEGER NOT NULL,"
+  "  name TEXT NOT NULL,"
+  "  display_name TEXT NOT NULL,"
+  "  year INTEGER,"
+  "  UNIQUE(artist_id, name));"
+  "CREATE TABLE songs ("
+  "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
+  "  album_id INTEGER NOT NULL,"
+  "  title TEXT NOT NULL,"
+  "  display_name TEXT NOT NULL,"
+  "  path TEXT NOT NULL UNIQUE,"
+  "  track_number INTEGER,"
+  "  duration INTEGER,"
+  "  file_size INTEGER,"
+  "  track_gain REAL,"
+  "  album_gain REAL);"
+  "CREATE TABLE search_items ("
+  "  id INTEGER PRIMARY KEY,"
+  "  kind INTEGER NOT NULL,"
+  "  ref_id INTEGER NOT NULL,"
+  "  artist_id INTEGER NOT NULL,"
+  "  album_id INTEGER,"
+  "  name TEXT NOT NULL,"
+  "  display_name TEXT NOT NULL);"
+  "CREATE TABLE search_terms ("
+  "  term TEXT NOT NULL,"
+  "  item_id INTEGER NOT NULL,"
+  "  position INTEGER NOT NULL,"
+  "  PRIMARY KEY (term, item_id)) WITHOUT ROWID;"
+  "CREATE TABLE artist_jumps ("
+  "  row INTEGER PRIMARY KEY,"
+  "  letter TEXT NOT NULL);"
+  "CREATE INDEX idx_songs_album ON songs(album_id);"
+  "CREATE INDEX idx_albums_artist ON albums(artist_id);"
+  "CREATE INDEX idx_songs_title ON songs(title);"
+  "CREATE INDEX idx_artists_name ON artists(name);"
+  "CREATE INDEX idx_artists_name_nocase ON artists(name COLLATE NOCASE);";
+
+// One search item plus a term row per distinct lowercase word of `name`
+inline void fixtureIndexName(sqlite3_stmt* item, sqlite3_stmt* term, int itemId, int kind,
+                             int refId, int artistId, int albumId, const std::string& name) {
+  sqlite3_bind_int(item, 1, itemId);
+  sqlite3_bind_int(item, 2, kind);
+  sqlite3_bind_int(item, 3, refId);
+  sqlite3_bind_int(item, 4, artistId);
+  if (albumId >= 0) sqlite3_bind_int(item, 5, albumId); else sqlite3_bind_null(item, 5);
+  sqlite3_bind_text(item, 6, name.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(item, 7, fixtureLabel(name).c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_step(item);
+  sqlite3_reset(item);
+
+  std::vector<std::string> seen;
+  std::string word;
+  int position = 0;
+  for (size_t i = 0; i <= name.size(); i++) {
+    char c = i < name.size() ? tolower(name[i]) : ' ';
+    if (isalnum((unsigned char)c)) {
+      word += c;
+      continue;
+    }
+    if (word.empty()) {
+      continue;
+    }
+    bool duplicate = false;
+    for (size_t s = 0; s < seen.size(); s++) {
+      duplicate = duplicate || seen[s] == word;
+    }
+    if (!duplicate) {
+      sqlite3_bind_text(term, 1, word.c_str(), -1, SQLITE_TRANSIENT);
+      sqlite3_bind_int(term, 2, itemId);
+      sqlite3_bind_int(term, 3, position);
+      sqlite3_step(term);
+      sqlite3_reset(term);
+      seen.push_back(word);
+    }
+    position++;
+    word.clear();
+  }
+}
+
+// Letter runs of the artist list, in the player's order
+inline bool fixtureBuildJumps(sqlite3* db) {
+  sqlite3_stmt* names;
+  sqlite3_stmt* insert;
+  sqlite3_prepare_v2(db, "SELECT name FROM artists ORDER BY name COLLATE NOCASE, id", -1, &names, NULL);
+  sqlite3_prepare_v2(db, "INSERT INTO artist_jumps (row, letter) VALUES (?, ?)", -1, &insert, NULL);
+
+  char last = 0;
+  for (int row = 0; sqlite3_step(names) == SQLITE_ROW; row++) {
+    char first = toupper(sqlite3_column_text(names, 0)[0]);
+    char letter = first >= 'A' && first <= 'Z' ? first : '#';
+    if (letter != last) {
+      sqlite3_bind_int(insert, 1, row);
+      sqlite3_bind_text(insert, 2, &letter, 1, SQLITE_TRANSIENT);
+      sqlite3_step(insert);
+      sqlite3_reset(insert);
+      last = letter;
+    }
+  }
+
+  sqlite3_finalize(names);
+  sqlite3_finalize(insert);
+  return true;
+}
+
+// Write a fresh library to `path`; returns the number of songs
+inline int writeFixtureLibrary(const char* path, const FixtureShape& shape, uint32_t seed = 1) {
+  remove(path);
+
+  sqlite3* db;
+  if (sqlite3_open(path, &db) != SQLITE_OK) {
+    printf("fixture: cannot create %s\n", path);
+    return -1;
+  }
+  if (!fixtureExec(db, FIXTURE_SCHEMA) || !fixtureExec(db, "BEGIN")) {
+    sqlite3_close(db);
+    return -1;
+  }
+
+  sqlite3_stmt* artist;
+  sqlite3_stmt* album;
+  sqlite3_stmt* song;
+  sqlite3_stmt* item;
+  sqlite3_stmt* term;
+  sqlite3_prepare_v2(db, "INSERT INTO artists (name, display_name) VALUES (?, ?)", -1, &artist, NULL);
+  sqlite3_prepare_v2(db, "INSERT INTO albums (artist_id, name, display_name, year) VALUES (?, ?, ?, ?)",
+                     -1, &album, NULL);
+  sqlite3_prepare_v2(db, "INSERT INTO songs (album_id, title, display_name, path, track_number, "
+                     "duration, file_size, track_gain, album_gain) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)",
+                     -1, &song, NULL);
+  sqlite3_prepare_v2(db, "INSERT INTO search_items (id, kind, ref_id, artist_id, album_id, name, "
+                     "display_name) VALUES (?, ?, ?, ?, ?, ?, ?)", -1, &item, NULL);
+  sqlite3_prepare_v2(db, "INSERT OR IGNORE INTO search_terms (term, item_id, position) VALUES (?, ?, ?)",
+                     -1, &term, NULL);
+
+  int songCount = 0;
+  int itemId = 0;
+  char buf[256];
+
+  for (int a = 0; a < shape.artists; a++) {
+    // Artist names are unique: a counter breaks ties between generated ones
+    std::string name = fixtureName(seed, fixtureRandom(seed) % 3 + 1);
+    if (a % 7 == 0) {
+      snprintf(buf, sizeof(buf), "%s %d", name.c_str(), a);
+      name = buf;
+    }
+    if (a % 23 == 0) {
+      name = "The " + name;
+    }
+    sqlite3_bind_text(artist, 1, name.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(artist, 2, fixtureLabel(name).c_str(), -1, SQLITE_TRANSIENT);
+    if (sqlite3_step(artist) != SQLITE_DONE) {
+      sqlite3_reset(artist);
+      snprintf(buf, sizeof(buf), "%s %d", name.c_str(), a);
+      name = buf;
+      sqlite3_bind_text(artist, 1, name.c_str(), -1, SQLITE_TRANSIENT);
+      sqlite3_bind_text(artist, 2, fixtureLabel(name).c_str(), -1, SQLITE_TRANSIENT);
+      sqlite3_step(artist);
+    }
+    sqlite3_reset(artist);
+    int artistId = (int)sqlite3_last_insert_rowid(db);
+    fixtureIndexName(item, term, ++itemId, 0, artistId, artistId, -1, name);
+
+    int albumCount = shape.albumsPerArtist / 2 + fixtureRandom(seed) % (shape.albumsPerArtist + 1);
+    for (int b = 0; b < std::max(albumCount, 1); b++) {
+      snprintf(buf, sizeof(buf), "%s %d", fixtureName(seed, fixtureRandom(seed) % 4 + 1).c_str(), b);
+      std::string albumName = buf;
+      sqlite3_bind_int(album, 1, artistId);
+      sqlite3_bind_text(album, 2, albumName.c_str(), -1, SQLITE_TRANSIENT);
+      sqlite3_bind_text(album, 3, fixtureLabel(albumName).c_str(), -1, SQLITE_TRANSIENT);
+      if (b % 5 == 4) sqlite3_bind_null(album, 4); else sqlite3_bind_int(album, 4, 1960 + fixtureRandom(seed) % 60);
+      sqlite3_step(album);
+      sqlite3_reset(album);
+      int albumId = (int)sqlite3_last_insert_rowid(db);
+      fixtureIndexName(item, term, ++itemId, 1, albumId, artistId, albumId, albumName);
+
+      int trackCount = shape.songsPerAlbum / 2 + fixtureRandom(seed) % (shape.songsPerAlbum + 1);
+      for (int t = 0; t < std::max(trackCount, 1); t++) {
+        std::string title = fixtureName(seed, fixtureRandom(seed) % 5 + 1);
+        snprintf(buf, sizeof(buf), "/Music/%d/%d/%02d %s.mp3", artistId, albumId, t + 1, title.c_str());
+        sqlite3_bind_int(song, 1, albumId);
+        sqlite3_bind_text(song, 2, title.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(song, 3, fixtureLabel(title).c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(song, 4, buf, -1, SQLITE_TRANSIENT);
+        if (t % 11 == 10) sqlite3_bind_null(song, 5); else sqlite3_bind_int(song, 5, t + 1);
+        sqlite3_bind_int(song, 6, 60 + fixtureRandom(seed) % 480);
+        sqlite3_bind_int(song, 7, 1000000 + fixtureRandom(seed) % 9000000);
+        sqlite3_bind_double(song, 8, -12.0 + (fixtureRandom(seed) % 1800) / 100.0);
+        sqlite3_bind_double(song, 9, -9.0 + (albumId % 1200) / 100.0);
+        sqlite3_step(song);
+        sqlite3_reset(song);
+        int songId = (int)sqlite3_last_insert_rowid(db);
+        fixtureIndexName(item, term, ++itemId, 2, songId, artistId, albumId, title);
+        songCount++;
+      }
+    }
+  }
+
+  sqlite3_finalize(artist);
+  sqlite3_finalize(album);
+  sqlite3_finalize(song);
+  sqlite3_finalize(item);
+  sqlite3_finalize(term);
+
+  bool ok = fixtureBuildJumps(db) && fixtureExec(db, "COMMIT");
+  sqlite3_close(db);
+  return ok ? songCount : -1;
+}
+
+#endif
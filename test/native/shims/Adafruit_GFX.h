@@ -0,0 +1,165 @@
+#ifndef NATIVE_ADAFRUIT_GFX_SHIM_H
+#define NATIVE_ADAFRUIT_GFX_SHIM_H
+
+// The part of Adafruit_GFX that FrameBuffer builds on: the virtual
+// primitives with the library's default fall-through to drawPixel(), and
+// classic-font text with the library's cell layout (5x7 glyph, spacing
+// column, size scaling, wrap, transparent vs opaque background).
+//
+// Glyph shapes are not the library's font: each column is derived from
+// the character code. Suites compare FrameBuffer against this same
+// drawChar(), so the shapes only need to differ per character.
+
+#include <Arduino.h>
+#include <vector>
+
+struct GFXfont;
+
+class Adafruit_GFX : public Print {
+public:
+  Adafruit_GFX(int16_t w, int16_t h)
+    : WIDTH(w), HEIGHT(h), _width(w), _height(h), cursor_x(0), cursor_y(0),
+      textcolor(0xFFFF), textbgcolor(0xFFFF), textsize_x(1), textsize_y(1),
+      wrap(true), gfxFont(NULL) {}
+  virtual ~Adafruit_GFX() {}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+  virtual void startWrite() {}
+  virtual void endWrite() {}
+  virtual void writePixel(int16_t x, int16_t y, uint16_t color) { drawPixel(x, y, color); }
+  virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    fillRect(x, y, w, h, color);
+  }
+  virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { drawFastVLine(x, y, h, color); }
+  virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { drawFastHLine(x, y, w, color); }
+
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    for (int16_t i = 0; i < h; i++) drawPixel(x, y + i, color);
+  }
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    for (int16_t i = 0; i < w; i++) drawPixel(x + i, y, color);
+  }
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    for (int16_t i = x; i < x + w; i++) writeFastVLine(i, y, h, color);
+  }
+  virtual void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    writeFastHLine(x, y, w, color);
+    writeFastHLine(x, y + h - 1, w, color);
+    writeFastVLine(x, y, h, color);
+    writeFastVLine(x + w - 1, y, h, color);
+  }
+
+  // Column i (0-4) of glyph c, bit 0 = top row. Space is blank; row 7 is
+  // the descender row and stays clear, as in the classic font.
+  static uint8_t glyphColumn(uint8_t c, int i) {
+    if (c == ' ') {
+      return 0;
+    }
+    uint32_t h = (c + 1) * 2654435761u + (i + 1) * 40503u;
+    return (uint8_t)((h >> 13) & 0x7F) | (i == 2 ? 0x01 : 0);
+  }
+
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+    drawChar(x, y, c, color, bg, size, size);
+  }
+
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg,
+                uint8_t size_x, uint8_t size_y) {
+    if (x >= _width || y >= _height || x + 6 * size_x - 1 < 0 || y + 8 * size_y - 1 < 0) {
+      return;
+    }
+
+    startWrite();
+    for (int8_t i = 0; i < 5; i++) {
+      uint8_t line = glyphColumn(c, i);
+      for (int8_t j = 0; j < 8; j++, line >>= 1) {
+        if (line & 1) {
+          if (size_x == 1 && size_y == 1) writePixel(x + i, y + j, color);
+          else writeFillRect(x + i * size_x, y + j * size_y, size_x, size_y, color);
+        } else if (bg != color) {
+          if (size_x == 1 && size_y == 1) writePixel(x + i, y + j, bg);
+          else writeFillRect(x + i * size_x, y + j * size_y, size_x, size_y, bg);
+        }
+      }
+    }
+    if (bg != color) {
+      if (size_x == 1 && size_y == 1) writeFastVLine(x + 5, y, 8, bg);
+      else writeFillRect(x + 5 * size_x, y, size_x, 8 * size_y, bg);
+    }
+    endWrite();
+  }
+
+  using Print::write;
+  size_t write(uint8_t c) override {
+    if (c == '\n') {
+      cursor_x = 0;
+      cursor_y += textsize_y * 8;
+    } else if (c != '\r') {
+      if (wrap && cursor_x + textsize_x * 6 > _width) {
+        cursor_x = 0;
+        cursor_y += textsize_y * 8;
+      }
+      drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x, textsize_y);
+      cursor_x += textsize_x * 6;
+    }
+    return 1;
+  }
+
+  void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+  void setTextSize(uint8_t s) { textsize_x = textsize_y = s > 0 ? s : 1; }
+  void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+  void setTextColor(uint16_t c, uint16_t bg) { textcolor = c; textbgcolor = bg; }
+  void setTextWrap(bool w) { wrap = w; }
+
+  int16_t width() const { return _width; }
+  int16_t height() const { return _height; }
+
+protected:
+  const int16_t WIDTH;
+  const int16_t HEIGHT;
+  int16_t _width;
+  int16_t _height;
+  int16_t cursor_x;
+  int16_t cursor_y;
+  uint16_t textcolor;
+  uint16_t textbgcolor;
+  uint8_t textsize_x;
+  uint8_t textsize_y;
+  bool wrap;
+  GFXfont* gfxFont;
+};
+
+// 1-bit canvas, as used to capture glyph masks
+class GFXcanvas1 : public Adafruit_GFX {
+public:
+  GFXcanvas1(int16_t w, int16_t h) : Adafruit_GFX(w, h), bits((w * h + 7) / 8, 0) {}
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    if (x < 0 || y < 0 || x >= _width || y >= _height) {
+      return;
+    }
+    int i = y * _width + x;
+    if (color) bits[i / 8] |= 0x80 >> (i & 7);
+    else bits[i / 8] &= ~(0x80 >> (i & 7));
+  }
+
+  void fillScreen(uint16_t color) override {
+    std::fill(bits.begin(), bits.end(), color ? 0xFF : 0x00);
+  }
+
+  bool getPixel(int16_t x, int16_t y) const {
+    if (x < 0 || y < 0 || x >= _width || y >= _height) {
+      return false;
+    }
+    int i = y * _width + x;
+    return bits[i / 8] & (0x80 >> (i & 7));
+  }
+
+private:
+  std::vector<uint8_t> bits;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef NATIVE_ADAFRUIT_SPITFT_SHIM_H
+#define NATIVE_ADAFRUIT_SPITFT_SHIM_H
+
+// A panel that keeps its RGB565 pixels in memory and counts what would
+// have crossed SPI: address windows opened and pixel bytes sent. Block
+// writes land in the current window in raster order, like the ST7789's
+// RAMWR; direct primitives cost one window and their pixels each.
+
+#include <Adafruit_GFX.h>
+
+class Adafruit_SPITFT : public Adafruit_GFX {
+public:
+  Adafruit_SPITFT(uint16_t w, uint16_t h)
+    : Adafruit_GFX(w, h), ram((size_t)w * h, 0), windowX(0), windowY(0), windowW(0), windowH(0),
+      windowPos(0), windows(0), bytes(0) {}
+
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    windowX = x;
+    windowY = y;
+    windowW = w;
+    windowH = h;
+    windowPos = 0;
+    windows++;
+  }
+
+  void writePixels(uint16_t* colors, uint32_t len, bool block = true, bool bigEndian = false) {
+    for (uint32_t i = 0; i < len; i++, windowPos++) {
+      uint32_t row = windowPos / windowW;
+      if (row >= windowH) {
+        break;
+      }
+      store(windowX + windowPos % windowW, windowY + row, colors[i]);
+    }
+    bytes += (uint64_t)len * sizeof(uint16_t);
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    windows++;
+    bytes += sizeof(uint16_t);
+    store(x, y, color);
+  }
+
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
+    windows++;
+    for (int16_t row = y; row < y + h; row++) {
+      for (int16_t col = x; col < x + w; col++) {
+        if (store(col, row, color)) {
+          bytes += sizeof(uint16_t);
+        }
+      }
+    }
+  }
+
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override { fillRect(x, y, w, 1, color); }
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override { fillRect(x, y, 1, h, color); }
+
+  uint16_t pixel(int16_t x, int16_t y) const { return ram[y * WIDTH + x]; }
+
+  void resetCounters() {
+    windows = 0;
+    bytes = 0;
+  }
+
+  uint32_t windowCount() const { return windows; }
+  uint64_t byteCount() const { return bytes; }
+
+private:
+  std::vector<uint16_t> ram;
+  uint16_t windowX;
+  uint16_t windowY;
+  uint16_t windowW;
+  uint16_t windowH;
+  uint32_t windowPos;
+  uint32_t windows;
+  uint64_t bytes;
+
+  bool store(int16_t x, int16_t y, uint16_t color) {
+    if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT) {
+      return false;
+    }
+    ram[y * WIDTH + x] = color;
+    return true;
+  }
+};
+
+#endif
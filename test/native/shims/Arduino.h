@@ -0,0 +1,121 @@
+#ifndef NATIVE_ARDUINO_SHIM_H
+#define NATIVE_ARDUINO_SHIM_H
+
+// Just enough of the Arduino/ESP32 core for the hardware-free modules to
+// build in the native test env. Time is a fake clock the tests advance;
+// FreeRTOS locks are no-ops because every suite is single-threaded.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+
+using std::min;
+using std::max;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define IRAM_ATTR
+
+// ----------------------------------------------------------------------------
+// Time
+// ----------------------------------------------------------------------------
+
+inline uint32_t& nativeMillis() {
+  static uint32_t now = 0;
+  return now;
+}
+
+inline void setMillis(uint32_t ms) { nativeMillis() = ms; }
+inline void advanceMillis(uint32_t ms) { nativeMillis() += ms; }
+
+inline unsigned long millis() { return nativeMillis(); }
+
+// Real time, for the benchmarks
+inline unsigned long micros() {
+  using namespace std::chrono;
+  return (unsigned long)duration_cast<microseconds>(
+      steady_clock::now().time_since_epoch()).count();
+}
+
+// ----------------------------------------------------------------------------
+// Memory
+// ----------------------------------------------------------------------------
+
+inline void* ps_malloc(size_t size) { return malloc(size); }
+inline void* ps_calloc(size_t n, size_t size) { return calloc(n, size); }
+
+// 4 MB of PSRAM, all of it free
+class EspClass {
+public:
+  EspClass() {}
+  uint32_t getPsramSize() { return 4 * 1024 * 1024; }
+  uint32_t getFreePsram() { return 4 * 1024 * 1024; }
+};
+
+static EspClass ESP;
+
+// ----------------------------------------------------------------------------
+// Print / Serial
+// ----------------------------------------------------------------------------
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t b) = 0;
+  virtual size_t write(const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+      write(data[i]);
+    }
+    return len;
+  }
+  virtual int availableForWrite() { return 0; }
+
+  size_t print(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+};
+
+class HardwareSerial {
+public:
+  void begin(unsigned long) {}
+
+  int printf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int n = vprintf(format, args);
+    va_end(args);
+    return n;
+  }
+
+  void print(const char* text) { fputs(text, stdout); }
+  void println(const char* text) { puts(text); }
+  void println() { putchar('\n'); }
+};
+
+static HardwareSerial Serial;
+
+// ----------------------------------------------------------------------------
+// FreeRTOS
+// ----------------------------------------------------------------------------
+
+typedef void* SemaphoreHandle_t;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define portMAX_DELAY 0xffffffff
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() {
+  static int handle;
+  return &handle;
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t) { return pdTRUE; }
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t) { return pdTRUE; }
+
+#endif
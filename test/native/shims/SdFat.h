@@ -0,0 +1,58 @@
+#ifndef NATIVE_SDFAT_SHIM_H
+#define NATIVE_SDFAT_SHIM_H
+
+// SdFat's file API on top of stdio, read-only: card paths are host paths
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <stdint.h>
+
+class File32 {
+public:
+  File32() : fp(NULL) {}
+
+  explicit operator bool() const { return fp != NULL; }
+
+  uint64_t size() {
+    long at = ftell(fp);
+    fseek(fp, 0, SEEK_END);
+    long end = ftell(fp);
+    fseek(fp, at, SEEK_SET);
+    return end;
+  }
+
+  bool seekSet(uint64_t pos) { return fseek(fp, (long)pos, SEEK_SET) == 0; }
+
+  int read(void* buf, size_t count) {
+    size_t n = fread(buf, 1, count, fp);
+    return n == 0 && ferror(fp) ? -1 : (int)n;
+  }
+
+  void close() {
+    if (fp) fclose(fp);
+    fp = NULL;
+  }
+
+private:
+  friend class SdFat32;
+  FILE* fp;
+};
+
+class SdFat32 {
+public:
+  bool exists(const char* path) {
+    struct stat st;
+    return stat(path, &st) == 0;
+  }
+
+  File32 open(const char* path, int flags = O_RDONLY) {
+    File32 file;
+    if (flags == O_RDONLY) {
+      file.fp = fopen(path, "rb");
+    }
+    return file;
+  }
+};
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef NATIVE_ESP_HEAP_CAPS_SHIM_H
+#define NATIVE_ESP_HEAP_CAPS_SHIM_H
+
+// One heap on the host; capabilities are accepted and ignored
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MALLOC_CAP_DMA      (1 << 3)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+
+inline void* heap_caps_malloc(size_t size, uint32_t caps) { return malloc(size); }
+inline void heap_caps_free(void* p) { free(p); }
+
+#endif
@@ -0,0 +1,142 @@
+// ButtonPress filter: ISR edge traces -> presses handed to pollButtons()
+
+#include <unity.h>
+#include "../../../src/ButtonPress.cpp"
+
+static const uint32_t MIN_HOLD_MS = 10;   // ADC pins
+static const uint32_t DEBOUNCE_MS = 300;
+
+static ButtonPress button;
+
+void setUp(void)
+{
+  buttonPressReset(button, MIN_HOLD_MS, DEBOUNCE_MS);
+}
+
+void tearDown(void) {}
+
+static int takeAll(ButtonPress& b)
+{
+  int presses = 0;
+  while (buttonPressTake(b)) {
+    presses++;
+  }
+  return presses;
+}
+
+// Press and release at `downMs`, held for `holdMs`
+static void tap(uint32_t downMs, uint32_t holdMs)
+{
+  buttonPressEdge(button, true, downMs);
+  buttonPressEdge(button, false, downMs + holdMs);
+}
+
+// The old filter re-read the pin when draining and dropped this press
+void test_press_released_before_poll_counts(void)
+{
+  tap(1000, 40);
+
+  buttonPressPoll(button, 1500);  // loop() was busy; the pin is high again
+  TEST_ASSERT_EQUAL(1, takeAll(button));
+  TEST_ASSERT_EQUAL(0, takeAll(button));
+}
+
+void test_held_press_counts_once_hold_is_reached(void)
+{
+  buttonPressEdge(button, true, 1000);
+
+  buttonPressPoll(button, 1005);
+  TEST_ASSERT_EQUAL(0, takeAll(button));
+
+  buttonPressPoll(button, 1010);
+  TEST_ASSERT_EQUAL(1, takeAll(button));
+
+  // Still held, then released: no second press
+  buttonPressPoll(button, 1200);
+  buttonPressEdge(button, false, 1400);
+  TEST_ASSERT_EQUAL(0, takeAll(button));
+}
+
+void test_short_pulse_is_a_glitch(void)
+{
+  TEST_ASSERT_FALSE(buttonPressEdge(button, true, 1000));
+  TEST_ASSERT_TRUE(buttonPressEdge(button, false, 1000 + MIN_HOLD_MS - 1));
+
+  buttonPressPoll(button, 2000);
+  TEST_ASSERT_EQUAL(0, takeAll(button));
+}
+
+// Three presses queued between two polls are all handed out
+void test_presses_are_counted_not_latched(void)
+{
+  tap(1000, 50);
+  tap(1400, 50);
+  tap(1800, 50);
+
+  buttonPressPoll(button, 2500);
+  TEST_ASSERT_EQUAL(3, takeAll(button));
+}
+
+// Contact bounce right after a press, and a second press inside the
+// debounce window, are not extra presses
+void test_bounce_and_repeats_inside_debounce_are_ignored(void)
+{
+  buttonPressEdge(button, true, 1000);
+  buttonPressEdge(button, false, 1001);
+  buttonPressEdge(button, true, 1002);
+  buttonPressEdge(button, false, 1080);
+
+  tap(1000 + DEBOUNCE_MS, 50);      // not past the window yet
+  tap(1000 + DEBOUNCE_MS + 1, 50);  // not past it from the accepted press either
+  buttonPressPoll(button, 2000);
+  TEST_ASSERT_EQUAL(1, takeAll(button));
+
+  tap(1002 + DEBOUNCE_MS + 1, 50);
+  buttonPressPoll(button, 2000);
+  TEST_ASSERT_EQUAL(1, takeAll(button));
+}
+
+// A lost release edge must not leave the button stuck down
+void test_missed_release_starts_a_new_press(void)
+{
+  buttonPressEdge(button, true, 1000);
+  buttonPressPoll(button, 1100);
+  TEST_ASSERT_EQUAL(1, takeAll(button));
+
+  buttonPressEdge(button, true, 2000);
+  buttonPressEdge(button, false, 2050);
+  TEST_ASSERT_EQUAL(1, takeAll(button));
+}
+
+// The center button has no hold filter: it counts on the down edge
+void test_zero_hold_counts_on_down_edge(void)
+{
+  buttonPressReset(button, 0, DEBOUNCE_MS);
+
+  buttonPressEdge(button, true, 1000);
+  TEST_ASSERT_EQUAL(1, takeAll(button));
+
+  TEST_ASSERT_FALSE(buttonPressEdge(button, false, 1000));
+  TEST_ASSERT_EQUAL(0, takeAll(button));
+}
+
+void test_release_without_press_is_ignored(void)
+{
+  TEST_ASSERT_FALSE(buttonPressEdge(button, false, 1000));
+  buttonPressPoll(button, 2000);
+  TEST_ASSERT_EQUAL(0, takeAll(button));
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_press_released_before_poll_counts);
+  RUN_TEST(test_held_press_counts_once_hold_is_reached);
+  RUN_TEST(test_short_pulse_is_a_glitch);
+  RUN_TEST(test_presses_are_counted_not_latched);
+  RUN_TEST(test_bounce_and_repeats_inside_debounce_are_ignored);
+  RUN_TEST(test_missed_release_starts_a_new_press);
+  RUN_TEST(test_zero_hold_counts_on_down_edge);
+  RUN_TEST(test_release_without_press_is_ignored);
+  return UNITY_END();
+}
@@ -0,0 +1,252 @@
+// Equal-power crossfade mixer: fade shape, per-track gains, ended sides,
+// and the mixer's cost per frame
+
+#include <unity.h>
+#include <vector>
+#include "../../../src/GainStage.cpp"
+#include "../../../src/Crossfade.cpp"
+
+class FrameSink : public Print {
+public:
+  std::vector<int16_t> samples;
+
+  size_t write(uint8_t b) override { return 1; }
+
+  size_t write(const uint8_t* data, size_t len) override {
+    const int16_t* pcm = (const int16_t*)data;
+    samples.insert(samples.end(), pcm, pcm + len / 2);
+    return len;
+  }
+
+  size_t frames() const { return samples.size() / 2; }
+  int16_t left(size_t frame) const { return samples[2 * frame]; }
+  int16_t right(size_t frame) const { return samples[2 * frame + 1]; }
+};
+
+static Crossfader fader;
+static FrameSink sink;
+
+// `count` frames of a constant level on one side
+static void stage(CrossfadeSide side, int16_t level, uint32_t count)
+{
+  std::vector<int16_t> pcm(count * 2, level);
+  fader.side(side).write((const uint8_t*)&pcm[0], count * 4);
+}
+
+void setUp(void)
+{
+  fader.reset();
+  sink.samples.clear();
+}
+
+void tearDown(void) {}
+
+// ---------------------------------------------------------------------------
+// Fade shape
+// ---------------------------------------------------------------------------
+
+// Outgoing +10000 against incoming -10000 at equal gain: the start is the
+// outgoing signal, the two cancel at the midpoint, the end is the incoming
+void test_start_middle_end(void)
+{
+  const uint32_t frames = 4096;
+
+  fader.start(sink, frames, GAIN_UNITY, GAIN_UNITY);
+  stage(CROSSFADE_OUT, 10000, frames);
+  stage(CROSSFADE_IN, -10000, frames);
+  fader.pump();
+
+  TEST_ASSERT_EQUAL(frames, sink.frames());
+  TEST_ASSERT_INT_WITHIN(1, 10000, sink.left(0));
+  TEST_ASSERT_INT_WITHIN(1, 10000, sink.right(0));
+  TEST_ASSERT_INT_WITHIN(1, 0, sink.left(frames / 2));
+  TEST_ASSERT_INT_WITHIN(1, 0, sink.right(frames / 2));
+  TEST_ASSERT_INT_WITHIN(20, -10000, sink.left(frames - 1));
+  TEST_ASSERT_FALSE(fader.outgoingDone());   // Not ended yet
+}
+
+// Equal power: with both sides at the same polarity the level stays near
+// the input all the way through instead of dipping 3 dB at the midpoint
+void test_equal_power_sum(void)
+{
+  const uint32_t frames = 2048;
+
+  fader.start(sink, frames, GAIN_UNITY, GAIN_UNITY);
+  stage(CROSSFADE_OUT, 10000, frames);
+  stage(CROSSFADE_IN, 10000, frames);
+  fader.pump();
+
+  // sin + cos peaks at sqrt(2) in the middle
+  TEST_ASSERT_INT_WITHIN(20, 14142, sink.left(frames / 2));
+
+  for (size_t i = 1; i < sink.frames(); i++) {
+    TEST_ASSERT_GREATER_OR_EQUAL(9990, sink.left(i));
+    TEST_ASSERT_LESS_OR_EQUAL(14143, sink.left(i));
+  }
+}
+
+// Fade gains are smooth: no frame-to-frame jump bigger than the slope
+void test_fade_is_smooth(void)
+{
+  const uint32_t frames = 44100;
+
+  fader.start(sink, frames, GAIN_UNITY, GAIN_UNITY);
+  for (uint32_t done = 0; done < frames; done += 4096) {
+    uint32_t n = min((uint32_t)4096, frames - done);
+    stage(CROSSFADE_OUT, 20000, n);
+    stage(CROSSFADE_IN, 0, n);
+    fader.pump();
+  }
+
+  TEST_ASSERT_EQUAL(frames, sink.frames());
+  for (size_t i = 1; i < sink.frames(); i++) {
+    TEST_ASSERT_LESS_OR_EQUAL(sink.left(i - 1), sink.left(i));
+    TEST_ASSERT_LESS_OR_EQUAL(4, sink.left(i - 1) - sink.left(i));
+  }
+  // The 16.16 step rounds down, so the last frame is a fraction of a
+  // table entry short of silence (about -55 dB here)
+  TEST_ASSERT_INT_WITHIN(40, 0, sink.left(frames - 1));
+}
+
+// Each side carries its own track gain on top of the fade
+void test_track_gains(void)
+{
+  const uint32_t frames = 1024;
+
+  fader.start(sink, frames, GAIN_UNITY / 2, GAIN_MAX);
+  stage(CROSSFADE_OUT, 12000, frames + 64);
+  stage(CROSSFADE_IN, 12000, frames + 64);
+  fader.pump();
+
+  TEST_ASSERT_INT_WITHIN(1, 6000, sink.left(0));
+
+  // Past the end of the fade the incoming side is at 2x on its own
+  TEST_ASSERT_INT_WITHIN(2, 24000, sink.left(frames + 32));
+
+  // Out-of-range gains are clamped rather than wrapping
+  setUp();
+  fader.start(sink, frames, GAIN_MAX * 4, -5);
+  stage(CROSSFADE_OUT, 10000, 1);
+  stage(CROSSFADE_IN, 10000, 1);
+  fader.pump();
+  TEST_ASSERT_INT_WITHIN(1, 20000, sink.left(0));
+}
+
+// ---------------------------------------------------------------------------
+// Sides
+// ---------------------------------------------------------------------------
+
+// While both sides are live only the frames both have are mixed
+void test_live_sides_limit_the_mix(void)
+{
+  fader.start(sink, 1000, GAIN_UNITY, GAIN_UNITY);
+  stage(CROSSFADE_OUT, 1000, 100);
+  stage(CROSSFADE_IN, 1000, 300);
+  fader.pump();
+
+  TEST_ASSERT_EQUAL(100, sink.frames());
+  TEST_ASSERT_EQUAL(CROSSFADE_OUT, fader.next());
+}
+
+// An outgoing track that ends early mixes exactly as if it had carried on
+// with silence
+void test_ended_side_is_silence(void)
+{
+  const uint32_t frames = 1000;
+
+  fader.start(sink, frames, GAIN_UNITY, GAIN_UNITY);
+  stage(CROSSFADE_OUT, 9000, 100);
+  stage(CROSSFADE_OUT, 0, 400);
+  stage(CROSSFADE_IN, 7000, 500);
+  fader.pump();
+  std::vector<int16_t> padded = sink.samples;
+
+  setUp();
+  fader.start(sink, frames, GAIN_UNITY, GAIN_UNITY);
+  stage(CROSSFADE_OUT, 9000, 100);
+  fader.end(CROSSFADE_OUT);
+  TEST_ASSERT_EQUAL(CROSSFADE_IN, fader.next());
+  stage(CROSSFADE_IN, 7000, 500);
+  fader.pump();
+
+  TEST_ASSERT_TRUE(fader.outgoingDone());
+  TEST_ASSERT_EQUAL(padded.size(), sink.samples.size());
+  TEST_ASSERT_EQUAL(0, memcmp(&padded[0], &sink.samples[0], padded.size() * 2));
+}
+
+// finish() flushes whatever is still staged
+void test_finish_flushes(void)
+{
+  fader.start(sink, 1000, GAIN_UNITY, GAIN_UNITY);
+  stage(CROSSFADE_OUT, 5000, 40);
+  stage(CROSSFADE_IN, 5000, 70);
+  fader.finish();
+
+  TEST_ASSERT_EQUAL(70, sink.frames());
+  TEST_ASSERT_FALSE(fader.active());
+}
+
+// A full stage drops the excess and counts it
+void test_stage_overflow_is_counted(void)
+{
+  uint32_t before = fader.dropped();
+  const uint32_t room = CROSSFADE_STAGE_BYTES / 4;
+
+  fader.start(sink, 1000, GAIN_UNITY, GAIN_UNITY);
+  stage(CROSSFADE_OUT, 1, room + 10);
+  fader.reset();
+
+  TEST_ASSERT_EQUAL(10, fader.dropped() - before);
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+
+// A 10 s fade, decoded in Helix-sized chunks
+void test_benchmark_mix(void)
+{
+  const uint32_t frames = CROSSFADE_MAX_SECONDS * CROSSFADE_SAMPLE_RATE;
+  const uint32_t chunk = 1152;
+  std::vector<int16_t> pcm(chunk * 2);
+
+  for (uint32_t i = 0; i < chunk * 2; i++) {
+    pcm[i] = (int16_t)(i * 97);
+  }
+
+  uint32_t dropped = fader.dropped();
+  sink.samples.reserve(frames * 2 + chunk * 2);
+  fader.start(sink, frames, GAIN_UNITY, GAIN_UNITY);
+
+  unsigned long start = micros();
+  for (uint32_t done = 0; done < frames; done += chunk) {
+    fader.side(CROSSFADE_OUT).write((const uint8_t*)&pcm[0], chunk * 4);
+    fader.side(CROSSFADE_IN).write((const uint8_t*)&pcm[0], chunk * 4);
+    fader.pump();
+  }
+  unsigned long elapsed = micros() - start;
+
+  TEST_ASSERT_GREATER_OR_EQUAL(frames, sink.frames());
+  fader.reset();
+  TEST_ASSERT_EQUAL(dropped, fader.dropped());
+  Serial.printf("🎚️ Crossfade mix: %u frames in %lu us, %.1f ns/frame\n",
+                (unsigned)sink.frames(), elapsed, elapsed * 1000.0 / sink.frames());
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  if (!fader.begin()) {
+    return 1;
+  }
+  RUN_TEST(test_start_middle_end);
+  RUN_TEST(test_equal_power_sum);
+  RUN_TEST(test_fade_is_smooth);
+  RUN_TEST(test_track_gains);
+  RUN_TEST(test_live_sides_limit_the_mix);
+  RUN_TEST(test_ended_side_is_silence);
+  RUN_TEST(test_finish_flushes);
+  RUN_TEST(test_stage_overflow_is_counted);
+  RUN_TEST(test_benchmark_mix);
+  return UNITY_END();
+}
@@ -0,0 +1,163 @@
+// EncoderAccel curve: detents per second -> list rows per detent
+
+#include <unity.h>
+#include "../../../src/EncoderAccel.cpp"
+
+static EncoderAccel accel;
+static uint32_t now;
+
+void setUp(void)
+{
+  encoderAccelReset(accel);
+  now = 10000;
+}
+
+void tearDown(void) {}
+
+// Feed `detents` every `intervalMs` until the smoothed rate has settled,
+// and return the steps the last batch was worth
+static int settledSteps(uint32_t intervalMs, int detents)
+{
+  int steps = 0;
+  for (int i = 0; i < 40; i++) {
+    now += intervalMs;
+    steps = encoderAccelSteps(accel, now, detents);
+  }
+  return steps;
+}
+
+void test_first_detents_of_a_spin_are_unit_speed(void)
+{
+  TEST_ASSERT_EQUAL(1, encoderAccelSteps(accel, now, 1));
+
+  encoderAccelReset(accel);
+  TEST_ASSERT_EQUAL(7, encoderAccelSteps(accel, now, 7));
+}
+
+void test_no_detents_no_steps(void)
+{
+  TEST_ASSERT_EQUAL(0, encoderAccelSteps(accel, now, 0));
+  TEST_ASSERT_EQUAL(0, encoderAccelSteps(accel, now, -3));
+}
+
+// At or below ENCODER_ACCEL_SLOW_RATE every detent is one row
+void test_slow_rate_is_one_row_per_detent(void)
+{
+  TEST_ASSERT_EQUAL(1, settledSteps(125, 1));    // 8/s
+  setUp();
+  TEST_ASSERT_EQUAL(1, settledSteps(200, 1));    // 5/s
+  setUp();
+  TEST_ASSERT_EQUAL(2, settledSteps(250, 2));    // 8/s in 2-detent batches
+}
+
+// Points on the quadratic ease-in between the slow and fast rates
+void test_rate_to_step_mapping(void)
+{
+  // 20/s: t = 0.375, 1 + 0.140625 * 9 = 2.27 rows per detent
+  TEST_ASSERT_EQUAL(2, settledSteps(50, 1));
+
+  // 24/s in 3-detent batches: t = 0.5, 3 * 3.25 = 9.75
+  setUp();
+  TEST_ASSERT_EQUAL(10, settledSteps(125, 3));
+
+  // 32/s in 4-detent batches: t = 0.75, 4 * 6.0625 = 24.25
+  setUp();
+  TEST_ASSERT_EQUAL(24, settledSteps(125, 4));
+}
+
+// Faster never moves fewer rows per detent
+void test_steps_are_monotonic_in_rate(void)
+{
+  int previous = 0;
+
+  for (uint32_t interval = 240; interval >= 4; interval -= 4) {
+    setUp();
+    int steps = settledSteps(interval, 2);
+
+    TEST_ASSERT_GREATER_OR_EQUAL(previous, steps);
+    TEST_ASSERT_GREATER_OR_EQUAL(2, steps);
+    previous = steps;
+  }
+
+  TEST_ASSERT_EQUAL(2 * ENCODER_ACCEL_MAX_STEP, previous);
+}
+
+// Past ENCODER_ACCEL_FAST_RATE the multiplier stops at ENCODER_ACCEL_MAX_STEP
+void test_fast_rate_is_capped(void)
+{
+  TEST_ASSERT_EQUAL(ENCODER_ACCEL_MAX_STEP, settledSteps(25, 1));   // 40/s
+  setUp();
+  TEST_ASSERT_EQUAL(ENCODER_ACCEL_MAX_STEP, settledSteps(5, 1));    // 200/s
+  setUp();
+  TEST_ASSERT_EQUAL(12 * ENCODER_ACCEL_MAX_STEP, settledSteps(10, 12));
+}
+
+// One fast reading after slow ones is averaged, not taken as is
+void test_single_fast_reading_is_smoothed(void)
+{
+  settledSteps(200, 1);   // 5/s
+
+  now += 25;              // 40/s instantaneous, full speed if taken as is
+  int steps = encoderAccelSteps(accel, now, 1);
+
+  TEST_ASSERT_EQUAL(3, steps);   // Averaged to 22.5/s
+}
+
+// The rest of a batch split across updates keeps the batch's speed
+void test_same_timestamp_reuses_rate(void)
+{
+  int full = settledSteps(50, 4);
+  int part = encoderAccelSteps(accel, now, 4);
+
+  TEST_ASSERT_EQUAL(full, part);
+}
+
+// A pause longer than ENCODER_ACCEL_IDLE_MS starts over at unit speed
+void test_idle_gap_resets_speed(void)
+{
+  TEST_ASSERT_EQUAL(ENCODER_ACCEL_MAX_STEP, settledSteps(10, 1));
+
+  now += ENCODER_ACCEL_IDLE_MS + 1;
+  TEST_ASSERT_EQUAL(1, encoderAccelSteps(accel, now, 1));
+  TEST_ASSERT_EQUAL(0, encoderAccelSpinMs(accel));
+}
+
+// Spin time counts from when the rate reaches ENCODER_ACCEL_SPIN_RATE and
+// drops to zero once it falls back below
+void test_spin_time_tracks_sustained_speed(void)
+{
+  settledSteps(100, 1);   // 10/s, below the spin rate
+  TEST_ASSERT_EQUAL(0, encoderAccelSpinMs(accel));
+
+  uint32_t spinFrom = 0;
+  for (int i = 0; i < 40; i++) {
+    now += 20;            // 50/s
+    encoderAccelSteps(accel, now, 1);
+    if (spinFrom == 0 && accel.spinning) {
+      spinFrom = now;
+    }
+  }
+
+  TEST_ASSERT_TRUE(accel.spinning);
+  TEST_ASSERT_EQUAL(now - spinFrom, encoderAccelSpinMs(accel));
+  TEST_ASSERT_GREATER_OR_EQUAL(600, encoderAccelSpinMs(accel));
+
+  settledSteps(150, 1);   // back to ~7/s
+  TEST_ASSERT_EQUAL(0, encoderAccelSpinMs(accel));
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_first_detents_of_a_spin_are_unit_speed);
+  RUN_TEST(test_no_detents_no_steps);
+  RUN_TEST(test_slow_rate_is_one_row_per_detent);
+  RUN_TEST(test_rate_to_step_mapping);
+  RUN_TEST(test_steps_are_monotonic_in_rate);
+  RUN_TEST(test_fast_rate_is_capped);
+  RUN_TEST(test_single_fast_reading_is_smoothed);
+  RUN_TEST(test_same_timestamp_reuses_rate);
+  RUN_TEST(test_idle_gap_resets_speed);
+  RUN_TEST(test_spin_time_tracks_sustained_speed);
+  return UNITY_END();
+}
@@ -0,0 +1,381 @@
+// FrameBuffer on a counting fake panel: what the dirty-band flushes leave on
+// the panel must match the same drawing done pixel by pixel through the
+// plain Adafruit_GFX path, and a flush must only send the bands that
+// changed. The rendered scene is written to a PNG for inspection.
+
+#include <unity.h>
+#include "../../../src/FrameBuffer.cpp"
+
+#define SCREEN_W 240
+#define SCREEN_H 240
+
+#define COLOR_BG       0x0000
+#define COLOR_HEADER   0x18E3
+#define COLOR_TEXT     0xFFFF
+#define COLOR_SELECTED 0x07FF
+#define COLOR_ACCENT   0xFD20
+
+// Reference: every primitive falls through to drawPixel()
+class ReferenceCanvas : public Adafruit_GFX {
+public:
+  std::vector<uint16_t> pixels;
+
+  ReferenceCanvas() : Adafruit_GFX(SCREEN_W, SCREEN_H), pixels(SCREEN_W * SCREEN_H, 0) {}
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    if (x >= 0 && y >= 0 && x < SCREEN_W && y < SCREEN_H) {
+      pixels[y * SCREEN_W + x] = color;
+    }
+  }
+};
+
+static Adafruit_SPITFT* panel;
+static FrameBuffer* frame;
+static ReferenceCanvas* reference;
+
+static int mismatchedPixels()
+{
+  int bad = 0;
+  for (int y = 0; y < SCREEN_H; y++) {
+    for (int x = 0; x < SCREEN_W; x++) {
+      bad += panel->pixel(x, y) != reference->pixels[y * SCREEN_W + x];
+    }
+  }
+  return bad;
+}
+
+// ---------------------------------------------------------------------------
+// PNG dump (stored deflate blocks, 8-bit RGB)
+// ---------------------------------------------------------------------------
+
+static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t len)
+{
+  crc = ~crc;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int k = 0; k < 8; k++) {
+      crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+static void putBe32(std::vector<uint8_t>& out, uint32_t v)
+{
+  out.push_back(v >> 24);
+  out.push_back(v >> 16);
+  out.push_back(v >> 8);
+  out.push_back(v);
+}
+
+static void writeChunk(FILE* f, const char* type, const std::vector<uint8_t>& data)
+{
+  std::vector<uint8_t> chunk;
+  putBe32(chunk, data.size());
+  chunk.insert(chunk.end(), type, type + 4);
+  chunk.insert(chunk.end(), data.begin(), data.end());
+  putBe32(chunk, crc32(0, &chunk[4], chunk.size() - 4));
+  fwrite(&chunk[0], 1, chunk.size(), f);
+}
+
+static bool writePanelPng(const char* path)
+{
+  std::vector<uint8_t> raw;
+  for (int y = 0; y < SCREEN_H; y++) {
+    raw.push_back(0);  // Filter: none
+    for (int x = 0; x < SCREEN_W; x++) {
+      uint16_t c = panel->pixel(x, y);
+      raw.push_back(((c >> 11) & 0x1F) * 255 / 31);
+      raw.push_back(((c >> 5) & 0x3F) * 255 / 63);
+      raw.push_back((c & 0x1F) * 255 / 31);
+    }
+  }
+
+  std::vector<uint8_t> z;
+  z.push_back(0x78);
+  z.push_back(0x01);
+  for (size_t pos = 0; pos < raw.size(); pos += 65535) {
+    uint16_t len = min(raw.size() - pos, (size_t)65535);
+    z.push_back(pos + len == raw.size() ? 1 : 0);
+    z.push_back(len & 0xFF);
+    z.push_back(len >> 8);
+    z.push_back(~len & 0xFF);
+    z.push_back((uint16_t)~len >> 8);
+    z.insert(z.end(), raw.begin() + pos, raw.begin() + pos + len);
+  }
+  uint32_t a = 1, b = 0;
+  for (size_t i = 0; i < raw.size(); i++) {
+    a = (a + raw[i]) % 65521;
+    b = (b + a) % 65521;
+  }
+  putBe32(z, (b << 16) | a);
+
+  std::vector<uint8_t> header;
+  putBe32(header, SCREEN_W);
+  putBe32(header, SCREEN_H);
+  header.push_back(8);   // Bit depth
+  header.push_back(2);   // RGB
+  header.push_back(0);
+  header.push_back(0);
+  header.push_back(0);
+
+  FILE* f = fopen(path, "wb");
+  if (f == NULL) {
+    return false;
+  }
+  static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+  fwrite(signature, 1, 8, f);
+  writeChunk(f, "IHDR", header);
+  writeChunk(f, "IDAT", z);
+  writeChunk(f, "IEND", std::vector<uint8_t>());
+  return fclose(f) == 0;
+}
+
+// ---------------------------------------------------------------------------
+// Scenes, drawn identically on both targets
+// ---------------------------------------------------------------------------
+
+// A list screen: header, five rows with one selected, scroll indicator
+static void drawListScreen(Adafruit_GFX& g, int selected)
+{
+  g.fillScreen(COLOR_BG);
+  g.fillRect(0, 0, SCREEN_W, 30, COLOR_HEADER);
+  g.setTextSize(2);
+  g.setTextColor(COLOR_TEXT);
+  g.setCursor(8, 8);
+  g.print("Artists");
+
+  const char* rows[] = { "Abba", "Air", "Aphex Twin", "Arcade Fire", "Autechre" };
+  for (int i = 0; i < 5; i++) {
+    int y = 40 + i * 36;
+    uint16_t bg = (i == selected) ? COLOR_SELECTED : COLOR_BG;
+    g.fillRect(0, y - 4, SCREEN_W, 36, bg);
+    g.setTextColor(i == selected ? COLOR_BG : COLOR_TEXT, bg);
+    g.setCursor(8, y + 4);
+    g.print(rows[i]);
+  }
+
+  g.setTextSize(1);
+  g.setTextColor(COLOR_TEXT);
+  g.setCursor(SCREEN_W - 40, SCREEN_H - 20);
+  g.print("3/120");
+  g.drawRect(4, SCREEN_H - 12, 100, 8, COLOR_ACCENT);
+}
+
+// Text in every size, both background modes, and cells crossing each
+// edge of the screen (those take drawChar's clipped path)
+static void drawTextEdges(Adafruit_GFX& g)
+{
+  g.setTextWrap(false);
+  g.setTextSize(3);
+  g.setTextColor(COLOR_ACCENT, COLOR_HEADER);
+  g.setCursor(-7, 60);
+  g.print("Edge");
+  g.setCursor(SCREEN_W - 40, 100);
+  g.print("Right side");
+  g.setTextColor(COLOR_TEXT);
+  g.setCursor(30, -10);
+  g.print("Top");
+  g.setCursor(60, SCREEN_H - 12);
+  g.print("Bottom");
+  g.setTextWrap(true);
+  g.setTextSize(1);
+  g.setCursor(200, 150);
+  g.print("wraps onto the next line\nand breaks");
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+void setUp(void)
+{
+  panel = new Adafruit_SPITFT(SCREEN_W, SCREEN_H);
+  frame = new FrameBuffer(*panel, SCREEN_W, SCREEN_H);
+  reference = new ReferenceCanvas();
+  frame->begin();
+}
+
+void tearDown(void)
+{
+  delete frame;
+  delete panel;
+  delete reference;
+}
+
+// First flush sends the whole frame in one window per band
+void test_list_screen_matches_reference(void)
+{
+  TEST_ASSERT_TRUE(frame->active());
+
+  drawListScreen(*frame, 2);
+  drawListScreen(*reference, 2);
+  panel->resetCounters();
+
+  int bands = (SCREEN_H + FB_BAND_HEIGHT - 1) / FB_BAND_HEIGHT;
+  TEST_ASSERT_EQUAL(bands, frame->flush());
+  TEST_ASSERT_EQUAL(bands, panel->windowCount());
+  TEST_ASSERT_EQUAL(SCREEN_W * SCREEN_H * 2, panel->byteCount());
+  TEST_ASSERT_EQUAL(0, mismatchedPixels());
+
+  char path[256];
+  snprintf(path, sizeof(path), "%s/framebuffer_list.png", P_tmpdir);
+  TEST_ASSERT_TRUE(writePanelPng(path));
+  Serial.printf("🖼️ List screen written to %s\n", path);
+}
+
+void test_clipped_text_matches_reference(void)
+{
+  drawListScreen(*frame, 0);
+  drawListScreen(*reference, 0);
+  drawTextEdges(*frame);
+  drawTextEdges(*reference);
+  frame->flush();
+
+  TEST_ASSERT_EQUAL(0, mismatchedPixels());
+}
+
+// The atlas blit and drawChar agree on every glyph, size and bg mode
+void test_every_glyph_matches_draw_char(void)
+{
+  for (int mode = 0; mode < 2; mode++) {
+    for (uint8_t size = 1; size <= 3; size++) {
+      frame->fillScreen(COLOR_HEADER);
+      reference->fillScreen(COLOR_HEADER);
+
+      // Grid of cells; large sizes run out of room and overdraw from the top
+      int16_t cellW = FB_GLYPH_WIDTH * size;
+      int16_t cellH = FB_GLYPH_HEIGHT * size;
+      int columns = SCREEN_W / cellW;
+      int gridRows = SCREEN_H / cellH;
+
+      for (int c = 0; c < 256; c++) {
+        int16_t x = (c % columns) * cellW;
+        int16_t y = ((c / columns) % gridRows) * cellH;
+        uint16_t fg = 0x1000 + c;
+        uint16_t bg = mode ? fg : COLOR_BG;
+        frame->setCursor(x, y);
+        frame->setTextSize(size);
+        frame->setTextColor(fg, bg);
+        frame->write((uint8_t)c);
+        reference->setCursor(x, y);
+        reference->setTextSize(size);
+        reference->setTextColor(fg, bg);
+        reference->write((uint8_t)c);
+      }
+
+      frame->flush();
+      TEST_ASSERT_EQUAL(0, mismatchedPixels());
+    }
+  }
+}
+
+// An unchanged frame sends nothing; a one-row change sends only the bands
+// it touched, each trimmed to the changed columns
+void test_flush_sends_only_dirty_bands(void)
+{
+  drawListScreen(*frame, 1);
+  drawListScreen(*reference, 1);
+  frame->flush();
+
+  panel->resetCounters();
+  TEST_ASSERT_EQUAL(0, frame->flush());
+  TEST_ASSERT_EQUAL(0, panel->byteCount());
+
+  // Retype the third row's label at size 2 (rows 116-131, bands 7 and 8)
+  for (int pass = 0; pass < 2; pass++) {
+    Adafruit_GFX& g = pass ? (Adafruit_GFX&)*reference : (Adafruit_GFX&)*frame;
+    g.setTextSize(2);
+    g.setTextColor(COLOR_TEXT, COLOR_BG);
+    g.setCursor(8, 116);
+    g.print("Aphex Twins");
+  }
+
+  panel->resetCounters();
+  TEST_ASSERT_EQUAL(2, frame->flush());
+  TEST_ASSERT_EQUAL(2, panel->windowCount());
+
+  // 11 cells of 12 px: columns 8-139 in both bands, 16 rows each
+  TEST_ASSERT_EQUAL((11 * 12) * FB_BAND_HEIGHT * 2 * 2, panel->byteCount());
+  TEST_ASSERT_EQUAL(0, mismatchedPixels());
+
+  // One opaque glyph whose bottom (blank descender) row is the first row
+  // of the next band: both bands go out, one cell wide
+  int16_t y = 5 * FB_BAND_HEIGHT - FB_GLYPH_HEIGHT + 1;
+  frame->setCursor(200, y);
+  frame->setTextSize(1);
+  frame->setTextColor(COLOR_TEXT, COLOR_ACCENT);
+  frame->write('x');
+  reference->drawChar(200, y, 'x', COLOR_TEXT, COLOR_ACCENT, 1);
+
+  panel->resetCounters();
+  TEST_ASSERT_EQUAL(2, frame->flush());
+  TEST_ASSERT_EQUAL(FB_GLYPH_WIDTH * FB_BAND_HEIGHT * 2 * 2, panel->byteCount());
+  TEST_ASSERT_EQUAL(0, mismatchedPixels());
+}
+
+// A wrapping window over a 1-bit mask, as the marquee draws it
+void test_mask_window_wraps(void)
+{
+  // 12-wide mask, 2 bytes per row: alternating 3-column stripes
+  const int16_t maskWidth = 12;
+  const int16_t stride = 2;
+  uint8_t mask[4 * stride];
+  for (int row = 0; row < 4; row++) {
+    mask[row * stride] = 0xE3;      // 111000 11
+    mask[row * stride + 1] = 0x80;  // 1000
+  }
+
+  frame->fillScreen(COLOR_BG);
+  frame->drawMaskWindow(10, 20, 30, 4, mask, stride, maskWidth, 5, COLOR_TEXT, COLOR_HEADER);
+  frame->flush();
+
+  for (int row = 0; row < 4; row++) {
+    for (int i = 0; i < 30; i++) {
+      int col = (5 + i) % maskWidth;
+      bool lit = mask[row * stride + col / 8] & (0x80 >> (col % 8));
+      TEST_ASSERT_EQUAL_HEX16(lit ? COLOR_TEXT : COLOR_HEADER, panel->pixel(10 + i, 20 + row));
+    }
+  }
+
+  // Windows off the screen are skipped, not clipped
+  panel->resetCounters();
+  frame->drawMaskWindow(SCREEN_W - 10, 20, 30, 4, mask, stride, maskWidth, 0, COLOR_TEXT, COLOR_HEADER);
+  TEST_ASSERT_EQUAL(0, frame->flush());
+}
+
+// Without begin() every primitive goes straight to the panel and the
+// result is the same image
+void test_direct_mode_matches_reference(void)
+{
+  Adafruit_SPITFT directPanel(SCREEN_W, SCREEN_H);
+  FrameBuffer direct(directPanel, SCREEN_W, SCREEN_H);
+
+  drawListScreen(direct, 4);
+  drawTextEdges(direct);
+  drawListScreen(*reference, 4);
+  drawTextEdges(*reference);
+
+  TEST_ASSERT_FALSE(direct.active());
+  TEST_ASSERT_EQUAL(0, direct.flush());
+
+  int bad = 0;
+  for (int y = 0; y < SCREEN_H; y++) {
+    for (int x = 0; x < SCREEN_W; x++) {
+      bad += directPanel.pixel(x, y) != reference->pixels[y * SCREEN_W + x];
+    }
+  }
+  TEST_ASSERT_EQUAL(0, bad);
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_list_screen_matches_reference);
+  RUN_TEST(test_clipped_text_matches_reference);
+  RUN_TEST(test_every_glyph_matches_draw_char);
+  RUN_TEST(test_flush_sends_only_dirty_bands);
+  RUN_TEST(test_mask_window_wraps);
+  RUN_TEST(test_direct_mode_matches_reference);
+  return UNITY_END();
+}
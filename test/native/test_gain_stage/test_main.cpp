@@ -0,0 +1,264 @@
+// Q15 volume: dB curve, saturation and the per-frame volume ramp
+
+#include <unity.h>
+#include <vector>
+#include "../../../src/GainStage.cpp"
+
+// Collects whatever the stage writes on, one word per stereo frame
+class FrameSink : public Print {
+public:
+  std::vector<uint32_t> frames;
+
+  size_t write(uint8_t b) override { return 1; }
+
+  size_t write(const uint8_t* data, size_t len) override {
+    const uint32_t* words = (const uint32_t*)data;
+    frames.insert(frames.end(), words, words + len / 4);
+    return len;
+  }
+};
+
+static uint32_t frame(int16_t left, int16_t right)
+{
+  return (uint16_t)left | ((uint32_t)(uint16_t)right << 16);
+}
+
+static int16_t left(uint32_t f) { return (int16_t)(f & 0xFFFF); }
+static int16_t right(uint32_t f) { return (int16_t)(f >> 16); }
+
+// Push `count` copies of one frame through the stage, in odd-sized writes
+// so ramps straddle block boundaries
+static void feed(GainStage& stage, uint32_t f, uint32_t count)
+{
+  std::vector<uint32_t> pcm(count, f);
+  uint32_t done = 0;
+  while (done < count) {
+    uint32_t n = min(count - done, (uint32_t)333);
+    stage.write((const uint8_t*)&pcm[done], n * 4);
+    done += n;
+  }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ---------------------------------------------------------------------------
+// Gain curves
+// ---------------------------------------------------------------------------
+
+void test_volume_endpoints(void)
+{
+  TEST_ASSERT_EQUAL(0, volumeToGain(0));
+  TEST_ASSERT_EQUAL(0, volumeToGain(-5));
+  TEST_ASSERT_EQUAL(GAIN_UNITY, volumeToGain(100));
+  TEST_ASSERT_EQUAL(GAIN_UNITY, volumeToGain(150));
+
+  // 1% sits at the bottom of the dB range (-49.5 dB)
+  TEST_ASSERT_INT_WITHIN(1, 110, volumeToGain(1));
+
+  // 50% is -25 dB
+  TEST_ASSERT_INT_WITHIN(1, 1843, volumeToGain(50));
+}
+
+void test_volume_curve_is_monotonic(void)
+{
+  for (int percent = 1; percent <= 100; percent++) {
+    TEST_ASSERT_GREATER_THAN(volumeToGain(percent - 1), volumeToGain(percent));
+  }
+}
+
+void test_decibels_to_gain(void)
+{
+  TEST_ASSERT_EQUAL(GAIN_UNITY, decibelsToGain(0));
+  TEST_ASSERT_INT_WITHIN(2, 16423, decibelsToGain(-600));    // -6 dB
+  TEST_ASSERT_INT_WITHIN(2, 41252, decibelsToGain(200));     // +2 dB
+  TEST_ASSERT_EQUAL(GAIN_MAX, decibelsToGain(1000));         // +10 dB capped at 2x
+  TEST_ASSERT_EQUAL(1, decibelsToGain(-20000));              // Never fully mutes
+}
+
+// ---------------------------------------------------------------------------
+// Frame kernel
+// ---------------------------------------------------------------------------
+
+void test_unity_leaves_samples_alone(void)
+{
+  uint32_t frames[3] = { frame(32767, -32768), frame(1, -1), frame(-12345, 54) };
+  uint32_t copy[3];
+  memcpy(copy, frames, sizeof(frames));
+
+  applyGain(frames, 3, GAIN_UNITY);
+
+  TEST_ASSERT_EQUAL(0, memcmp(copy, frames, sizeof(frames)));
+}
+
+void test_gain_rounds_and_keeps_channels_apart(void)
+{
+  uint32_t frames[3] = { frame(1000, -1000), frame(3, -3), frame(0, 20001) };
+
+  applyGain(frames, 3, GAIN_UNITY / 2);
+
+  TEST_ASSERT_EQUAL(500, left(frames[0]));
+  TEST_ASSERT_EQUAL(-500, right(frames[0]));
+  TEST_ASSERT_EQUAL(2, left(frames[1]));     // 1.5 rounds up
+  TEST_ASSERT_EQUAL(-1, right(frames[1]));   // -1.5 rounds toward +inf
+  TEST_ASSERT_EQUAL(0, left(frames[2]));
+  TEST_ASSERT_EQUAL(10001, right(frames[2]));
+}
+
+// A 2x boost clips at the int16 rails instead of wrapping
+void test_boost_saturates(void)
+{
+  uint32_t frames[5] = {
+    frame(30000, -30000), frame(16384, -16384), frame(16383, -16385),
+    frame(-32768, 32767), frame(100, -100)
+  };
+
+  applyGain(frames, 5, GAIN_MAX);
+
+  TEST_ASSERT_EQUAL(32767, left(frames[0]));
+  TEST_ASSERT_EQUAL(-32768, right(frames[0]));
+  TEST_ASSERT_EQUAL(32767, left(frames[1]));
+  TEST_ASSERT_EQUAL(-32768, right(frames[1]));
+  TEST_ASSERT_EQUAL(32766, left(frames[2]));
+  TEST_ASSERT_EQUAL(-32768, right(frames[2]));
+  TEST_ASSERT_EQUAL(-32768, left(frames[3]));
+  TEST_ASSERT_EQUAL(32767, right(frames[3]));
+  TEST_ASSERT_EQUAL(200, left(frames[4]));    // Odd tail frame scaled too
+  TEST_ASSERT_EQUAL(-200, right(frames[4]));
+}
+
+void test_zero_gain_mutes(void)
+{
+  uint32_t frames[2] = { frame(32767, -32768), frame(-1, 1) };
+
+  applyGain(frames, 2, 0);
+
+  TEST_ASSERT_EQUAL(0, frames[0]);
+  TEST_ASSERT_EQUAL(0, frames[1]);
+}
+
+// ---------------------------------------------------------------------------
+// Ramp
+// ---------------------------------------------------------------------------
+
+// Volume down: every frame at or below the one before, small steps, and
+// exactly the target level from GAIN_RAMP_FRAMES on
+void test_ramp_down_is_monotonic_and_settles(void)
+{
+  FrameSink sink;
+  GainStage stage(sink);
+  const int16_t level = 20000;
+
+  feed(stage, frame(level, -level), 100);
+  TEST_ASSERT_EQUAL(level, left(sink.frames.back()));
+
+  stage.setVolume(50);
+  feed(stage, frame(level, -level), GAIN_RAMP_FRAMES + 500);
+
+  uint32_t expect = frame(level, -level);
+  applyGain(&expect, 1, volumeToGain(50));
+
+  int maxStep = 0;
+  for (size_t i = 101; i < sink.frames.size(); i++) {
+    int l = left(sink.frames[i]);
+    int prev = left(sink.frames[i - 1]);
+    TEST_ASSERT_LESS_OR_EQUAL(prev, l);
+    TEST_ASSERT_INT_WITHIN(1, -l, right(sink.frames[i]));
+    maxStep = max(maxStep, prev - l);
+  }
+
+  // 20000 -> 1125 over 1024 frames is ~18.4 per frame
+  TEST_ASSERT_LESS_OR_EQUAL(20, maxStep);
+
+  for (size_t i = 100 + GAIN_RAMP_FRAMES; i < sink.frames.size(); i++) {
+    TEST_ASSERT_EQUAL(expect, sink.frames[i]);
+  }
+  TEST_ASSERT_EQUAL(volumeToGain(50), stage.gain());
+}
+
+void test_ramp_up_is_monotonic_and_settles(void)
+{
+  FrameSink sink;
+  GainStage stage(sink);
+  const int16_t level = 8000;
+
+  stage.setVolume(0);
+  feed(stage, frame(level, level), GAIN_RAMP_FRAMES + 1);
+  TEST_ASSERT_EQUAL(0, sink.frames.back());
+
+  size_t start = sink.frames.size();
+  stage.setVolume(100);
+  feed(stage, frame(level, level), GAIN_RAMP_FRAMES * 2);
+
+  for (size_t i = start + 1; i < sink.frames.size(); i++) {
+    TEST_ASSERT_GREATER_OR_EQUAL(left(sink.frames[i - 1]), left(sink.frames[i]));
+  }
+  TEST_ASSERT_EQUAL(frame(level, level), sink.frames[start + GAIN_RAMP_FRAMES]);
+  TEST_ASSERT_EQUAL(frame(level, level), sink.frames.back());
+}
+
+// A new volume mid-ramp turns around from where the ramp is, no jump
+void test_retarget_mid_ramp_has_no_jump(void)
+{
+  FrameSink sink;
+  GainStage stage(sink);
+  const int16_t level = 30000;
+
+  feed(stage, frame(level, level), 10);
+  stage.setVolume(20);
+  feed(stage, frame(level, level), GAIN_RAMP_FRAMES / 2);
+  stage.setVolume(90);
+  feed(stage, frame(level, level), GAIN_RAMP_FRAMES * 2);
+
+  int maxStep = 0;
+  for (size_t i = 1; i < sink.frames.size(); i++) {
+    maxStep = max(maxStep, abs(left(sink.frames[i]) - left(sink.frames[i - 1])));
+  }
+  TEST_ASSERT_LESS_OR_EQUAL(30, maxStep);
+
+  uint32_t expect = frame(level, level);
+  applyGain(&expect, 1, volumeToGain(90));
+  TEST_ASSERT_EQUAL(expect, sink.frames.back());
+}
+
+// The track gain multiplies in at the next frame, without a ramp
+void test_track_gain_applies_at_next_frame(void)
+{
+  FrameSink sink;
+  GainStage stage(sink);
+  const int16_t level = 12000;
+
+  feed(stage, frame(level, level), 4);
+  stage.setTrackGain(GAIN_UNITY / 4);
+  feed(stage, frame(level, level), 4);
+  stage.setTrackGain(GAIN_UNITY * 4);   // Clamped to GAIN_MAX
+  feed(stage, frame(level, level), 4);
+
+  TEST_ASSERT_EQUAL(level, left(sink.frames[3]));
+  TEST_ASSERT_EQUAL(level / 4, left(sink.frames[4]));
+  TEST_ASSERT_EQUAL(level * 2, left(sink.frames[8]));
+  TEST_ASSERT_EQUAL(GAIN_MAX, stage.gain());
+}
+
+void test_benchmark(void)
+{
+  benchmarkGain();
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_volume_endpoints);
+  RUN_TEST(test_volume_curve_is_monotonic);
+  RUN_TEST(test_decibels_to_gain);
+  RUN_TEST(test_unity_leaves_samples_alone);
+  RUN_TEST(test_gain_rounds_and_keeps_channels_apart);
+  RUN_TEST(test_boost_saturates);
+  RUN_TEST(test_zero_gain_mutes);
+  RUN_TEST(test_ramp_down_is_monotonic_and_settles);
+  RUN_TEST(test_ramp_up_is_monotonic_and_settles);
+  RUN_TEST(test_retarget_mid_ramp_has_no_jump);
+  RUN_TEST(test_track_gain_applies_at_next_frame);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,304 @@
+// Replays recorded encoder ISR traces through the SPSC ring and
+// processInputEvents(), then applies the drained detents the way
+// updateEncoder() does (throttled, at most ENCODER_MAX_UPDATE_DETENTS per
+// update, accelerated by EncoderAccel) and checks the list index deltas
+// and that the list window keeps the cursor on screen.
+
+#include <unity.h>
+#include <vector>
+#include "../../../src/InputQueue.cpp"
+#include "../../../src/EncoderAccel.cpp"
+#include "UiSnapshot.h"
+
+// Mirrors the limits in EncoderModule.cpp
+static const uint32_t UPDATE_INTERVAL_MS = 90;
+static const int MAX_UPDATE_DETENTS = 12;
+
+// Length of the list the cursor scrolls through
+static const int LIST_ROWS = 2000;
+
+// ---------------------------------------------------------------------------
+// Handlers processInputEvents() dispatches to
+// ---------------------------------------------------------------------------
+
+static int pendingDetents;
+static uint32_t lastDetentTime;
+static std::vector<InputEvent> delivered;
+
+void queueEncoderDetents(int detents, uint32_t timeMs)
+{
+  pendingDetents += detents;
+  lastDetentTime = timeMs;
+
+  InputEvent event = { timeMs, INPUT_ENCODER, (int8_t)detents };
+  delivered.push_back(event);
+}
+
+void queueButtonEdge(int index, bool down, uint32_t timeMs)
+{
+  InputEvent event = { timeMs, down ? INPUT_BUTTON : INPUT_BUTTON_UP, (int8_t)index };
+  delivered.push_back(event);
+}
+
+// ---------------------------------------------------------------------------
+// Trace replay
+// ---------------------------------------------------------------------------
+
+// One ISR post: `detents` arrived `gapMs` after the previous entry
+struct TraceStep {
+  uint32_t gapMs;
+  int8_t detents;
+};
+
+static EncoderAccel accel;
+static int listIndex;
+static int detentsApplied;
+
+// Window the snapshot would show for the (clamped) cursor after each update
+static int windowStart;
+static int offScreenUpdates;
+static int furthestWindow;
+
+static void resetConsumer()
+{
+  InputEvent event;
+  while (inputQueue.pop(event)) {}
+
+  pendingDetents = 0;
+  lastDetentTime = 0;
+  delivered.clear();
+  encoderAccelReset(accel);
+  listIndex = 0;
+  detentsApplied = 0;
+  windowStart = 0;
+  offScreenUpdates = 0;
+  furthestWindow = 0;
+}
+
+// One throttled updateEncoder() pass over what is pending
+static void applyUpdate()
+{
+  if (pendingDetents == 0) {
+    return;
+  }
+
+  int delta = constrain(pendingDetents, -MAX_UPDATE_DETENTS, MAX_UPDATE_DETENTS);
+  pendingDetents -= delta;
+  detentsApplied += delta;
+
+  int step = delta > 0 ? 1 : -1;
+  listIndex += step * encoderAccelSteps(accel, lastDetentTime, abs(delta));
+
+  int cursor = constrain(listIndex, 0, LIST_ROWS - 1);
+  windowStart = listWindowStart(cursor, windowStart, LIST_ROWS, UI_LIST_ROWS);
+  int selectedRow = cursor - windowStart;
+  if (selectedRow < 0 || selectedRow >= UI_LIST_ROWS) {
+    offScreenUpdates++;
+  }
+  furthestWindow = max(furthestWindow, windowStart);
+}
+
+// Post the trace from the "ISR" while loop() drains and updates every
+// `loopMs`; a loop that is busy until `stallUntilMs` drains nothing
+static void replay(const TraceStep* trace, size_t count, uint32_t loopMs, uint32_t stallUntilMs)
+{
+  uint32_t nextLoop = millis() + loopMs;
+
+  for (size_t i = 0; i < count; i++) {
+    uint32_t postAt = millis() + trace[i].gapMs;
+
+    while (nextLoop <= postAt) {
+      setMillis(nextLoop);
+      if (nextLoop >= stallUntilMs) {
+        processInputEvents();
+        applyUpdate();
+      }
+      nextLoop += loopMs;
+    }
+
+    setMillis(postAt);
+    postInputEvent(INPUT_ENCODER, trace[i].detents);
+  }
+
+  // Let loop() catch up
+  for (int i = 0; i < 64 && (pendingDetents != 0 || !inputQueue.empty()); i++) {
+    advanceMillis(loopMs);
+    processInputEvents();
+    applyUpdate();
+  }
+}
+
+static int traceDetents(const TraceStep* trace, size_t count)
+{
+  int sum = 0;
+  for (size_t i = 0; i < count; i++) {
+    sum += trace[i].detents;
+  }
+  return sum;
+}
+
+void setUp(void) { resetConsumer(); }
+void tearDown(void) {}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+// Careful turn, one detent every ~350 ms: one row per detent
+void test_slow_turn_moves_one_row_per_detent(void)
+{
+  static const TraceStep trace[] = {
+    {1000, 1}, {340, 1}, {360, 1}, {350, 1}, {330, 1}, {370, 1}, {350, 1}, {345, 1}
+  };
+  const size_t n = sizeof(trace) / sizeof(trace[0]);
+
+  replay(trace, n, UPDATE_INTERVAL_MS, 0);
+
+  TEST_ASSERT_EQUAL(n, delivered.size());
+  TEST_ASSERT_EQUAL(8, detentsApplied);
+  TEST_ASSERT_EQUAL(8, listIndex);
+}
+
+// Events come out in the order and with the timestamps the ISR stamped
+void test_events_keep_order_and_timestamps(void)
+{
+  setMillis(5000);
+  postInputEvent(INPUT_ENCODER, 1);
+  advanceMillis(7);
+  postInputEvent(INPUT_BUTTON, 2);
+  advanceMillis(3);
+  postInputEvent(INPUT_ENCODER, -1);
+  advanceMillis(11);
+  postInputEvent(INPUT_BUTTON_UP, 2);
+
+  processInputEvents();
+
+  TEST_ASSERT_EQUAL(4, delivered.size());
+  TEST_ASSERT_EQUAL(INPUT_ENCODER, delivered[0].type);
+  TEST_ASSERT_EQUAL(1, delivered[0].value);
+  TEST_ASSERT_EQUAL(5000, delivered[0].timeMs);
+  TEST_ASSERT_EQUAL(INPUT_BUTTON, delivered[1].type);
+  TEST_ASSERT_EQUAL(2, delivered[1].value);
+  TEST_ASSERT_EQUAL(5007, delivered[1].timeMs);
+  TEST_ASSERT_EQUAL(INPUT_ENCODER, delivered[2].type);
+  TEST_ASSERT_EQUAL(-1, delivered[2].value);
+  TEST_ASSERT_EQUAL(5010, delivered[2].timeMs);
+  TEST_ASSERT_EQUAL(INPUT_BUTTON_UP, delivered[3].type);
+  TEST_ASSERT_EQUAL(2, delivered[3].value);
+  TEST_ASSERT_EQUAL(5021, delivered[3].timeMs);
+  TEST_ASSERT_TRUE(inputQueue.empty());
+}
+
+// A flick of 40 detents while loop() is stuck for 500 ms (a list build):
+// nothing is lost, the burst is applied 12 detents per update, and the
+// list moves at least one row per detent in the flick's direction
+void test_flick_during_stall_is_applied_in_full(void)
+{
+  setMillis(20000);
+
+  std::vector<TraceStep> trace;
+  trace.push_back(TraceStep{100, 1});
+  for (int i = 0; i < 39; i++) {
+    trace.push_back(TraceStep{6, 1});
+  }
+
+  replay(&trace[0], trace.size(), UPDATE_INTERVAL_MS, millis() + 500);
+
+  TEST_ASSERT_EQUAL(40, delivered.size());
+  TEST_ASSERT_EQUAL(0, inputQueue.dropped());
+  TEST_ASSERT_EQUAL(0, pendingDetents);
+  TEST_ASSERT_EQUAL(40, detentsApplied);
+  TEST_ASSERT_GREATER_OR_EQUAL(40, listIndex);
+}
+
+// Back and forth: index deltas net out with the detents
+void test_reversal_nets_out(void)
+{
+  setMillis(40000);
+
+  static const TraceStep trace[] = {
+    {500, 1}, {400, 1}, {400, 1}, {400, -1}, {400, -1}, {400, -1}, {400, -1}, {400, 1}
+  };
+  const size_t n = sizeof(trace) / sizeof(trace[0]);
+
+  replay(trace, n, UPDATE_INTERVAL_MS, 0);
+
+  TEST_ASSERT_EQUAL(traceDetents(trace, n), detentsApplied);
+  TEST_ASSERT_EQUAL(0, listIndex);
+}
+
+// Fast spin sustained across many updates accelerates past one row per
+// detent but never beyond ENCODER_ACCEL_MAX_STEP rows each
+void test_fast_spin_accelerates_within_cap(void)
+{
+  setMillis(60000);
+
+  std::vector<TraceStep> trace;
+  trace.push_back(TraceStep{500, 1});
+  for (int i = 0; i < 119; i++) {
+    trace.push_back(TraceStep{15, 1});   // ~66 detents/s
+  }
+
+  replay(&trace[0], trace.size(), UPDATE_INTERVAL_MS, 0);
+
+  TEST_ASSERT_EQUAL(120, detentsApplied);
+  TEST_ASSERT_GREATER_THAN(120, listIndex);
+  TEST_ASSERT_LESS_OR_EQUAL(120 * ENCODER_ACCEL_MAX_STEP, listIndex);
+}
+
+// A fast spin down and back up moves up to ENCODER_ACCEL_MAX_STEP rows per
+// detent; the window follows every update so the cursor is never hidden
+void test_accelerated_spin_keeps_cursor_on_screen(void)
+{
+  setMillis(70000);
+
+  std::vector<TraceStep> trace;
+  for (int i = 0; i < 150; i++) {
+    trace.push_back(TraceStep{(uint32_t)(i < 40 ? 25 : 12), 1});
+  }
+  trace.push_back(TraceStep{400, -1});
+  for (int i = 0; i < 150; i++) {
+    trace.push_back(TraceStep{(uint32_t)(i < 40 ? 25 : 12), -1});
+  }
+
+  replay(&trace[0], trace.size(), UPDATE_INTERVAL_MS, 0);
+
+  // Accelerated well past one row per detent, and all the way back
+  TEST_ASSERT_GREATER_THAN(300, furthestWindow);
+  TEST_ASSERT_EQUAL(traceDetents(&trace[0], trace.size()), detentsApplied);
+  TEST_ASSERT_LESS_OR_EQUAL(0, listIndex);
+  TEST_ASSERT_EQUAL(0, offScreenUpdates);
+}
+
+// A full ring refuses and counts the excess instead of overwriting
+void test_overflow_is_counted_not_overwritten(void)
+{
+  uint32_t droppedBefore = inputQueue.dropped();
+  setMillis(80000);
+
+  for (int i = 0; i < INPUT_QUEUE_SIZE + 9; i++) {
+    advanceMillis(1);
+    postInputEvent(INPUT_ENCODER, 1);
+  }
+
+  TEST_ASSERT_EQUAL(10, inputQueue.dropped() - droppedBefore);
+
+  processInputEvents();
+
+  TEST_ASSERT_EQUAL(INPUT_QUEUE_SIZE - 1, delivered.size());
+  TEST_ASSERT_EQUAL(80001, delivered.front().timeMs);
+  TEST_ASSERT_EQUAL(80000 + INPUT_QUEUE_SIZE - 1, delivered.back().timeMs);
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_slow_turn_moves_one_row_per_detent);
+  RUN_TEST(test_events_keep_order_and_timestamps);
+  RUN_TEST(test_flick_during_stall_is_applied_in_full);
+  RUN_TEST(test_reversal_nets_out);
+  RUN_TEST(test_fast_spin_accelerates_within_cap);
+  RUN_TEST(test_accelerated_spin_keeps_cursor_on_screen);
+  RUN_TEST(test_overflow_is_counted_not_overwritten);
+  return UNITY_END();
+}
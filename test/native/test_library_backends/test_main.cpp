@@ -0,0 +1,408 @@
+// music.db against music.lib on the host: the same synthetic library through
+// MusicDatabase (PSRAM copy, as on the device) and LibraryImage must list the
+// same rows, and the keyset walk benchmarkLibraryBackends() times on the
+// device is timed here for both.
+
+#include <unity.h>
+#include <map>
+
+#include "../../../src/SdVfs.cpp"
+#include "../../../src/Database.cpp"
+#include "../../../src/LibraryImage.cpp"
+#include "../library_fixture.h"
+
+SdFat32 sd;
+
+// The database buffer goes to sqlite3_deserialize(FREEONCLOSE) and the
+// host's sqlite3_free() only takes sqlite3_malloc() blocks; the image is
+// released with free()
+uint8_t* loadFileToPsram(const char* sdPath, size_t& fileSize, LoadProgressCallback progress)
+{
+  File32 file = sd.open(sdPath, O_RDONLY);
+  if (!file) {
+    return NULL;
+  }
+  fileSize = file.size();
+
+  size_t len = strlen(sdPath);
+  bool database = len > 3 && strcmp(sdPath + len - 3, ".db") == 0;
+  uint8_t* buffer = database ? (uint8_t*)sqlite3_malloc64(fileSize) : (uint8_t*)malloc(fileSize);
+
+  if (buffer && file.read(buffer, fileSize) != (int)fileSize) {
+    if (database) sqlite3_free(buffer); else free(buffer);
+    buffer = NULL;
+  }
+  file.close();
+  return buffer;
+}
+
+// ---------------------------------------------------------------------------
+// music.lib writer: a port of write_library_image() in music_indexer.py
+// ---------------------------------------------------------------------------
+
+static_assert(sizeof(LibraryImageHeader) == 48, "header layout differs from the indexer");
+static_assert(sizeof(ArtistRecord) == 16, "artist layout differs from the indexer");
+static_assert(sizeof(AlbumRecord) == 20, "album layout differs from the indexer");
+static_assert(sizeof(SongRecord) == 28, "song layout differs from the indexer");
+static_assert(sizeof(JumpRecord) == 8, "jump layout differs from the indexer");
+
+struct ImagePool {
+  std::string data;
+  std::map<std::string, uint32_t> offsets;
+
+  uint32_t add(const unsigned char* text) {
+    std::string s = text ? (const char*)text : "";
+    std::map<std::string, uint32_t>::iterator it = offsets.find(s);
+    if (it != offsets.end()) {
+      return it->second;
+    }
+    uint32_t offset = data.size();
+    offsets[s] = offset;
+    data.append(s.c_str(), s.size() + 1);
+    return offset;
+  }
+};
+
+static int16_t gainField(sqlite3_stmt* stmt, int col)
+{
+  if (sqlite3_column_type(stmt, col) == SQLITE_NULL) {
+    return 0;
+  }
+  long gain = lround(sqlite3_column_double(stmt, col) * 100);
+  return (int16_t)constrain(gain, -0x8000L, 0x7FFFL);
+}
+
+template <typename T>
+static void writeTable(FILE* f, const std::vector<T>& records)
+{
+  if (!records.empty()) {
+    fwrite(&records[0], sizeof(T), records.size(), f);
+  }
+}
+
+static bool writeFixtureImage(const char* dbPath, const char* imagePath)
+{
+  sqlite3* db;
+  if (sqlite3_open_v2(dbPath, &db, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK) {
+    return false;
+  }
+
+  sqlite3_stmt* artists;
+  sqlite3_stmt* albums;
+  sqlite3_stmt* songs;
+  sqlite3_prepare_v2(db, "SELECT id, name, display_name FROM artists ORDER BY name COLLATE NOCASE, id",
+                     -1, &artists, NULL);
+  sqlite3_prepare_v2(db, "SELECT id, name, display_name, ifnull(year, 0) FROM albums WHERE artist_id = ? "
+                     "ORDER BY ifnull(year, 0), name COLLATE NOCASE, id", -1, &albums, NULL);
+  sqlite3_prepare_v2(db, "SELECT title, display_name, path, ifnull(track_number, 0), ifnull(duration, 0), "
+                     "track_gain, album_gain FROM songs WHERE album_id = ? "
+                     "ORDER BY ifnull(track_number, 0), id", -1, &songs, NULL);
+
+  ImagePool pool;
+  std::vector<ArtistRecord> artistRecords;
+  std::vector<AlbumRecord> albumRecords;
+  std::vector<SongRecord> songRecords;
+  std::vector<JumpRecord> jumpRecords;
+
+  while (sqlite3_step(artists) == SQLITE_ROW) {
+    ArtistRecord artist = {};
+    artist.name = pool.add(sqlite3_column_text(artists, 1));
+    artist.displayName = pool.add(sqlite3_column_text(artists, 2));
+    artist.firstAlbum = albumRecords.size();
+
+    char first = toupper(sqlite3_column_text(artists, 1)[0]);
+    uint8_t letter = first >= 'A' && first <= 'Z' ? first : '#';
+    if (jumpRecords.empty() || jumpRecords.back().letter != letter) {
+      JumpRecord jump = {};
+      jump.row = artistRecords.size();
+      jump.letter = letter;
+      jumpRecords.push_back(jump);
+    }
+
+    sqlite3_bind_int(albums, 1, sqlite3_column_int(artists, 0));
+    while (sqlite3_step(albums) == SQLITE_ROW) {
+      AlbumRecord album = {};
+      album.name = pool.add(sqlite3_column_text(albums, 1));
+      album.displayName = pool.add(sqlite3_column_text(albums, 2));
+      album.artist = artistRecords.size();
+      album.firstSong = songRecords.size();
+      album.year = constrain(sqlite3_column_int(albums, 3), 0, 0xFFFF);
+
+      sqlite3_bind_int(songs, 1, sqlite3_column_int(albums, 0));
+      while (sqlite3_step(songs) == SQLITE_ROW) {
+        SongRecord song = {};
+        song.title = pool.add(sqlite3_column_text(songs, 0));
+        song.displayName = pool.add(sqlite3_column_text(songs, 1));
+        song.path = pool.add(sqlite3_column_text(songs, 2));
+        song.album = albumRecords.size();
+        song.track = constrain(sqlite3_column_int(songs, 3), 0, 0xFFFF);
+        song.duration = max(sqlite3_column_int(songs, 4), 0);
+        song.trackGain = gainField(songs, 5);
+        song.albumGain = gainField(songs, 6);
+        songRecords.push_back(song);
+        album.songCount++;
+      }
+      sqlite3_reset(songs);
+
+      albumRecords.push_back(album);
+      artist.albumCount++;
+    }
+    sqlite3_reset(albums);
+
+    artistRecords.push_back(artist);
+  }
+
+  sqlite3_finalize(artists);
+  sqlite3_finalize(albums);
+  sqlite3_finalize(songs);
+  sqlite3_close(db);
+
+  LibraryImageHeader header = {};
+  memcpy(header.magic, "RLIB", 4);
+  header.version = LIBRARY_IMAGE_VERSION;
+  header.headerSize = sizeof(header);
+  header.artistCount = artistRecords.size();
+  header.albumCount = albumRecords.size();
+  header.songCount = songRecords.size();
+  header.artistTable = sizeof(header);
+  header.albumTable = header.artistTable + header.artistCount * sizeof(ArtistRecord);
+  header.songTable = header.albumTable + header.albumCount * sizeof(AlbumRecord);
+  header.jumpTable = header.songTable + header.songCount * sizeof(SongRecord);
+  header.jumpCount = jumpRecords.size();
+  header.stringPool = header.jumpTable + header.jumpCount * sizeof(JumpRecord);
+  header.stringPoolSize = pool.data.size();
+
+  FILE* f = fopen(imagePath, "wb");
+  if (f == NULL) {
+    return false;
+  }
+  fwrite(&header, sizeof(header), 1, f);
+  writeTable(f, artistRecords);
+  writeTable(f, albumRecords);
+  writeTable(f, songRecords);
+  writeTable(f, jumpRecords);
+  fwrite(pool.data.data(), 1, pool.data.size(), f);
+  return fclose(f) == 0;
+}
+
+// ---------------------------------------------------------------------------
+// Walks
+// ---------------------------------------------------------------------------
+
+#define ARTIST_SAMPLE 32
+#define BENCH_ROUNDS 5
+
+static char dbPath[256];
+static char imagePath[256];
+static int librarySongs;
+
+static MusicDatabase database;
+static LibraryImage image;
+
+inline void hashText(uint64_t& hash, const char* text)
+{
+  for (; *text; text++) {
+    hash = (hash ^ (uint8_t)*text) * 1099511628211ULL;
+  }
+  hash = (hash ^ 0xff) * 1099511628211ULL;
+}
+
+inline void hashInt(uint64_t& hash, int value)
+{
+  hash = (hash ^ (uint32_t)value) * 1099511628211ULL;
+}
+
+// The device benchmark's access pattern: keyset-walk every artist, then
+// list the albums and songs of the first ARTIST_SAMPLE. Ids differ between
+// backends, so only what the lists show goes into the hash.
+template <typename Backend>
+static uint64_t walkLibrary(Backend& backend, int& rows)
+{
+  StringArena strings[2];
+  strings[0].begin(PAGE_ARENA_BYTES);
+  strings[1].begin(PAGE_ARENA_BYTES);
+
+  uint64_t hash = 1469598103934665603ULL;
+  rows = 0;
+
+  std::vector<Artist> artistPage;
+  std::vector<int> sampled;
+  int current = 0;
+
+  // Alternate arenas so the previous page's anchor stays readable
+  backend.fetchArtists(PAGE_AT_OFFSET, NULL, 0, PAGE_SIZE, strings[current], artistPage);
+  while (!artistPage.empty()) {
+    for (const Artist& artist : artistPage) {
+      hashText(hash, artist.name.c_str());
+      hashText(hash, artist.displayName.c_str());
+      if ((int)sampled.size() < ARTIST_SAMPLE) sampled.push_back(artist.id);
+      rows++;
+    }
+    Artist anchor = artistPage.back();
+    artistPage.clear();
+    current = 1 - current;
+    strings[current].reset();
+    backend.fetchArtists(PAGE_AFTER, &anchor, 0, PAGE_SIZE, strings[current], artistPage);
+  }
+
+  std::vector<Album> albumPage;
+  std::vector<Song> songPage;
+  for (int artistId : sampled) {
+    albumPage.clear();
+    strings[0].reset();
+    backend.fetchAlbums(artistId, PAGE_AT_OFFSET, NULL, 0, PAGE_SIZE, strings[0], albumPage);
+    for (const Album& album : albumPage) {
+      hashText(hash, album.name.c_str());
+      hashText(hash, album.displayName.c_str());
+      hashInt(hash, album.year);
+      rows++;
+
+      songPage.clear();
+      strings[1].reset();
+      backend.fetchSongs(album.id, PAGE_AT_OFFSET, NULL, 0, PAGE_SIZE, strings[1], songPage);
+      for (const Song& song : songPage) {
+        hashText(hash, song.title.c_str());
+        hashText(hash, song.displayName.c_str());
+        hashText(hash, song.path.c_str());
+        hashInt(hash, song.track);
+        hashInt(hash, song.duration);
+        hashInt(hash, song.gain.track);
+        hashInt(hash, song.gain.album);
+        rows++;
+      }
+    }
+  }
+  return hash;
+}
+
+// Best of BENCH_ROUNDS, in microseconds
+template <typename Backend>
+static unsigned long timeWalk(Backend& backend)
+{
+  unsigned long best = 0;
+  for (int round = 0; round < BENCH_ROUNDS; round++) {
+    int rows;
+    unsigned long start = micros();
+    walkLibrary(backend, rows);
+    unsigned long elapsed = micros() - start;
+    if (round == 0 || elapsed < best) {
+      best = elapsed;
+    }
+  }
+  return best;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_counts_match(void)
+{
+  TEST_ASSERT_EQUAL(librarySongs, database.getSongCount());
+  TEST_ASSERT_EQUAL(database.getSongCount(), image.getSongCount());
+  TEST_ASSERT_EQUAL(database.getArtistCount(), image.getArtistCount());
+  TEST_ASSERT_EQUAL(database.getAlbumCount(), image.getAlbumCount());
+
+  std::vector<LetterJump> dbJumps;
+  std::vector<LetterJump> imageJumps;
+  TEST_ASSERT_GREATER_THAN(1, database.fetchArtistJumps(dbJumps));
+  TEST_ASSERT_EQUAL(dbJumps.size(), image.fetchArtistJumps(imageJumps));
+  for (size_t i = 0; i < dbJumps.size(); i++) {
+    TEST_ASSERT_EQUAL(dbJumps[i].row, imageJumps[i].row);
+    TEST_ASSERT_EQUAL(dbJumps[i].letter, imageJumps[i].letter);
+  }
+}
+
+// Every row the walk visits reads the same through either backend
+void test_walks_list_the_same_rows(void)
+{
+  int dbRows;
+  int imageRows;
+  uint64_t dbHash = walkLibrary(database, dbRows);
+  uint64_t imageHash = walkLibrary(image, imageRows);
+
+  TEST_ASSERT_GREATER_THAN(database.getArtistCount(), dbRows);
+  TEST_ASSERT_EQUAL(dbRows, imageRows);
+  TEST_ASSERT_TRUE(dbHash == imageHash);
+}
+
+// Keyset paging in the middle of an album list agrees too
+void test_keyset_pages_agree(void)
+{
+  StringArena strings;
+  strings.begin(PAGE_ARENA_BYTES);
+
+  std::vector<Artist> artists[2];
+  database.fetchArtists(PAGE_AT_OFFSET, NULL, 0, PAGE_SIZE, strings, artists[0]);
+  image.fetchArtists(PAGE_AT_OFFSET, NULL, 0, PAGE_SIZE, strings, artists[1]);
+
+  for (size_t i = 0; i < artists[0].size(); i++) {
+    std::vector<Album> albums[2];
+    database.fetchAlbums(artists[0][i].id, PAGE_AT_OFFSET, NULL, 0, 64, strings, albums[0]);
+    image.fetchAlbums(artists[1][i].id, PAGE_AT_OFFSET, NULL, 0, 64, strings, albums[1]);
+    TEST_ASSERT_EQUAL(albums[0].size(), albums[1].size());
+    if (albums[0].size() < 3) {
+      continue;
+    }
+
+    std::vector<Album> after[2];
+    database.fetchAlbums(artists[0][i].id, PAGE_AFTER, &albums[0][0], 0, 64, strings, after[0]);
+    image.fetchAlbums(artists[1][i].id, PAGE_AFTER, &albums[1][0], 0, 64, strings, after[1]);
+    TEST_ASSERT_EQUAL(albums[0].size() - 1, after[0].size());
+    TEST_ASSERT_EQUAL(after[0].size(), after[1].size());
+
+    std::vector<Album> before[2];
+    database.fetchAlbums(artists[0][i].id, PAGE_BEFORE, &albums[0].back(), 0, 2, strings, before[0]);
+    image.fetchAlbums(artists[1][i].id, PAGE_BEFORE, &albums[1].back(), 0, 2, strings, before[1]);
+    TEST_ASSERT_EQUAL(2, before[0].size());
+    TEST_ASSERT_EQUAL(2, before[1].size());
+
+    for (size_t k = 0; k < after[0].size(); k++) {
+      TEST_ASSERT_TRUE(after[0][k].name == after[1][k].name.str());
+    }
+    for (size_t k = 0; k < 2; k++) {
+      TEST_ASSERT_TRUE(before[0][k].name == before[1][k].name.str());
+    }
+  }
+}
+
+void test_benchmark_walk(void)
+{
+  unsigned long sqliteMicros = timeWalk(database);
+  unsigned long imageMicros = timeWalk(image);
+
+  Serial.printf("⏱️ Library walk (%d artists, albums+songs of first %d), best of %d:\n",
+                database.getArtistCount(), ARTIST_SAMPLE, BENCH_ROUNDS);
+  Serial.printf("   SQLite: %lu us\n", sqliteMicros);
+  Serial.printf("   Image:  %lu us (%.1fx)\n", imageMicros,
+                imageMicros ? (double)sqliteMicros / imageMicros : 0.0);
+
+  TEST_ASSERT_GREATER_THAN(0, sqliteMicros);
+}
+
+int main(int argc, char** argv)
+{
+  snprintf(dbPath, sizeof(dbPath), "%s/backends_music.db", P_tmpdir);
+  snprintf(imagePath, sizeof(imagePath), "%s/backends_music.lib", P_tmpdir);
+
+  FixtureShape shape = { 1000, 6, 12 };
+  librarySongs = writeFixtureLibrary(dbPath, shape);
+  if (librarySongs <= 0 || !writeFixtureImage(dbPath, imagePath)) {
+    return 1;
+  }
+  if (!database.openFromMemory(dbPath) || !image.load(imagePath)) {
+    return 1;
+  }
+
+  UNITY_BEGIN();
+  RUN_TEST(test_counts_match);
+  RUN_TEST(test_walks_list_the_same_rows);
+  RUN_TEST(test_keyset_pages_agree);
+  RUN_TEST(test_benchmark_walk);
+  int failures = UNITY_END();
+
+  database.close();
+  image.close();
+  remove(dbPath);
+  remove(imagePath);
+  return failures;
+}
@@ -0,0 +1,135 @@
+// listWindowStart(): the selection stays inside the visible window for
+// steps of any size, and the window only moves when it has to
+
+#include <unity.h>
+#include "UiSnapshot.h"
+
+#define LIST_SIZE 500
+
+static int windowStart;
+
+// Move to `index` and check the selected row is on screen
+static bool moveTo(int index, int listSize, int rows)
+{
+  windowStart = listWindowStart(index, windowStart, listSize, rows);
+  int selectedRow = index - windowStart;
+  return selectedRow >= 0 && selectedRow < rows &&
+         windowStart >= 0 && windowStart + rows <= max(listSize, rows);
+}
+
+void setUp(void)
+{
+  windowStart = 0;
+}
+
+void tearDown(void) {}
+
+void test_single_steps_scroll_at_the_edges(void)
+{
+  int index = 0;
+  for (; index < UI_LIST_ROWS; index++) {
+    TEST_ASSERT_TRUE(moveTo(index, LIST_SIZE, UI_LIST_ROWS));
+    TEST_ASSERT_EQUAL(0, windowStart);
+  }
+
+  // Past the bottom row the window follows one row at a time
+  TEST_ASSERT_TRUE(moveTo(index, LIST_SIZE, UI_LIST_ROWS));
+  TEST_ASSERT_EQUAL(1, windowStart);
+
+  // Back up inside the window: it stays put until the top row
+  for (int i = 0; i < UI_LIST_ROWS - 1; i++) {
+    TEST_ASSERT_TRUE(moveTo(--index, LIST_SIZE, UI_LIST_ROWS));
+    TEST_ASSERT_EQUAL(1, windowStart);
+  }
+  TEST_ASSERT_TRUE(moveTo(--index, LIST_SIZE, UI_LIST_ROWS));
+  TEST_ASSERT_EQUAL(0, windowStart);
+
+  for (index = 0; index < LIST_SIZE; index++) {
+    TEST_ASSERT_TRUE(moveTo(index, LIST_SIZE, UI_LIST_ROWS));
+  }
+  for (index = LIST_SIZE - 1; index >= 0; index--) {
+    TEST_ASSERT_TRUE(moveTo(index, LIST_SIZE, UI_LIST_ROWS));
+  }
+}
+
+// Accelerated spins move 10 rows per detent; the selection lands on the
+// bottom row going down and the top row coming back
+void test_steps_of_ten(void)
+{
+  TEST_ASSERT_TRUE(moveTo(12, LIST_SIZE, UI_LIST_ROWS));
+  TEST_ASSERT_EQUAL(12 - UI_LIST_ROWS + 1, windowStart);
+
+  int index = 12;
+  for (; index + 10 < LIST_SIZE; index += 10) {
+    TEST_ASSERT_TRUE(moveTo(index, LIST_SIZE, UI_LIST_ROWS));
+  }
+  for (; index >= 10; index -= 10) {
+    TEST_ASSERT_TRUE(moveTo(index, LIST_SIZE, UI_LIST_ROWS));
+  }
+  TEST_ASSERT_TRUE(moveTo(index - 1, LIST_SIZE, UI_LIST_ROWS));
+  TEST_ASSERT_EQUAL(index - 1, windowStart);
+
+  // Single steps after a big one keep working
+  TEST_ASSERT_TRUE(moveTo(index, LIST_SIZE, UI_LIST_ROWS));
+  TEST_ASSERT_TRUE(moveTo(index + 1, LIST_SIZE, UI_LIST_ROWS));
+}
+
+// Letter jumps and search locate() land anywhere, including both ends
+void test_jumps(void)
+{
+  const int targets[] = { 0, 437, 3, LIST_SIZE - 1, 250, 251, 249, 0, LIST_SIZE - 2, 1 };
+
+  for (size_t i = 0; i < sizeof(targets) / sizeof(targets[0]); i++) {
+    TEST_ASSERT_TRUE(moveTo(targets[i], LIST_SIZE, UI_LIST_ROWS));
+  }
+
+  // A jump to the last row clamps the window to the end of the list
+  moveTo(LIST_SIZE - 1, LIST_SIZE, UI_LIST_ROWS);
+  TEST_ASSERT_EQUAL(LIST_SIZE - UI_LIST_ROWS, windowStart);
+}
+
+// Search results use a window one row shorter; short lists never scroll
+void test_short_windows_and_lists(void)
+{
+  for (int index = 0; index < 40; index += 7) {
+    TEST_ASSERT_TRUE(moveTo(index, 40, UI_LIST_ROWS - 1));
+  }
+
+  windowStart = 0;
+  for (int index = 0; index < 3; index++) {
+    TEST_ASSERT_TRUE(moveTo(index, 3, UI_LIST_ROWS));
+    TEST_ASSERT_EQUAL(0, windowStart);
+  }
+
+  // A list that shrank under a stale window pulls the window back
+  windowStart = 300;
+  TEST_ASSERT_TRUE(moveTo(20, 24, UI_LIST_ROWS));
+  TEST_ASSERT_EQUAL(24 - UI_LIST_ROWS, windowStart);
+}
+
+// Random walk mixing every step size
+void test_random_steps(void)
+{
+  uint32_t seed = 99;
+  int index = 0;
+
+  for (int i = 0; i < 100000; i++) {
+    seed = seed * 1664525u + 1013904223u;
+    int r = (seed >> 8) % 100;
+    int step = r < 60 ? 1 : r < 90 ? 10 : (int)((seed >> 12) % LIST_SIZE);
+    index += (seed & 0x100) ? step : -step;
+    index = constrain(index, 0, LIST_SIZE - 1);
+    TEST_ASSERT_TRUE(moveTo(index, LIST_SIZE, UI_LIST_ROWS));
+  }
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_single_steps_scroll_at_the_edges);
+  RUN_TEST(test_steps_of_ten);
+  RUN_TEST(test_jumps);
+  RUN_TEST(test_short_windows_and_lists);
+  RUN_TEST(test_random_steps);
+  return UNITY_END();
+}
@@ -0,0 +1,266 @@
+// PagedList/StringArena stress: scroll, page and jump across a large
+// synthetic song list and check every row, that the string arenas stay
+// bounded through compactions, and that paging never touches the heap.
+
+#include <unity.h>
+#include <new>
+#include "State.h"
+
+#define LIST_ROWS 5000
+#define STRESS_STEPS 200000
+
+// Longest strings one synthetic row can have, NULs included
+#define MAX_ROW_BYTES (48 + 24 + 96)
+
+// ---------------------------------------------------------------------------
+// Heap accounting
+// ---------------------------------------------------------------------------
+
+static bool countAllocations = false;
+static unsigned long allocations = 0;
+
+void* operator new(size_t size)
+{
+  if (countAllocations) {
+    allocations++;
+  }
+  void* p = malloc(size ? size : 1);
+  if (p == NULL) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// ---------------------------------------------------------------------------
+// Synthetic source: row i has id 3i + 7 and strings derived from i, of
+// varying length so pages fill the arenas unevenly
+// ---------------------------------------------------------------------------
+
+static int rowId(int index) { return 3 * index + 7; }
+static int rowIndex(int id) { return (id - 7) / 3; }
+
+static int titleFor(int index, char* buf)
+{
+  int pad = (index * 7919) % 30;
+  return snprintf(buf, 48, "Title %d %.*s", index, pad, "..............................");
+}
+
+static int labelFor(int index, char* buf)
+{
+  return snprintf(buf, 24, "%d. Label", index % 97);
+}
+
+static int pathFor(int index, char* buf)
+{
+  int pad = (index * 104729) % 50;
+  return snprintf(buf, 96, "/Music/Artist %d/Album %d/%.*s%d.mp3", index / 200, index / 12,
+                  pad, "abcdefghijabcdefghijabcdefghijabcdefghijabcdefghij", index);
+}
+
+// Arena bookkeeping seen from the source side
+static const StringArena* lastArena = NULL;
+static unsigned long compactions = 0;
+static size_t maxCompactedBytes = 0;
+static size_t maxArenaBytes = 0;
+static unsigned long fetches = 0;
+
+int PageSource<Song>::count(int albumId)
+{
+  return LIST_ROWS;
+}
+
+int PageSource<Song>::fetch(int albumId, PageDirection dir, const Song* anchor,
+                            int offset, int limit, StringArena& strings, std::vector<Song>& out)
+{
+  fetches++;
+
+  // A switch to an arena that already holds strings is a compaction: it
+  // should hold the live window and nothing else
+  if (&strings != lastArena && strings.bytesUsed() > 0) {
+    compactions++;
+    maxCompactedBytes = max(maxCompactedBytes, strings.bytesUsed());
+  }
+  lastArena = &strings;
+
+  int first;
+  int last;
+  if (dir == PAGE_AFTER) {
+    first = rowIndex(anchor->id) + 1;
+    last = min(first + limit, LIST_ROWS);
+  } else if (dir == PAGE_BEFORE) {
+    last = rowIndex(anchor->id);
+    first = max(last - limit, 0);
+  } else {
+    first = offset;
+    last = min(first + limit, LIST_ROWS);
+  }
+
+  char buf[96];
+  for (int i = first; i < last; i++) {
+    Song song;
+    song.id = rowId(i);
+    song.albumId = albumId;
+    song.track = i % 20 + 1;
+
+    int n = titleFor(i, buf);
+    song.title = strings.copy(buf, n);
+    n = labelFor(i, buf);
+    song.displayName = strings.copy(buf, n);
+    n = pathFor(i, buf);
+    song.path = strings.copy(buf, n);
+
+    out.push_back(song);
+  }
+
+  maxArenaBytes = max(maxArenaBytes, strings.bytesUsed());
+  return last - first;
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+static PagedList<Song> list;
+
+static bool rowMatches(int index, const Song& song)
+{
+  char buf[96];
+
+  if (song.id != rowId(index) || song.track != index % 20 + 1) {
+    return false;
+  }
+  int n = titleFor(index, buf);
+  if (song.title.length() != (size_t)n || strcmp(song.title.c_str(), buf) != 0) {
+    return false;
+  }
+  n = labelFor(index, buf);
+  if (song.displayName.length() != (size_t)n || strcmp(song.displayName.c_str(), buf) != 0) {
+    return false;
+  }
+  n = pathFor(index, buf);
+  return song.path.length() == (size_t)n && strcmp(song.path.c_str(), buf) == 0;
+}
+
+// Deterministic LCG so a failure replays
+static uint32_t seed = 12345;
+static uint32_t nextRandom()
+{
+  seed = seed * 1664525u + 1013904223u;
+  return seed >> 8;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_every_row_in_order(void)
+{
+  TEST_ASSERT_EQUAL(LIST_ROWS, list.reset(42));
+
+  Song song;
+  for (int i = 0; i < LIST_ROWS; i++) {
+    TEST_ASSERT_TRUE(list.get(i, song));
+    TEST_ASSERT_TRUE_MESSAGE(rowMatches(i, song), "row mismatch scrolling down");
+  }
+  for (int i = LIST_ROWS - 1; i >= 0; i--) {
+    TEST_ASSERT_TRUE(list.get(i, song));
+    TEST_ASSERT_TRUE_MESSAGE(rowMatches(i, song), "row mismatch scrolling up");
+  }
+
+  TEST_ASSERT_FALSE(list.get(-1, song));
+  TEST_ASSERT_FALSE(list.get(LIST_ROWS, song));
+}
+
+// Scroll runs both ways, page-sized hops and random jumps. Every row read
+// must be intact, the arenas must compact rather than grow, and none of it
+// may allocate.
+void test_stress_paging_stays_bounded(void)
+{
+  list.reset(42);
+  compactions = 0;
+  maxCompactedBytes = 0;
+  maxArenaBytes = 0;
+  fetches = 0;
+
+  Song song;
+  int index = 0;
+  int direction = 1;
+  int run = 0;
+  unsigned long bad = 0;
+
+  // Warm the window once so its buffers are in place
+  list.get(0, song);
+
+  countAllocations = true;
+  for (int s = 0; s < STRESS_STEPS; s++) {
+    uint32_t r = nextRandom() % 100;
+
+    if (run == 0) {
+      direction = (nextRandom() & 1) ? 1 : -1;
+      run = nextRandom() % 200 + 1;
+    }
+
+    if (r < 80) {
+      index += direction;
+      run--;
+    } else if (r < 95) {
+      index += direction * (int)(PAGE_SIZE + nextRandom() % 8);
+    } else {
+      index = nextRandom() % LIST_ROWS;
+    }
+
+    if (index < 0) {
+      index = 0;
+      direction = 1;
+    } else if (index >= LIST_ROWS) {
+      index = LIST_ROWS - 1;
+      direction = -1;
+    }
+
+    // The row and its neighbours; a row left pointing into a recycled
+    // arena shows up as wrong text
+    for (int i = max(index - 4, 0); i <= min(index + 4, LIST_ROWS - 1); i++) {
+      if (!list.get(i, song) || !rowMatches(i, song)) {
+        bad++;
+      }
+    }
+  }
+  countAllocations = false;
+
+  Serial.printf("📄 %d steps: %lu fetches, %lu compactions, arena peak %u bytes, after compaction %u\n",
+                STRESS_STEPS, fetches, compactions, (unsigned)maxArenaBytes, (unsigned)maxCompactedBytes);
+
+  TEST_ASSERT_EQUAL(0, bad);
+  TEST_ASSERT_EQUAL(0, allocations);
+  TEST_ASSERT_GREATER_THAN(100, compactions);
+
+  // A compacted arena holds the live window only; dead strings are gone
+  TEST_ASSERT_LESS_OR_EQUAL(PAGE_WINDOW_ROWS * MAX_ROW_BYTES, maxCompactedBytes);
+  TEST_ASSERT_LESS_OR_EQUAL(PAGE_ARENA_BYTES, maxArenaBytes);
+}
+
+// Reopening the list for another parent starts the arenas over
+void test_reset_drops_window(void)
+{
+  Song song;
+
+  list.reset(7);
+  TEST_ASSERT_TRUE(list.get(LIST_ROWS / 2, song));
+  TEST_ASSERT_TRUE(rowMatches(LIST_ROWS / 2, song));
+  TEST_ASSERT_EQUAL(7, list.parent());
+
+  list.clear();
+  TEST_ASSERT_EQUAL(0, list.size());
+  TEST_ASSERT_FALSE(list.get(0, song));
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_every_row_in_order);
+  RUN_TEST(test_stress_paging_stays_bounded);
+  RUN_TEST(test_reset_drops_window);
+  return UNITY_END();
+}
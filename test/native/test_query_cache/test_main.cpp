@@ -0,0 +1,268 @@
+// Cached statements on the host: the page queries MusicDatabase keeps
+// prepared against the same SQL prepared with sqlite3_prepare_v2 on every
+// call, as before the cache. Both run on a PSRAM-style copy of the same
+// synthetic library, must list the same rows, and are timed per call.
+
+#include <unity.h>
+
+#include "../../../src/SdVfs.cpp"
+#include "../../../src/Database.cpp"
+#include "../library_fixture.h"
+
+#define ARTIST_SAMPLE 200  // Artists whose albums and songs are listed
+#define BENCH_ROUNDS 5
+
+SdFat32 sd;
+
+// openFromMemory() hands the buffer to sqlite3_deserialize(FREEONCLOSE),
+// and the host's sqlite3_free() only takes sqlite3_malloc() blocks
+uint8_t* loadFileToPsram(const char* sdPath, size_t& fileSize, LoadProgressCallback progress)
+{
+  File32 file = sd.open(sdPath, O_RDONLY);
+  if (!file) {
+    return NULL;
+  }
+  fileSize = file.size();
+  uint8_t* buffer = (uint8_t*)sqlite3_malloc64(fileSize);
+  if (buffer && file.read(buffer, fileSize) != (int)fileSize) {
+    sqlite3_free(buffer);
+    buffer = NULL;
+  }
+  file.close();
+  return buffer;
+}
+
+// The same QUERY_SQL on its own copy of the library, prepared, stepped and
+// finalized on every call. Rows are copied out the way MusicDatabase does.
+struct ReprepareDatabase {
+  sqlite3* db;
+
+  ReprepareDatabase() : db(NULL) {}
+
+  bool open(const char* path) {
+    size_t size = 0;
+    uint8_t* buffer = loadFileToPsram(path, size, NULL);
+    if (!buffer || sqlite3_open(":memory:", &db) != SQLITE_OK) {
+      sqlite3_free(buffer);
+      return false;
+    }
+    if (sqlite3_deserialize(db, "main", buffer, size, size,
+                            SQLITE_DESERIALIZE_FREEONCLOSE | SQLITE_DESERIALIZE_RESIZEABLE) != SQLITE_OK) {
+      return false;
+    }
+    sqlite3_exec(db, "PRAGMA temp_store = MEMORY", NULL, NULL, NULL);
+    return true;
+  }
+
+  void close() {
+    sqlite3_close(db);
+    db = NULL;
+  }
+
+  sqlite3_stmt* prepare(QueryId id) {
+    sqlite3_stmt* stmt = NULL;
+    sqlite3_prepare_v2(db, QUERY_SQL[id], -1, &stmt, NULL);
+    return stmt;
+  }
+
+  int fetchArtists(PageDirection, const Artist*, int offset, int limit, StringArena& strings,
+                   std::vector<Artist>& out) {
+    sqlite3_stmt* stmt = prepare(QUERY_ARTISTS_AT);
+    size_t firstRow = out.size();
+    sqlite3_bind_int(stmt, 1, limit);
+    sqlite3_bind_int(stmt, 2, offset);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+      Artist artist;
+      artist.id = sqlite3_column_int(stmt, 0);
+      artist.name = strings.copy(columnText(stmt, 1));
+      artist.displayName = strings.copy(columnText(stmt, 2));
+      out.push_back(artist);
+    }
+    sqlite3_finalize(stmt);
+    return out.size() - firstRow;
+  }
+
+  int fetchAlbums(int artistId, PageDirection, const Album*, int offset, int limit, StringArena& strings,
+                  std::vector<Album>& out) {
+    sqlite3_stmt* stmt = prepare(QUERY_ALBUMS_AT);
+    size_t firstRow = out.size();
+    sqlite3_bind_int(stmt, 1, artistId);
+    sqlite3_bind_int(stmt, 2, limit);
+    sqlite3_bind_int(stmt, 3, offset);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+      Album album;
+      album.id = sqlite3_column_int(stmt, 0);
+      album.artistId = sqlite3_column_int(stmt, 1);
+      album.name = strings.copy(columnText(stmt, 2));
+      album.year = sqlite3_column_int(stmt, 3);
+      album.displayName = strings.copy(columnText(stmt, 4));
+      out.push_back(album);
+    }
+    sqlite3_finalize(stmt);
+    return out.size() - firstRow;
+  }
+
+  int fetchSongs(int albumId, PageDirection, const Song*, int offset, int limit, StringArena& strings,
+                 std::vector<Song>& out) {
+    sqlite3_stmt* stmt = prepare(QUERY_SONGS_AT);
+    size_t firstRow = out.size();
+    sqlite3_bind_int(stmt, 1, albumId);
+    sqlite3_bind_int(stmt, 2, limit);
+    sqlite3_bind_int(stmt, 3, offset);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+      Song song;
+      song.id = sqlite3_column_int(stmt, 0);
+      song.albumId = sqlite3_column_int(stmt, 1);
+      song.title = strings.copy(columnText(stmt, 2));
+      song.path = strings.copy(columnText(stmt, 3));
+      song.track = sqlite3_column_int(stmt, 4);
+      song.duration = sqlite3_column_int(stmt, 5);
+      song.displayName = strings.copy(columnText(stmt, 6));
+      song.gain.track = lround(sqlite3_column_double(stmt, 7) * 100);
+      song.gain.album = lround(sqlite3_column_double(stmt, 8) * 100);
+      out.push_back(song);
+    }
+    sqlite3_finalize(stmt);
+    return out.size() - firstRow;
+  }
+};
+
+static char dbPath[256];
+static MusicDatabase cached;
+static ReprepareDatabase reprepared;
+
+inline void hashText(uint64_t& hash, const char* text)
+{
+  for (; *text; text++) {
+    hash = (hash ^ (uint8_t)*text) * 1099511628211ULL;
+  }
+  hash = (hash ^ 0xff) * 1099511628211ULL;
+}
+
+inline void hashInt(uint64_t& hash, int value)
+{
+  hash = (hash ^ (uint32_t)value) * 1099511628211ULL;
+}
+
+// What the lists do while browsing: every artist page by offset, then the
+// albums and songs of the first ARTIST_SAMPLE artists, one page per query
+template <typename Database>
+static uint64_t listLibrary(Database& db, int artistCount, int& queries)
+{
+  StringArena strings;
+  strings.begin(PAGE_ARENA_BYTES);
+
+  uint64_t hash = 1469598103934665603ULL;
+  queries = 0;
+
+  std::vector<int> sampled;
+  std::vector<Artist> artistPage;
+  for (int offset = 0; offset < artistCount; offset += PAGE_SIZE) {
+    artistPage.clear();
+    strings.reset();
+    db.fetchArtists(PAGE_AT_OFFSET, NULL, offset, PAGE_SIZE, strings, artistPage);
+    queries++;
+    for (const Artist& artist : artistPage) {
+      hashInt(hash, artist.id);
+      hashText(hash, artist.displayName.c_str());
+      if ((int)sampled.size() < ARTIST_SAMPLE) {
+        sampled.push_back(artist.id);
+      }
+    }
+  }
+
+  std::vector<Album> albumPage;
+  std::vector<Song> songPage;
+  for (int artistId : sampled) {
+    albumPage.clear();
+    strings.reset();
+    db.fetchAlbums(artistId, PAGE_AT_OFFSET, NULL, 0, PAGE_SIZE, strings, albumPage);
+    queries++;
+    for (const Album& album : albumPage) {
+      hashInt(hash, album.id);
+      hashText(hash, album.displayName.c_str());
+
+      songPage.clear();
+      db.fetchSongs(album.id, PAGE_AT_OFFSET, NULL, 0, PAGE_SIZE, strings, songPage);
+      queries++;
+      for (const Song& song : songPage) {
+        hashInt(hash, song.id);
+        hashText(hash, song.path.c_str());
+        hashInt(hash, song.gain.track);
+      }
+    }
+  }
+  return hash;
+}
+
+// Best of BENCH_ROUNDS, in microseconds
+template <typename Database>
+static unsigned long timeListing(Database& db, int artistCount, int& queries)
+{
+  unsigned long best = 0;
+  for (int round = 0; round < BENCH_ROUNDS; round++) {
+    unsigned long start = micros();
+    listLibrary(db, artistCount, queries);
+    unsigned long elapsed = micros() - start;
+    if (round == 0 || elapsed < best) {
+      best = elapsed;
+    }
+  }
+  return best;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Same SQL, same rows: the comparison below is only about preparing
+void test_both_list_the_same_rows(void)
+{
+  int cachedQueries;
+  int repreparedQueries;
+  uint64_t cachedHash = listLibrary(cached, cached.getArtistCount(), cachedQueries);
+  uint64_t repreparedHash = listLibrary(reprepared, cached.getArtistCount(), repreparedQueries);
+
+  TEST_ASSERT_GREATER_THAN(ARTIST_SAMPLE, cachedQueries);
+  TEST_ASSERT_EQUAL(cachedQueries, repreparedQueries);
+  TEST_ASSERT_TRUE(cachedHash == repreparedHash);
+}
+
+void test_benchmark_prepare(void)
+{
+  int artistCount = cached.getArtistCount();
+  int queries;
+  unsigned long repreparedMicros = timeListing(reprepared, artistCount, queries);
+  unsigned long cachedMicros = timeListing(cached, artistCount, queries);
+
+  Serial.printf("⏱️ Page queries (%d per listing), best of %d:\n", queries, BENCH_ROUNDS);
+  Serial.printf("   prepare_v2 each call: %lu us (%.2f us/query)\n", repreparedMicros,
+                (double)repreparedMicros / queries);
+  Serial.printf("   cached statements:    %lu us (%.2f us/query, %.1fx)\n", cachedMicros,
+                (double)cachedMicros / queries,
+                cachedMicros ? (double)repreparedMicros / cachedMicros : 0.0);
+
+  TEST_ASSERT_GREATER_THAN(0, cachedMicros);
+}
+
+int main(int argc, char** argv)
+{
+  snprintf(dbPath, sizeof(dbPath), "%s/query_cache_music.db", P_tmpdir);
+
+  FixtureShape shape = { 1000, 6, 12 };
+  if (writeFixtureLibrary(dbPath, shape) <= 0) {
+    return 1;
+  }
+  if (!cached.openFromMemory(dbPath) || !reprepared.open(dbPath)) {
+    return 1;
+  }
+
+  UNITY_BEGIN();
+  RUN_TEST(test_both_list_the_same_rows);
+  RUN_TEST(test_benchmark_prepare);
+  int failures = UNITY_END();
+
+  cached.close();
+  reprepared.close();
+  remove(dbPath);
+  return failures;
+}
@@ -0,0 +1,319 @@
+// SD VFS on its stdio backing: page cache behaviour, read-only rules, and
+// MusicDatabase::openFromSd() over a synthetic library bigger than the
+// cache. The cache is shrunk to 128 KB so the library has to page.
+
+#include <unity.h>
+
+#define SD_VFS_CACHE_PAGES 32
+
+#include "../../../src/SdVfs.cpp"
+#include "../../../src/Database.cpp"
+#include "../library_fixture.h"
+
+SdFat32 sd;
+
+// openFromMemory() hands the buffer to sqlite3_deserialize(FREEONCLOSE),
+// and the host's sqlite3_free() only takes sqlite3_malloc() blocks
+uint8_t* loadFileToPsram(const char* sdPath, size_t& fileSize, LoadProgressCallback progress)
+{
+  File32 file = sd.open(sdPath, O_RDONLY);
+  if (!file) {
+    return NULL;
+  }
+  fileSize = file.size();
+  uint8_t* buffer = (uint8_t*)sqlite3_malloc64(fileSize);
+  if (buffer && file.read(buffer, fileSize) != (int)fileSize) {
+    sqlite3_free(buffer);
+    buffer = NULL;
+  }
+  file.close();
+  return buffer;
+}
+
+static char libraryPath[256];
+static int librarySongs;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static sqlite3* openThroughVfs()
+{
+  sqlite3* db = NULL;
+  if (!sdVfsRegister()) {
+    return NULL;
+  }
+  int rc = sqlite3_open_v2(libraryPath, &db, SQLITE_OPEN_READONLY, SD_VFS_NAME);
+  if (rc != SQLITE_OK) {
+    sqlite3_close(db);
+    return NULL;
+  }
+  return db;
+}
+
+// Row-order hash of every song, read through whichever VFS `db` uses
+static uint64_t hashSongs(sqlite3* db, int& rows)
+{
+  sqlite3_stmt* stmt;
+  rows = 0;
+  if (sqlite3_prepare_v2(db, "SELECT id, title, path, duration FROM songs ORDER BY id", -1, &stmt, NULL) != SQLITE_OK) {
+    return 0;
+  }
+
+  uint64_t hash = 1469598103934665603ULL;
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    for (int col = 0; col < 4; col++) {
+      const unsigned char* text = sqlite3_column_text(stmt, col);
+      for (; *text; text++) {
+        hash = (hash ^ *text) * 1099511628211ULL;
+      }
+    }
+    rows++;
+  }
+  sqlite3_finalize(stmt);
+  return hash;
+}
+
+// ---------------------------------------------------------------------------
+// VFS
+// ---------------------------------------------------------------------------
+
+// Every byte read through the page cache matches the default VFS, and a
+// library bigger than the cache evicts
+void test_reads_match_default_vfs(void)
+{
+  sqlite3* plain;
+  TEST_ASSERT_EQUAL(SQLITE_OK, sqlite3_open_v2(libraryPath, &plain, SQLITE_OPEN_READONLY, NULL));
+  int plainRows;
+  uint64_t expected = hashSongs(plain, plainRows);
+  sqlite3_close(plain);
+
+  sqlite3* db = openThroughVfs();
+  TEST_ASSERT_NOT_NULL(db);
+  sqlite3_exec(db, "PRAGMA cache_size = -64", NULL, NULL, NULL);
+
+  sdVfsResetStats();
+  int rows;
+  uint64_t hash = hashSongs(db, rows);
+  sqlite3_close(db);
+
+  const SdVfsStats& stats = sdVfsGetStats();
+  sdVfsPrintStats();
+
+  TEST_ASSERT_EQUAL(librarySongs, plainRows);
+  TEST_ASSERT_EQUAL(plainRows, rows);
+  TEST_ASSERT_TRUE(hash == expected);
+  TEST_ASSERT_GREATER_THAN(SD_VFS_CACHE_PAGES, stats.misses);
+  TEST_ASSERT_GREATER_THAN(0, stats.evictions);
+}
+
+// A query whose pages all fit is served from the cache the second time
+void test_repeat_query_hits_cache(void)
+{
+  sqlite3* db = openThroughVfs();
+  TEST_ASSERT_NOT_NULL(db);
+
+  const char* sql = "SELECT COUNT(*) FROM albums WHERE artist_id = 5";
+  TEST_ASSERT_EQUAL(SQLITE_OK, sqlite3_exec(db, sql, NULL, NULL, NULL));
+
+  sdVfsResetStats();
+  TEST_ASSERT_EQUAL(SQLITE_OK, sqlite3_exec(db, sql, NULL, NULL, NULL));
+  TEST_ASSERT_EQUAL(0, sdVfsGetStats().misses);
+
+  sqlite3_close(db);
+}
+
+// Read-only: no writes, no read-write opens, no journal or temp files
+void test_read_only(void)
+{
+  sqlite3* db = openThroughVfs();
+  TEST_ASSERT_NOT_NULL(db);
+  int rc = sqlite3_exec(db, "CREATE TABLE scratch (x)", NULL, NULL, NULL);
+  TEST_ASSERT_TRUE(rc == SQLITE_READONLY || rc == SQLITE_CANTOPEN);
+  sqlite3_close(db);
+
+  db = NULL;
+  rc = sqlite3_open_v2(libraryPath, &db, SQLITE_OPEN_READWRITE, SD_VFS_NAME);
+  TEST_ASSERT_EQUAL(SQLITE_CANTOPEN, rc);
+  sqlite3_close(db);
+
+  db = NULL;
+  rc = sqlite3_open_v2("/no/such/music.db", &db, SQLITE_OPEN_READONLY, SD_VFS_NAME);
+  TEST_ASSERT_EQUAL(SQLITE_CANTOPEN, rc);
+  sqlite3_close(db);
+}
+
+// A sort bigger than SQLite's cache spills to a temp file, which this VFS
+// can't open; with temp_store = MEMORY it completes in RAM
+void test_large_sort_needs_memory_temp_store(void)
+{
+  const char* sql = "SELECT title, display_name, path FROM songs ORDER BY duration, path";
+
+  sqlite3* db = openThroughVfs();
+  TEST_ASSERT_NOT_NULL(db);
+  sqlite3_exec(db, "PRAGMA cache_size = -64", NULL, NULL, NULL);
+  sqlite3_exec(db, "PRAGMA temp_store = FILE", NULL, NULL, NULL);
+
+  sqlite3_stmt* stmt;
+  TEST_ASSERT_EQUAL(SQLITE_OK, sqlite3_prepare_v2(db, sql, -1, &stmt, NULL));
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {}
+  sqlite3_finalize(stmt);
+  TEST_ASSERT_EQUAL(SQLITE_CANTOPEN, rc);
+
+  sqlite3_exec(db, "PRAGMA temp_store = MEMORY", NULL, NULL, NULL);
+  TEST_ASSERT_EQUAL(SQLITE_OK, sqlite3_prepare_v2(db, sql, -1, &stmt, NULL));
+  int rows = 0;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    rows++;
+  }
+  sqlite3_finalize(stmt);
+  sqlite3_close(db);
+
+  TEST_ASSERT_EQUAL(SQLITE_DONE, rc);
+  TEST_ASSERT_EQUAL(librarySongs, rows);
+}
+
+// ---------------------------------------------------------------------------
+// MusicDatabase over the VFS
+// ---------------------------------------------------------------------------
+
+void test_music_database_pages_from_sd(void)
+{
+  MusicDatabase db;
+  TEST_ASSERT_TRUE(db.openFromSd(libraryPath));
+  TEST_ASSERT_EQUAL(librarySongs, db.getSongCount());
+
+  StringArena strings;
+  strings.begin(64 * 1024);
+  std::vector<Artist> artistRows;
+  TEST_ASSERT_EQUAL(PAGE_SIZE, db.fetchArtists(PAGE_AT_OFFSET, NULL, 0, PAGE_SIZE, strings, artistRows));
+
+  // Keyset page after the first one continues the same order
+  std::vector<Artist> next;
+  db.fetchArtists(PAGE_AFTER, &artistRows.back(), 0, PAGE_SIZE, strings, next);
+  std::vector<Artist> byOffset;
+  db.fetchArtists(PAGE_AT_OFFSET, NULL, PAGE_SIZE, PAGE_SIZE, strings, byOffset);
+  TEST_ASSERT_EQUAL(byOffset.size(), next.size());
+  for (size_t i = 0; i < next.size(); i++) {
+    TEST_ASSERT_EQUAL(byOffset[i].id, next[i].id);
+  }
+
+  std::vector<Album> albumRows;
+  int albumCount = db.getAlbumCountByArtist(artistRows[0].id);
+  TEST_ASSERT_EQUAL(albumCount, db.fetchAlbums(artistRows[0].id, PAGE_AT_OFFSET, NULL, 0, 64, strings, albumRows));
+
+  std::vector<Song> songRows;
+  int songCount = db.getSongCountByAlbum(albumRows[0].id);
+  TEST_ASSERT_EQUAL(songCount, db.fetchSongs(albumRows[0].id, PAGE_AT_OFFSET, NULL, 0, 64, strings, songRows));
+  TEST_ASSERT_EQUAL(albumRows[0].id, songRows[0].albumId);
+
+  // Whole-library search ranks in a temp b-tree
+  std::vector<SearchResult> results;
+  TEST_ASSERT_GREATER_THAN(0, db.search("ka", SEARCH_MAX_RESULTS, strings, results));
+
+  SearchLocation where;
+  SearchResult last = results.back();
+  TEST_ASSERT_TRUE(db.locate(last, where));
+
+  std::vector<LetterJump> jumps;
+  TEST_ASSERT_GREATER_THAN(1, db.fetchArtistJumps(jumps));
+  TEST_ASSERT_EQUAL(0, jumps[0].row);
+
+  db.printQueryStats();
+  db.close();
+}
+
+static int countTerms(sqlite3* db, const char* where)
+{
+  std::string sql = std::string("SELECT COUNT(*) FROM search_terms WHERE ") + where;
+  sqlite3_stmt* stmt;
+  int count = -1;
+  if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, NULL) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+    count = sqlite3_column_int(stmt, 0);
+  }
+  sqlite3_finalize(stmt);
+  return count;
+}
+
+// Search range ends: bumped last byte, carry past 0xFF, open when none
+void test_search_prefix_upper_bound(void)
+{
+  char upper[8];
+  TEST_ASSERT_EQUAL(2, prefixUpperBound("ka", 2, upper));
+  TEST_ASSERT_EQUAL_STRING("kb", upper);
+  TEST_ASSERT_EQUAL(1, prefixUpperBound("\x7f", 1, upper));
+  TEST_ASSERT_EQUAL_STRING("\x80", upper);
+  TEST_ASSERT_EQUAL(1, prefixUpperBound("a\xff\xff", 3, upper));
+  TEST_ASSERT_EQUAL_STRING("b", upper);
+  TEST_ASSERT_EQUAL(0, prefixUpperBound("\xff\xff", 2, upper));
+  TEST_ASSERT_EQUAL(0, prefixUpperBound("", 0, upper));
+
+  // The open bound the search binds then keeps every term
+  sqlite3* db = openThroughVfs();
+  TEST_ASSERT_NOT_NULL(db);
+  int fromW = countTerms(db, "term >= 'w'");
+  TEST_ASSERT_GREATER_THAN(0, fromW);
+  TEST_ASSERT_EQUAL(fromW, countTerms(db, "term >= 'w' AND term < zeroblob(0)"));
+  sqlite3_close(db);
+
+  MusicDatabase music;
+  TEST_ASSERT_TRUE(music.openFromSd(libraryPath));
+  StringArena strings;
+  strings.begin(4096);
+  std::vector<SearchResult> results;
+  TEST_ASSERT_EQUAL(0, music.search("\xff", SEARCH_MAX_RESULTS, strings, results));
+  music.close();
+}
+
+// Same library through the PSRAM copy gives the same rows
+void test_memory_and_sd_agree(void)
+{
+  MusicDatabase paged;
+  MusicDatabase copied;
+  TEST_ASSERT_TRUE(paged.openFromSd(libraryPath));
+  TEST_ASSERT_TRUE(copied.openFromMemory(libraryPath));
+
+  StringArena strings;
+  strings.begin(256 * 1024);
+  int total = paged.getArtistCount();
+  TEST_ASSERT_EQUAL(copied.getArtistCount(), total);
+
+  for (int offset = 0; offset < total; offset += 97) {
+    std::vector<Artist> a;
+    std::vector<Artist> b;
+    paged.fetchArtists(PAGE_AT_OFFSET, NULL, offset, 8, strings, a);
+    copied.fetchArtists(PAGE_AT_OFFSET, NULL, offset, 8, strings, b);
+    TEST_ASSERT_EQUAL(b.size(), a.size());
+    for (size_t i = 0; i < a.size(); i++) {
+      TEST_ASSERT_EQUAL(b[i].id, a[i].id);
+      TEST_ASSERT_TRUE(a[i].name == b[i].name.str());
+    }
+    strings.reset();
+  }
+
+  paged.close();
+  copied.close();
+}
+
+int main(int argc, char** argv)
+{
+  snprintf(libraryPath, sizeof(libraryPath), "%s/sdvfs_music.db", P_tmpdir);
+  FixtureShape shape = { 300, 6, 12 };
+  librarySongs = writeFixtureLibrary(libraryPath, shape);
+  if (librarySongs <= 0) {
+    return 1;
+  }
+
+  UNITY_BEGIN();
+  RUN_TEST(test_reads_match_default_vfs);
+  RUN_TEST(test_repeat_query_hits_cache);
+  RUN_TEST(test_read_only);
+  RUN_TEST(test_large_sort_needs_memory_temp_store);
+  RUN_TEST(test_music_database_pages_from_sd);
+  RUN_TEST(test_memory_and_sd_agree);
+  RUN_TEST(test_search_prefix_upper_bound);
+  int failures = UNITY_END();
+
+  remove(libraryPath);
+  return failures;
+}